@@ -11,10 +11,54 @@
 #include <stdbool.h> // bool
 #include <stddef.h> // size_t
 #include <stdint.h> // uint8_t
-#include <string.h> // memcpy()
+#include <stdlib.h> // getenv()
+#include <string.h> // memcpy(), strcmp()
 #include "sha3.h" // sha3_*()
 #include "fips203ipd.h" // fips203ipd_*()
 
+// The AVX2 and AVX-512 kernels are compiled with function target
+// attributes and selected at runtime with `__builtin_cpu_supports()`,
+// so one binary runs on CPUs with and without them.  Define
+// FIPS203IPD_NO_AVX2 or FIPS203IPD_NO_AVX512 to leave out the
+// corresponding kernels.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(FIPS203IPD_NO_AVX2)
+#define FIPS203IPD_AVX2
+#endif /* __x86_64__ && __GNUC__ && !FIPS203IPD_NO_AVX2 */
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(FIPS203IPD_NO_AVX512)
+#define FIPS203IPD_AVX512
+#endif /* __x86_64__ && __GNUC__ && !FIPS203IPD_NO_AVX512 */
+
+// The AVX-512 VBMI kernels (Ice Lake and later) pack and unpack
+// compressed coefficients with byte permutes and bit-field extracts.
+// They need the AVX-512 kernels.  Define FIPS203IPD_NO_AVX512VBMI to
+// leave them out.
+#if defined(FIPS203IPD_AVX512) && !defined(FIPS203IPD_NO_AVX512VBMI)
+#define FIPS203IPD_AVX512VBMI
+#endif /* FIPS203IPD_AVX512 && !FIPS203IPD_NO_AVX512VBMI */
+
+// The AVX-512 VBMI2 kernel (Ice Lake and later) left-packs accepted
+// rejection sampling candidates with `vpcompressw` (and trims the last
+// ones with the BMI2 `pdep`).  It needs the AVX-512 VBMI kernels.
+// Define FIPS203IPD_NO_AVX512VBMI2 to leave it out.
+#if defined(FIPS203IPD_AVX512VBMI) && !defined(FIPS203IPD_NO_AVX512VBMI2)
+#define FIPS203IPD_AVX512VBMI2
+#endif /* FIPS203IPD_AVX512VBMI && !FIPS203IPD_NO_AVX512VBMI2 */
+
+// The portable vector kernels are written with GCC/Clang vector
+// extensions instead of intrinsics, so they need no function target
+// attributes or runtime check: the compiler lowers them to the baseline
+// SIMD instructions of the target (e.g., SSE2 on x86-64 and NEON on
+// AArch64).  They are used when neither AVX2 nor AVX-512 is available.
+// Define FIPS203IPD_NO_VEC to leave them out.
+#if defined(__GNUC__) && !defined(FIPS203IPD_NO_VEC)
+#define FIPS203IPD_VEC
+#endif /* __GNUC__ && !FIPS203IPD_NO_VEC */
+
+#if defined(FIPS203IPD_AVX2) || defined(FIPS203IPD_AVX512)
+#include <immintrin.h> // __m256i, __m512i, _mm256_*(), _mm512_*()
+#endif /* FIPS203IPD_AVX2 || FIPS203IPD_AVX512 */
+
 #define Q 3329 // modulus (13*2^8 + 1)
 
 // PKE512 parameters
@@ -48,274 +92,1228 @@
 #define PKE1024_CT_SIZE (32 * (PKE1024_DU * PKE1024_K + PKE1024_DV))
 
 // Returns true if `x` is between `lo` and `hi` (inclusive).
-// (used by poly_encode_*() and poly_decode_*() functions)
+// (used by poly_encode_1bit())
 #define IN_RANGE(x, lo, hi) ((x) >= (lo) && (x) <= (hi))
 
-// number-theoretic transform (NTT) lookup table
+// number-theoretic transform (NTT) lookup table, in Montgomery form
 // (used by poly_ntt() and poly_inv_ntt())
-static const uint16_t NTT_LUT[] = {
-  1, // n = 0, bitrev(0) = 0, (17**0)%3329 = 1
-  1729, // n = 1, bitrev(1) = 64, (17**64)%3329 = 1729
-  2580, // n = 2, bitrev(2) = 32, (17**32)%3329 = 2580
-  3289, // n = 3, bitrev(3) = 96, (17**96)%3329 = 3289
-  2642, // n = 4, bitrev(4) = 16, (17**16)%3329 = 2642
-  630, // n = 5, bitrev(5) = 80, (17**80)%3329 = 630
-  1897, // n = 6, bitrev(6) = 48, (17**48)%3329 = 1897
-  848, // n = 7, bitrev(7) = 112, (17**112)%3329 = 848
-  1062, // n = 8, bitrev(8) = 8, (17**8)%3329 = 1062
-  1919, // n = 9, bitrev(9) = 72, (17**72)%3329 = 1919
-  193, // n = 10, bitrev(10) = 40, (17**40)%3329 = 193
-  797, // n = 11, bitrev(11) = 104, (17**104)%3329 = 797
-  2786, // n = 12, bitrev(12) = 24, (17**24)%3329 = 2786
-  3260, // n = 13, bitrev(13) = 88, (17**88)%3329 = 3260
-  569, // n = 14, bitrev(14) = 56, (17**56)%3329 = 569
-  1746, // n = 15, bitrev(15) = 120, (17**120)%3329 = 1746
-  296, // n = 16, bitrev(16) = 4, (17**4)%3329 = 296
-  2447, // n = 17, bitrev(17) = 68, (17**68)%3329 = 2447
-  1339, // n = 18, bitrev(18) = 36, (17**36)%3329 = 1339
-  1476, // n = 19, bitrev(19) = 100, (17**100)%3329 = 1476
-  3046, // n = 20, bitrev(20) = 20, (17**20)%3329 = 3046
-  56, // n = 21, bitrev(21) = 84, (17**84)%3329 = 56
-  2240, // n = 22, bitrev(22) = 52, (17**52)%3329 = 2240
-  1333, // n = 23, bitrev(23) = 116, (17**116)%3329 = 1333
-  1426, // n = 24, bitrev(24) = 12, (17**12)%3329 = 1426
-  2094, // n = 25, bitrev(25) = 76, (17**76)%3329 = 2094
-  535, // n = 26, bitrev(26) = 44, (17**44)%3329 = 535
-  2882, // n = 27, bitrev(27) = 108, (17**108)%3329 = 2882
-  2393, // n = 28, bitrev(28) = 28, (17**28)%3329 = 2393
-  2879, // n = 29, bitrev(29) = 92, (17**92)%3329 = 2879
-  1974, // n = 30, bitrev(30) = 60, (17**60)%3329 = 1974
-  821, // n = 31, bitrev(31) = 124, (17**124)%3329 = 821
-  289, // n = 32, bitrev(32) = 2, (17**2)%3329 = 289
-  331, // n = 33, bitrev(33) = 66, (17**66)%3329 = 331
-  3253, // n = 34, bitrev(34) = 34, (17**34)%3329 = 3253
-  1756, // n = 35, bitrev(35) = 98, (17**98)%3329 = 1756
-  1197, // n = 36, bitrev(36) = 18, (17**18)%3329 = 1197
-  2304, // n = 37, bitrev(37) = 82, (17**82)%3329 = 2304
-  2277, // n = 38, bitrev(38) = 50, (17**50)%3329 = 2277
-  2055, // n = 39, bitrev(39) = 114, (17**114)%3329 = 2055
-  650, // n = 40, bitrev(40) = 10, (17**10)%3329 = 650
-  1977, // n = 41, bitrev(41) = 74, (17**74)%3329 = 1977
-  2513, // n = 42, bitrev(42) = 42, (17**42)%3329 = 2513
-  632, // n = 43, bitrev(43) = 106, (17**106)%3329 = 632
-  2865, // n = 44, bitrev(44) = 26, (17**26)%3329 = 2865
-  33, // n = 45, bitrev(45) = 90, (17**90)%3329 = 33
-  1320, // n = 46, bitrev(46) = 58, (17**58)%3329 = 1320
-  1915, // n = 47, bitrev(47) = 122, (17**122)%3329 = 1915
-  2319, // n = 48, bitrev(48) = 6, (17**6)%3329 = 2319
-  1435, // n = 49, bitrev(49) = 70, (17**70)%3329 = 1435
-  807, // n = 50, bitrev(50) = 38, (17**38)%3329 = 807
-  452, // n = 51, bitrev(51) = 102, (17**102)%3329 = 452
-  1438, // n = 52, bitrev(52) = 22, (17**22)%3329 = 1438
-  2868, // n = 53, bitrev(53) = 86, (17**86)%3329 = 2868
-  1534, // n = 54, bitrev(54) = 54, (17**54)%3329 = 1534
-  2402, // n = 55, bitrev(55) = 118, (17**118)%3329 = 2402
-  2647, // n = 56, bitrev(56) = 14, (17**14)%3329 = 2647
-  2617, // n = 57, bitrev(57) = 78, (17**78)%3329 = 2617
-  1481, // n = 58, bitrev(58) = 46, (17**46)%3329 = 1481
-  648, // n = 59, bitrev(59) = 110, (17**110)%3329 = 648
-  2474, // n = 60, bitrev(60) = 30, (17**30)%3329 = 2474
-  3110, // n = 61, bitrev(61) = 94, (17**94)%3329 = 3110
-  1227, // n = 62, bitrev(62) = 62, (17**62)%3329 = 1227
-  910, // n = 63, bitrev(63) = 126, (17**126)%3329 = 910
-  17, // n = 64, bitrev(64) = 1, (17**1)%3329 = 17
-  2761, // n = 65, bitrev(65) = 65, (17**65)%3329 = 2761
-  583, // n = 66, bitrev(66) = 33, (17**33)%3329 = 583
-  2649, // n = 67, bitrev(67) = 97, (17**97)%3329 = 2649
-  1637, // n = 68, bitrev(68) = 17, (17**17)%3329 = 1637
-  723, // n = 69, bitrev(69) = 81, (17**81)%3329 = 723
-  2288, // n = 70, bitrev(70) = 49, (17**49)%3329 = 2288
-  1100, // n = 71, bitrev(71) = 113, (17**113)%3329 = 1100
-  1409, // n = 72, bitrev(72) = 9, (17**9)%3329 = 1409
-  2662, // n = 73, bitrev(73) = 73, (17**73)%3329 = 2662
-  3281, // n = 74, bitrev(74) = 41, (17**41)%3329 = 3281
-  233, // n = 75, bitrev(75) = 105, (17**105)%3329 = 233
-  756, // n = 76, bitrev(76) = 25, (17**25)%3329 = 756
-  2156, // n = 77, bitrev(77) = 89, (17**89)%3329 = 2156
-  3015, // n = 78, bitrev(78) = 57, (17**57)%3329 = 3015
-  3050, // n = 79, bitrev(79) = 121, (17**121)%3329 = 3050
-  1703, // n = 80, bitrev(80) = 5, (17**5)%3329 = 1703
-  1651, // n = 81, bitrev(81) = 69, (17**69)%3329 = 1651
-  2789, // n = 82, bitrev(82) = 37, (17**37)%3329 = 2789
-  1789, // n = 83, bitrev(83) = 101, (17**101)%3329 = 1789
-  1847, // n = 84, bitrev(84) = 21, (17**21)%3329 = 1847
-  952, // n = 85, bitrev(85) = 85, (17**85)%3329 = 952
-  1461, // n = 86, bitrev(86) = 53, (17**53)%3329 = 1461
-  2687, // n = 87, bitrev(87) = 117, (17**117)%3329 = 2687
-  939, // n = 88, bitrev(88) = 13, (17**13)%3329 = 939
-  2308, // n = 89, bitrev(89) = 77, (17**77)%3329 = 2308
-  2437, // n = 90, bitrev(90) = 45, (17**45)%3329 = 2437
-  2388, // n = 91, bitrev(91) = 109, (17**109)%3329 = 2388
-  733, // n = 92, bitrev(92) = 29, (17**29)%3329 = 733
-  2337, // n = 93, bitrev(93) = 93, (17**93)%3329 = 2337
-  268, // n = 94, bitrev(94) = 61, (17**61)%3329 = 268
-  641, // n = 95, bitrev(95) = 125, (17**125)%3329 = 641
-  1584, // n = 96, bitrev(96) = 3, (17**3)%3329 = 1584
-  2298, // n = 97, bitrev(97) = 67, (17**67)%3329 = 2298
-  2037, // n = 98, bitrev(98) = 35, (17**35)%3329 = 2037
-  3220, // n = 99, bitrev(99) = 99, (17**99)%3329 = 3220
-  375, // n = 100, bitrev(100) = 19, (17**19)%3329 = 375
-  2549, // n = 101, bitrev(101) = 83, (17**83)%3329 = 2549
-  2090, // n = 102, bitrev(102) = 51, (17**51)%3329 = 2090
-  1645, // n = 103, bitrev(103) = 115, (17**115)%3329 = 1645
-  1063, // n = 104, bitrev(104) = 11, (17**11)%3329 = 1063
-  319, // n = 105, bitrev(105) = 75, (17**75)%3329 = 319
-  2773, // n = 106, bitrev(106) = 43, (17**43)%3329 = 2773
-  757, // n = 107, bitrev(107) = 107, (17**107)%3329 = 757
-  2099, // n = 108, bitrev(108) = 27, (17**27)%3329 = 2099
-  561, // n = 109, bitrev(109) = 91, (17**91)%3329 = 561
-  2466, // n = 110, bitrev(110) = 59, (17**59)%3329 = 2466
-  2594, // n = 111, bitrev(111) = 123, (17**123)%3329 = 2594
-  2804, // n = 112, bitrev(112) = 7, (17**7)%3329 = 2804
-  1092, // n = 113, bitrev(113) = 71, (17**71)%3329 = 1092
-  403, // n = 114, bitrev(114) = 39, (17**39)%3329 = 403
-  1026, // n = 115, bitrev(115) = 103, (17**103)%3329 = 1026
-  1143, // n = 116, bitrev(116) = 23, (17**23)%3329 = 1143
-  2150, // n = 117, bitrev(117) = 87, (17**87)%3329 = 2150
-  2775, // n = 118, bitrev(118) = 55, (17**55)%3329 = 2775
-  886, // n = 119, bitrev(119) = 119, (17**119)%3329 = 886
-  1722, // n = 120, bitrev(120) = 15, (17**15)%3329 = 1722
-  1212, // n = 121, bitrev(121) = 79, (17**79)%3329 = 1212
-  1874, // n = 122, bitrev(122) = 47, (17**47)%3329 = 1874
-  1029, // n = 123, bitrev(123) = 111, (17**111)%3329 = 1029
-  2110, // n = 124, bitrev(124) = 31, (17**31)%3329 = 2110
-  2935, // n = 125, bitrev(125) = 95, (17**95)%3329 = 2935
-  885, // n = 126, bitrev(126) = 63, (17**63)%3329 = 885
-  2154, // n = 127, bitrev(127) = 127, (17**127)%3329 = 2154
+static const int16_t NTT_LUT[] = {
+  -1044, // n = 0, bitrev(0) = 0, (17**0)%3329 = 1
+  -758, // n = 1, bitrev(1) = 64, (17**64)%3329 = 1729
+  -359, // n = 2, bitrev(2) = 32, (17**32)%3329 = 2580
+  -1517, // n = 3, bitrev(3) = 96, (17**96)%3329 = 3289
+  1493, // n = 4, bitrev(4) = 16, (17**16)%3329 = 2642
+  1422, // n = 5, bitrev(5) = 80, (17**80)%3329 = 630
+  287, // n = 6, bitrev(6) = 48, (17**48)%3329 = 1897
+  202, // n = 7, bitrev(7) = 112, (17**112)%3329 = 848
+  -171, // n = 8, bitrev(8) = 8, (17**8)%3329 = 1062
+  622, // n = 9, bitrev(9) = 72, (17**72)%3329 = 1919
+  1577, // n = 10, bitrev(10) = 40, (17**40)%3329 = 193
+  182, // n = 11, bitrev(11) = 104, (17**104)%3329 = 797
+  962, // n = 12, bitrev(12) = 24, (17**24)%3329 = 2786
+  -1202, // n = 13, bitrev(13) = 88, (17**88)%3329 = 3260
+  -1474, // n = 14, bitrev(14) = 56, (17**56)%3329 = 569
+  1468, // n = 15, bitrev(15) = 120, (17**120)%3329 = 1746
+  573, // n = 16, bitrev(16) = 4, (17**4)%3329 = 296
+  -1325, // n = 17, bitrev(17) = 68, (17**68)%3329 = 2447
+  264, // n = 18, bitrev(18) = 36, (17**36)%3329 = 1339
+  383, // n = 19, bitrev(19) = 100, (17**100)%3329 = 1476
+  -829, // n = 20, bitrev(20) = 20, (17**20)%3329 = 3046
+  1458, // n = 21, bitrev(21) = 84, (17**84)%3329 = 56
+  -1602, // n = 22, bitrev(22) = 52, (17**52)%3329 = 2240
+  -130, // n = 23, bitrev(23) = 116, (17**116)%3329 = 1333
+  -681, // n = 24, bitrev(24) = 12, (17**12)%3329 = 1426
+  1017, // n = 25, bitrev(25) = 76, (17**76)%3329 = 2094
+  732, // n = 26, bitrev(26) = 44, (17**44)%3329 = 535
+  608, // n = 27, bitrev(27) = 108, (17**108)%3329 = 2882
+  -1542, // n = 28, bitrev(28) = 28, (17**28)%3329 = 2393
+  411, // n = 29, bitrev(29) = 92, (17**92)%3329 = 2879
+  -205, // n = 30, bitrev(30) = 60, (17**60)%3329 = 1974
+  -1571, // n = 31, bitrev(31) = 124, (17**124)%3329 = 821
+  1223, // n = 32, bitrev(32) = 2, (17**2)%3329 = 289
+  652, // n = 33, bitrev(33) = 66, (17**66)%3329 = 331
+  -552, // n = 34, bitrev(34) = 34, (17**34)%3329 = 3253
+  1015, // n = 35, bitrev(35) = 98, (17**98)%3329 = 1756
+  -1293, // n = 36, bitrev(36) = 18, (17**18)%3329 = 1197
+  1491, // n = 37, bitrev(37) = 82, (17**82)%3329 = 2304
+  -282, // n = 38, bitrev(38) = 50, (17**50)%3329 = 2277
+  -1544, // n = 39, bitrev(39) = 114, (17**114)%3329 = 2055
+  516, // n = 40, bitrev(40) = 10, (17**10)%3329 = 650
+  -8, // n = 41, bitrev(41) = 74, (17**74)%3329 = 1977
+  -320, // n = 42, bitrev(42) = 42, (17**42)%3329 = 2513
+  -666, // n = 43, bitrev(43) = 106, (17**106)%3329 = 632
+  -1618, // n = 44, bitrev(44) = 26, (17**26)%3329 = 2865
+  -1162, // n = 45, bitrev(45) = 90, (17**90)%3329 = 33
+  126, // n = 46, bitrev(46) = 58, (17**58)%3329 = 1320
+  1469, // n = 47, bitrev(47) = 122, (17**122)%3329 = 1915
+  -853, // n = 48, bitrev(48) = 6, (17**6)%3329 = 2319
+  -90, // n = 49, bitrev(49) = 70, (17**70)%3329 = 1435
+  -271, // n = 50, bitrev(50) = 38, (17**38)%3329 = 807
+  830, // n = 51, bitrev(51) = 102, (17**102)%3329 = 452
+  107, // n = 52, bitrev(52) = 22, (17**22)%3329 = 1438
+  -1421, // n = 53, bitrev(53) = 86, (17**86)%3329 = 2868
+  -247, // n = 54, bitrev(54) = 54, (17**54)%3329 = 1534
+  -951, // n = 55, bitrev(55) = 118, (17**118)%3329 = 2402
+  -398, // n = 56, bitrev(56) = 14, (17**14)%3329 = 2647
+  961, // n = 57, bitrev(57) = 78, (17**78)%3329 = 2617
+  -1508, // n = 58, bitrev(58) = 46, (17**46)%3329 = 1481
+  -725, // n = 59, bitrev(59) = 110, (17**110)%3329 = 648
+  448, // n = 60, bitrev(60) = 30, (17**30)%3329 = 2474
+  -1065, // n = 61, bitrev(61) = 94, (17**94)%3329 = 3110
+  677, // n = 62, bitrev(62) = 62, (17**62)%3329 = 1227
+  -1275, // n = 63, bitrev(63) = 126, (17**126)%3329 = 910
+  -1103, // n = 64, bitrev(64) = 1, (17**1)%3329 = 17
+  430, // n = 65, bitrev(65) = 65, (17**65)%3329 = 2761
+  555, // n = 66, bitrev(66) = 33, (17**33)%3329 = 583
+  843, // n = 67, bitrev(67) = 97, (17**97)%3329 = 2649
+  -1251, // n = 68, bitrev(68) = 17, (17**17)%3329 = 1637
+  871, // n = 69, bitrev(69) = 81, (17**81)%3329 = 723
+  1550, // n = 70, bitrev(70) = 49, (17**49)%3329 = 2288
+  105, // n = 71, bitrev(71) = 113, (17**113)%3329 = 1100
+  422, // n = 72, bitrev(72) = 9, (17**9)%3329 = 1409
+  587, // n = 73, bitrev(73) = 73, (17**73)%3329 = 2662
+  177, // n = 74, bitrev(74) = 41, (17**41)%3329 = 3281
+  -235, // n = 75, bitrev(75) = 105, (17**105)%3329 = 233
+  -291, // n = 76, bitrev(76) = 25, (17**25)%3329 = 756
+  -460, // n = 77, bitrev(77) = 89, (17**89)%3329 = 2156
+  1574, // n = 78, bitrev(78) = 57, (17**57)%3329 = 3015
+  1653, // n = 79, bitrev(79) = 121, (17**121)%3329 = 3050
+  -246, // n = 80, bitrev(80) = 5, (17**5)%3329 = 1703
+  778, // n = 81, bitrev(81) = 69, (17**69)%3329 = 1651
+  1159, // n = 82, bitrev(82) = 37, (17**37)%3329 = 2789
+  -147, // n = 83, bitrev(83) = 101, (17**101)%3329 = 1789
+  -777, // n = 84, bitrev(84) = 21, (17**21)%3329 = 1847
+  1483, // n = 85, bitrev(85) = 85, (17**85)%3329 = 952
+  -602, // n = 86, bitrev(86) = 53, (17**53)%3329 = 1461
+  1119, // n = 87, bitrev(87) = 117, (17**117)%3329 = 2687
+  -1590, // n = 88, bitrev(88) = 13, (17**13)%3329 = 939
+  644, // n = 89, bitrev(89) = 77, (17**77)%3329 = 2308
+  -872, // n = 90, bitrev(90) = 45, (17**45)%3329 = 2437
+  349, // n = 91, bitrev(91) = 109, (17**109)%3329 = 2388
+  418, // n = 92, bitrev(92) = 29, (17**29)%3329 = 733
+  329, // n = 93, bitrev(93) = 93, (17**93)%3329 = 2337
+  -156, // n = 94, bitrev(94) = 61, (17**61)%3329 = 268
+  -75, // n = 95, bitrev(95) = 125, (17**125)%3329 = 641
+  817, // n = 96, bitrev(96) = 3, (17**3)%3329 = 1584
+  1097, // n = 97, bitrev(97) = 67, (17**67)%3329 = 2298
+  603, // n = 98, bitrev(98) = 35, (17**35)%3329 = 2037
+  610, // n = 99, bitrev(99) = 99, (17**99)%3329 = 3220
+  1322, // n = 100, bitrev(100) = 19, (17**19)%3329 = 375
+  -1285, // n = 101, bitrev(101) = 83, (17**83)%3329 = 2549
+  -1465, // n = 102, bitrev(102) = 51, (17**51)%3329 = 2090
+  384, // n = 103, bitrev(103) = 115, (17**115)%3329 = 1645
+  -1215, // n = 104, bitrev(104) = 11, (17**11)%3329 = 1063
+  -136, // n = 105, bitrev(105) = 75, (17**75)%3329 = 319
+  1218, // n = 106, bitrev(106) = 43, (17**43)%3329 = 2773
+  -1335, // n = 107, bitrev(107) = 107, (17**107)%3329 = 757
+  -874, // n = 108, bitrev(108) = 27, (17**27)%3329 = 2099
+  220, // n = 109, bitrev(109) = 91, (17**91)%3329 = 561
+  -1187, // n = 110, bitrev(110) = 59, (17**59)%3329 = 2466
+  -1659, // n = 111, bitrev(111) = 123, (17**123)%3329 = 2594
+  -1185, // n = 112, bitrev(112) = 7, (17**7)%3329 = 2804
+  -1530, // n = 113, bitrev(113) = 71, (17**71)%3329 = 1092
+  -1278, // n = 114, bitrev(114) = 39, (17**39)%3329 = 403
+  794, // n = 115, bitrev(115) = 103, (17**103)%3329 = 1026
+  -1510, // n = 116, bitrev(116) = 23, (17**23)%3329 = 1143
+  -854, // n = 117, bitrev(117) = 87, (17**87)%3329 = 2150
+  -870, // n = 118, bitrev(118) = 55, (17**55)%3329 = 2775
+  478, // n = 119, bitrev(119) = 119, (17**119)%3329 = 886
+  -108, // n = 120, bitrev(120) = 15, (17**15)%3329 = 1722
+  -308, // n = 121, bitrev(121) = 79, (17**79)%3329 = 1212
+  996, // n = 122, bitrev(122) = 47, (17**47)%3329 = 1874
+  991, // n = 123, bitrev(123) = 111, (17**111)%3329 = 1029
+  958, // n = 124, bitrev(124) = 31, (17**31)%3329 = 2110
+  -1460, // n = 125, bitrev(125) = 95, (17**95)%3329 = 2935
+  1522, // n = 126, bitrev(126) = 63, (17**63)%3329 = 885
+  1628, // n = 127, bitrev(127) = 127, (17**127)%3329 = 2154
 };
 
-// polynomial base case multiply lookup table
+// polynomial base case multiply lookup table, in Montgomery form
 // (used by poly_mul())
-static const uint16_t MUL_LUT[] = {
-  17, // n = 0, 2*bitrev(0)+1 = 1, (17**1)%3329) = 17
-  3312, // n = 1, 2*bitrev(1)+1 = 129, (17**129)%3329) = 3312
-  2761, // n = 2, 2*bitrev(2)+1 = 65, (17**65)%3329) = 2761
-  568, // n = 3, 2*bitrev(3)+1 = 193, (17**193)%3329) = 568
-  583, // n = 4, 2*bitrev(4)+1 = 33, (17**33)%3329) = 583
-  2746, // n = 5, 2*bitrev(5)+1 = 161, (17**161)%3329) = 2746
-  2649, // n = 6, 2*bitrev(6)+1 = 97, (17**97)%3329) = 2649
-  680, // n = 7, 2*bitrev(7)+1 = 225, (17**225)%3329) = 680
-  1637, // n = 8, 2*bitrev(8)+1 = 17, (17**17)%3329) = 1637
-  1692, // n = 9, 2*bitrev(9)+1 = 145, (17**145)%3329) = 1692
-  723, // n = 10, 2*bitrev(10)+1 = 81, (17**81)%3329) = 723
-  2606, // n = 11, 2*bitrev(11)+1 = 209, (17**209)%3329) = 2606
-  2288, // n = 12, 2*bitrev(12)+1 = 49, (17**49)%3329) = 2288
-  1041, // n = 13, 2*bitrev(13)+1 = 177, (17**177)%3329) = 1041
-  1100, // n = 14, 2*bitrev(14)+1 = 113, (17**113)%3329) = 1100
-  2229, // n = 15, 2*bitrev(15)+1 = 241, (17**241)%3329) = 2229
-  1409, // n = 16, 2*bitrev(16)+1 = 9, (17**9)%3329) = 1409
-  1920, // n = 17, 2*bitrev(17)+1 = 137, (17**137)%3329) = 1920
-  2662, // n = 18, 2*bitrev(18)+1 = 73, (17**73)%3329) = 2662
-  667, // n = 19, 2*bitrev(19)+1 = 201, (17**201)%3329) = 667
-  3281, // n = 20, 2*bitrev(20)+1 = 41, (17**41)%3329) = 3281
-  48, // n = 21, 2*bitrev(21)+1 = 169, (17**169)%3329) = 48
-  233, // n = 22, 2*bitrev(22)+1 = 105, (17**105)%3329) = 233
-  3096, // n = 23, 2*bitrev(23)+1 = 233, (17**233)%3329) = 3096
-  756, // n = 24, 2*bitrev(24)+1 = 25, (17**25)%3329) = 756
-  2573, // n = 25, 2*bitrev(25)+1 = 153, (17**153)%3329) = 2573
-  2156, // n = 26, 2*bitrev(26)+1 = 89, (17**89)%3329) = 2156
-  1173, // n = 27, 2*bitrev(27)+1 = 217, (17**217)%3329) = 1173
-  3015, // n = 28, 2*bitrev(28)+1 = 57, (17**57)%3329) = 3015
-  314, // n = 29, 2*bitrev(29)+1 = 185, (17**185)%3329) = 314
-  3050, // n = 30, 2*bitrev(30)+1 = 121, (17**121)%3329) = 3050
-  279, // n = 31, 2*bitrev(31)+1 = 249, (17**249)%3329) = 279
-  1703, // n = 32, 2*bitrev(32)+1 = 5, (17**5)%3329) = 1703
-  1626, // n = 33, 2*bitrev(33)+1 = 133, (17**133)%3329) = 1626
-  1651, // n = 34, 2*bitrev(34)+1 = 69, (17**69)%3329) = 1651
-  1678, // n = 35, 2*bitrev(35)+1 = 197, (17**197)%3329) = 1678
-  2789, // n = 36, 2*bitrev(36)+1 = 37, (17**37)%3329) = 2789
-  540, // n = 37, 2*bitrev(37)+1 = 165, (17**165)%3329) = 540
-  1789, // n = 38, 2*bitrev(38)+1 = 101, (17**101)%3329) = 1789
-  1540, // n = 39, 2*bitrev(39)+1 = 229, (17**229)%3329) = 1540
-  1847, // n = 40, 2*bitrev(40)+1 = 21, (17**21)%3329) = 1847
-  1482, // n = 41, 2*bitrev(41)+1 = 149, (17**149)%3329) = 1482
-  952, // n = 42, 2*bitrev(42)+1 = 85, (17**85)%3329) = 952
-  2377, // n = 43, 2*bitrev(43)+1 = 213, (17**213)%3329) = 2377
-  1461, // n = 44, 2*bitrev(44)+1 = 53, (17**53)%3329) = 1461
-  1868, // n = 45, 2*bitrev(45)+1 = 181, (17**181)%3329) = 1868
-  2687, // n = 46, 2*bitrev(46)+1 = 117, (17**117)%3329) = 2687
-  642, // n = 47, 2*bitrev(47)+1 = 245, (17**245)%3329) = 642
-  939, // n = 48, 2*bitrev(48)+1 = 13, (17**13)%3329) = 939
-  2390, // n = 49, 2*bitrev(49)+1 = 141, (17**141)%3329) = 2390
-  2308, // n = 50, 2*bitrev(50)+1 = 77, (17**77)%3329) = 2308
-  1021, // n = 51, 2*bitrev(51)+1 = 205, (17**205)%3329) = 1021
-  2437, // n = 52, 2*bitrev(52)+1 = 45, (17**45)%3329) = 2437
-  892, // n = 53, 2*bitrev(53)+1 = 173, (17**173)%3329) = 892
-  2388, // n = 54, 2*bitrev(54)+1 = 109, (17**109)%3329) = 2388
-  941, // n = 55, 2*bitrev(55)+1 = 237, (17**237)%3329) = 941
-  733, // n = 56, 2*bitrev(56)+1 = 29, (17**29)%3329) = 733
-  2596, // n = 57, 2*bitrev(57)+1 = 157, (17**157)%3329) = 2596
-  2337, // n = 58, 2*bitrev(58)+1 = 93, (17**93)%3329) = 2337
-  992, // n = 59, 2*bitrev(59)+1 = 221, (17**221)%3329) = 992
-  268, // n = 60, 2*bitrev(60)+1 = 61, (17**61)%3329) = 268
-  3061, // n = 61, 2*bitrev(61)+1 = 189, (17**189)%3329) = 3061
-  641, // n = 62, 2*bitrev(62)+1 = 125, (17**125)%3329) = 641
-  2688, // n = 63, 2*bitrev(63)+1 = 253, (17**253)%3329) = 2688
-  1584, // n = 64, 2*bitrev(64)+1 = 3, (17**3)%3329) = 1584
-  1745, // n = 65, 2*bitrev(65)+1 = 131, (17**131)%3329) = 1745
-  2298, // n = 66, 2*bitrev(66)+1 = 67, (17**67)%3329) = 2298
-  1031, // n = 67, 2*bitrev(67)+1 = 195, (17**195)%3329) = 1031
-  2037, // n = 68, 2*bitrev(68)+1 = 35, (17**35)%3329) = 2037
-  1292, // n = 69, 2*bitrev(69)+1 = 163, (17**163)%3329) = 1292
-  3220, // n = 70, 2*bitrev(70)+1 = 99, (17**99)%3329) = 3220
-  109, // n = 71, 2*bitrev(71)+1 = 227, (17**227)%3329) = 109
-  375, // n = 72, 2*bitrev(72)+1 = 19, (17**19)%3329) = 375
-  2954, // n = 73, 2*bitrev(73)+1 = 147, (17**147)%3329) = 2954
-  2549, // n = 74, 2*bitrev(74)+1 = 83, (17**83)%3329) = 2549
-  780, // n = 75, 2*bitrev(75)+1 = 211, (17**211)%3329) = 780
-  2090, // n = 76, 2*bitrev(76)+1 = 51, (17**51)%3329) = 2090
-  1239, // n = 77, 2*bitrev(77)+1 = 179, (17**179)%3329) = 1239
-  1645, // n = 78, 2*bitrev(78)+1 = 115, (17**115)%3329) = 1645
-  1684, // n = 79, 2*bitrev(79)+1 = 243, (17**243)%3329) = 1684
-  1063, // n = 80, 2*bitrev(80)+1 = 11, (17**11)%3329) = 1063
-  2266, // n = 81, 2*bitrev(81)+1 = 139, (17**139)%3329) = 2266
-  319, // n = 82, 2*bitrev(82)+1 = 75, (17**75)%3329) = 319
-  3010, // n = 83, 2*bitrev(83)+1 = 203, (17**203)%3329) = 3010
-  2773, // n = 84, 2*bitrev(84)+1 = 43, (17**43)%3329) = 2773
-  556, // n = 85, 2*bitrev(85)+1 = 171, (17**171)%3329) = 556
-  757, // n = 86, 2*bitrev(86)+1 = 107, (17**107)%3329) = 757
-  2572, // n = 87, 2*bitrev(87)+1 = 235, (17**235)%3329) = 2572
-  2099, // n = 88, 2*bitrev(88)+1 = 27, (17**27)%3329) = 2099
-  1230, // n = 89, 2*bitrev(89)+1 = 155, (17**155)%3329) = 1230
-  561, // n = 90, 2*bitrev(90)+1 = 91, (17**91)%3329) = 561
-  2768, // n = 91, 2*bitrev(91)+1 = 219, (17**219)%3329) = 2768
-  2466, // n = 92, 2*bitrev(92)+1 = 59, (17**59)%3329) = 2466
-  863, // n = 93, 2*bitrev(93)+1 = 187, (17**187)%3329) = 863
-  2594, // n = 94, 2*bitrev(94)+1 = 123, (17**123)%3329) = 2594
-  735, // n = 95, 2*bitrev(95)+1 = 251, (17**251)%3329) = 735
-  2804, // n = 96, 2*bitrev(96)+1 = 7, (17**7)%3329) = 2804
-  525, // n = 97, 2*bitrev(97)+1 = 135, (17**135)%3329) = 525
-  1092, // n = 98, 2*bitrev(98)+1 = 71, (17**71)%3329) = 1092
-  2237, // n = 99, 2*bitrev(99)+1 = 199, (17**199)%3329) = 2237
-  403, // n = 100, 2*bitrev(100)+1 = 39, (17**39)%3329) = 403
-  2926, // n = 101, 2*bitrev(101)+1 = 167, (17**167)%3329) = 2926
-  1026, // n = 102, 2*bitrev(102)+1 = 103, (17**103)%3329) = 1026
-  2303, // n = 103, 2*bitrev(103)+1 = 231, (17**231)%3329) = 2303
-  1143, // n = 104, 2*bitrev(104)+1 = 23, (17**23)%3329) = 1143
-  2186, // n = 105, 2*bitrev(105)+1 = 151, (17**151)%3329) = 2186
-  2150, // n = 106, 2*bitrev(106)+1 = 87, (17**87)%3329) = 2150
-  1179, // n = 107, 2*bitrev(107)+1 = 215, (17**215)%3329) = 1179
-  2775, // n = 108, 2*bitrev(108)+1 = 55, (17**55)%3329) = 2775
-  554, // n = 109, 2*bitrev(109)+1 = 183, (17**183)%3329) = 554
-  886, // n = 110, 2*bitrev(110)+1 = 119, (17**119)%3329) = 886
-  2443, // n = 111, 2*bitrev(111)+1 = 247, (17**247)%3329) = 2443
-  1722, // n = 112, 2*bitrev(112)+1 = 15, (17**15)%3329) = 1722
-  1607, // n = 113, 2*bitrev(113)+1 = 143, (17**143)%3329) = 1607
-  1212, // n = 114, 2*bitrev(114)+1 = 79, (17**79)%3329) = 1212
-  2117, // n = 115, 2*bitrev(115)+1 = 207, (17**207)%3329) = 2117
-  1874, // n = 116, 2*bitrev(116)+1 = 47, (17**47)%3329) = 1874
-  1455, // n = 117, 2*bitrev(117)+1 = 175, (17**175)%3329) = 1455
-  1029, // n = 118, 2*bitrev(118)+1 = 111, (17**111)%3329) = 1029
-  2300, // n = 119, 2*bitrev(119)+1 = 239, (17**239)%3329) = 2300
-  2110, // n = 120, 2*bitrev(120)+1 = 31, (17**31)%3329) = 2110
-  1219, // n = 121, 2*bitrev(121)+1 = 159, (17**159)%3329) = 1219
-  2935, // n = 122, 2*bitrev(122)+1 = 95, (17**95)%3329) = 2935
-  394, // n = 123, 2*bitrev(123)+1 = 223, (17**223)%3329) = 394
-  885, // n = 124, 2*bitrev(124)+1 = 63, (17**63)%3329) = 885
-  2444, // n = 125, 2*bitrev(125)+1 = 191, (17**191)%3329) = 2444
-  2154, // n = 126, 2*bitrev(126)+1 = 127, (17**127)%3329) = 2154
-  1175, // n = 127, 2*bitrev(127)+1 = 255, (17**255)%3329) = 1175
+static const int16_t MUL_LUT[] = {
+  -1103, // n = 0, 2*bitrev(0)+1 = 1, (17**1)%3329 = 17
+  1103, // n = 1, 2*bitrev(1)+1 = 129, (17**129)%3329 = 3312
+  430, // n = 2, 2*bitrev(2)+1 = 65, (17**65)%3329 = 2761
+  -430, // n = 3, 2*bitrev(3)+1 = 193, (17**193)%3329 = 568
+  555, // n = 4, 2*bitrev(4)+1 = 33, (17**33)%3329 = 583
+  -555, // n = 5, 2*bitrev(5)+1 = 161, (17**161)%3329 = 2746
+  843, // n = 6, 2*bitrev(6)+1 = 97, (17**97)%3329 = 2649
+  -843, // n = 7, 2*bitrev(7)+1 = 225, (17**225)%3329 = 680
+  -1251, // n = 8, 2*bitrev(8)+1 = 17, (17**17)%3329 = 1637
+  1251, // n = 9, 2*bitrev(9)+1 = 145, (17**145)%3329 = 1692
+  871, // n = 10, 2*bitrev(10)+1 = 81, (17**81)%3329 = 723
+  -871, // n = 11, 2*bitrev(11)+1 = 209, (17**209)%3329 = 2606
+  1550, // n = 12, 2*bitrev(12)+1 = 49, (17**49)%3329 = 2288
+  -1550, // n = 13, 2*bitrev(13)+1 = 177, (17**177)%3329 = 1041
+  105, // n = 14, 2*bitrev(14)+1 = 113, (17**113)%3329 = 1100
+  -105, // n = 15, 2*bitrev(15)+1 = 241, (17**241)%3329 = 2229
+  422, // n = 16, 2*bitrev(16)+1 = 9, (17**9)%3329 = 1409
+  -422, // n = 17, 2*bitrev(17)+1 = 137, (17**137)%3329 = 1920
+  587, // n = 18, 2*bitrev(18)+1 = 73, (17**73)%3329 = 2662
+  -587, // n = 19, 2*bitrev(19)+1 = 201, (17**201)%3329 = 667
+  177, // n = 20, 2*bitrev(20)+1 = 41, (17**41)%3329 = 3281
+  -177, // n = 21, 2*bitrev(21)+1 = 169, (17**169)%3329 = 48
+  -235, // n = 22, 2*bitrev(22)+1 = 105, (17**105)%3329 = 233
+  235, // n = 23, 2*bitrev(23)+1 = 233, (17**233)%3329 = 3096
+  -291, // n = 24, 2*bitrev(24)+1 = 25, (17**25)%3329 = 756
+  291, // n = 25, 2*bitrev(25)+1 = 153, (17**153)%3329 = 2573
+  -460, // n = 26, 2*bitrev(26)+1 = 89, (17**89)%3329 = 2156
+  460, // n = 27, 2*bitrev(27)+1 = 217, (17**217)%3329 = 1173
+  1574, // n = 28, 2*bitrev(28)+1 = 57, (17**57)%3329 = 3015
+  -1574, // n = 29, 2*bitrev(29)+1 = 185, (17**185)%3329 = 314
+  1653, // n = 30, 2*bitrev(30)+1 = 121, (17**121)%3329 = 3050
+  -1653, // n = 31, 2*bitrev(31)+1 = 249, (17**249)%3329 = 279
+  -246, // n = 32, 2*bitrev(32)+1 = 5, (17**5)%3329 = 1703
+  246, // n = 33, 2*bitrev(33)+1 = 133, (17**133)%3329 = 1626
+  778, // n = 34, 2*bitrev(34)+1 = 69, (17**69)%3329 = 1651
+  -778, // n = 35, 2*bitrev(35)+1 = 197, (17**197)%3329 = 1678
+  1159, // n = 36, 2*bitrev(36)+1 = 37, (17**37)%3329 = 2789
+  -1159, // n = 37, 2*bitrev(37)+1 = 165, (17**165)%3329 = 540
+  -147, // n = 38, 2*bitrev(38)+1 = 101, (17**101)%3329 = 1789
+  147, // n = 39, 2*bitrev(39)+1 = 229, (17**229)%3329 = 1540
+  -777, // n = 40, 2*bitrev(40)+1 = 21, (17**21)%3329 = 1847
+  777, // n = 41, 2*bitrev(41)+1 = 149, (17**149)%3329 = 1482
+  1483, // n = 42, 2*bitrev(42)+1 = 85, (17**85)%3329 = 952
+  -1483, // n = 43, 2*bitrev(43)+1 = 213, (17**213)%3329 = 2377
+  -602, // n = 44, 2*bitrev(44)+1 = 53, (17**53)%3329 = 1461
+  602, // n = 45, 2*bitrev(45)+1 = 181, (17**181)%3329 = 1868
+  1119, // n = 46, 2*bitrev(46)+1 = 117, (17**117)%3329 = 2687
+  -1119, // n = 47, 2*bitrev(47)+1 = 245, (17**245)%3329 = 642
+  -1590, // n = 48, 2*bitrev(48)+1 = 13, (17**13)%3329 = 939
+  1590, // n = 49, 2*bitrev(49)+1 = 141, (17**141)%3329 = 2390
+  644, // n = 50, 2*bitrev(50)+1 = 77, (17**77)%3329 = 2308
+  -644, // n = 51, 2*bitrev(51)+1 = 205, (17**205)%3329 = 1021
+  -872, // n = 52, 2*bitrev(52)+1 = 45, (17**45)%3329 = 2437
+  872, // n = 53, 2*bitrev(53)+1 = 173, (17**173)%3329 = 892
+  349, // n = 54, 2*bitrev(54)+1 = 109, (17**109)%3329 = 2388
+  -349, // n = 55, 2*bitrev(55)+1 = 237, (17**237)%3329 = 941
+  418, // n = 56, 2*bitrev(56)+1 = 29, (17**29)%3329 = 733
+  -418, // n = 57, 2*bitrev(57)+1 = 157, (17**157)%3329 = 2596
+  329, // n = 58, 2*bitrev(58)+1 = 93, (17**93)%3329 = 2337
+  -329, // n = 59, 2*bitrev(59)+1 = 221, (17**221)%3329 = 992
+  -156, // n = 60, 2*bitrev(60)+1 = 61, (17**61)%3329 = 268
+  156, // n = 61, 2*bitrev(61)+1 = 189, (17**189)%3329 = 3061
+  -75, // n = 62, 2*bitrev(62)+1 = 125, (17**125)%3329 = 641
+  75, // n = 63, 2*bitrev(63)+1 = 253, (17**253)%3329 = 2688
+  817, // n = 64, 2*bitrev(64)+1 = 3, (17**3)%3329 = 1584
+  -817, // n = 65, 2*bitrev(65)+1 = 131, (17**131)%3329 = 1745
+  1097, // n = 66, 2*bitrev(66)+1 = 67, (17**67)%3329 = 2298
+  -1097, // n = 67, 2*bitrev(67)+1 = 195, (17**195)%3329 = 1031
+  603, // n = 68, 2*bitrev(68)+1 = 35, (17**35)%3329 = 2037
+  -603, // n = 69, 2*bitrev(69)+1 = 163, (17**163)%3329 = 1292
+  610, // n = 70, 2*bitrev(70)+1 = 99, (17**99)%3329 = 3220
+  -610, // n = 71, 2*bitrev(71)+1 = 227, (17**227)%3329 = 109
+  1322, // n = 72, 2*bitrev(72)+1 = 19, (17**19)%3329 = 375
+  -1322, // n = 73, 2*bitrev(73)+1 = 147, (17**147)%3329 = 2954
+  -1285, // n = 74, 2*bitrev(74)+1 = 83, (17**83)%3329 = 2549
+  1285, // n = 75, 2*bitrev(75)+1 = 211, (17**211)%3329 = 780
+  -1465, // n = 76, 2*bitrev(76)+1 = 51, (17**51)%3329 = 2090
+  1465, // n = 77, 2*bitrev(77)+1 = 179, (17**179)%3329 = 1239
+  384, // n = 78, 2*bitrev(78)+1 = 115, (17**115)%3329 = 1645
+  -384, // n = 79, 2*bitrev(79)+1 = 243, (17**243)%3329 = 1684
+  -1215, // n = 80, 2*bitrev(80)+1 = 11, (17**11)%3329 = 1063
+  1215, // n = 81, 2*bitrev(81)+1 = 139, (17**139)%3329 = 2266
+  -136, // n = 82, 2*bitrev(82)+1 = 75, (17**75)%3329 = 319
+  136, // n = 83, 2*bitrev(83)+1 = 203, (17**203)%3329 = 3010
+  1218, // n = 84, 2*bitrev(84)+1 = 43, (17**43)%3329 = 2773
+  -1218, // n = 85, 2*bitrev(85)+1 = 171, (17**171)%3329 = 556
+  -1335, // n = 86, 2*bitrev(86)+1 = 107, (17**107)%3329 = 757
+  1335, // n = 87, 2*bitrev(87)+1 = 235, (17**235)%3329 = 2572
+  -874, // n = 88, 2*bitrev(88)+1 = 27, (17**27)%3329 = 2099
+  874, // n = 89, 2*bitrev(89)+1 = 155, (17**155)%3329 = 1230
+  220, // n = 90, 2*bitrev(90)+1 = 91, (17**91)%3329 = 561
+  -220, // n = 91, 2*bitrev(91)+1 = 219, (17**219)%3329 = 2768
+  -1187, // n = 92, 2*bitrev(92)+1 = 59, (17**59)%3329 = 2466
+  1187, // n = 93, 2*bitrev(93)+1 = 187, (17**187)%3329 = 863
+  -1659, // n = 94, 2*bitrev(94)+1 = 123, (17**123)%3329 = 2594
+  1659, // n = 95, 2*bitrev(95)+1 = 251, (17**251)%3329 = 735
+  -1185, // n = 96, 2*bitrev(96)+1 = 7, (17**7)%3329 = 2804
+  1185, // n = 97, 2*bitrev(97)+1 = 135, (17**135)%3329 = 525
+  -1530, // n = 98, 2*bitrev(98)+1 = 71, (17**71)%3329 = 1092
+  1530, // n = 99, 2*bitrev(99)+1 = 199, (17**199)%3329 = 2237
+  -1278, // n = 100, 2*bitrev(100)+1 = 39, (17**39)%3329 = 403
+  1278, // n = 101, 2*bitrev(101)+1 = 167, (17**167)%3329 = 2926
+  794, // n = 102, 2*bitrev(102)+1 = 103, (17**103)%3329 = 1026
+  -794, // n = 103, 2*bitrev(103)+1 = 231, (17**231)%3329 = 2303
+  -1510, // n = 104, 2*bitrev(104)+1 = 23, (17**23)%3329 = 1143
+  1510, // n = 105, 2*bitrev(105)+1 = 151, (17**151)%3329 = 2186
+  -854, // n = 106, 2*bitrev(106)+1 = 87, (17**87)%3329 = 2150
+  854, // n = 107, 2*bitrev(107)+1 = 215, (17**215)%3329 = 1179
+  -870, // n = 108, 2*bitrev(108)+1 = 55, (17**55)%3329 = 2775
+  870, // n = 109, 2*bitrev(109)+1 = 183, (17**183)%3329 = 554
+  478, // n = 110, 2*bitrev(110)+1 = 119, (17**119)%3329 = 886
+  -478, // n = 111, 2*bitrev(111)+1 = 247, (17**247)%3329 = 2443
+  -108, // n = 112, 2*bitrev(112)+1 = 15, (17**15)%3329 = 1722
+  108, // n = 113, 2*bitrev(113)+1 = 143, (17**143)%3329 = 1607
+  -308, // n = 114, 2*bitrev(114)+1 = 79, (17**79)%3329 = 1212
+  308, // n = 115, 2*bitrev(115)+1 = 207, (17**207)%3329 = 2117
+  996, // n = 116, 2*bitrev(116)+1 = 47, (17**47)%3329 = 1874
+  -996, // n = 117, 2*bitrev(117)+1 = 175, (17**175)%3329 = 1455
+  991, // n = 118, 2*bitrev(118)+1 = 111, (17**111)%3329 = 1029
+  -991, // n = 119, 2*bitrev(119)+1 = 239, (17**239)%3329 = 2300
+  958, // n = 120, 2*bitrev(120)+1 = 31, (17**31)%3329 = 2110
+  -958, // n = 121, 2*bitrev(121)+1 = 159, (17**159)%3329 = 1219
+  -1460, // n = 122, 2*bitrev(122)+1 = 95, (17**95)%3329 = 2935
+  1460, // n = 123, 2*bitrev(123)+1 = 223, (17**223)%3329 = 394
+  1522, // n = 124, 2*bitrev(124)+1 = 63, (17**63)%3329 = 885
+  -1522, // n = 125, 2*bitrev(125)+1 = 191, (17**191)%3329 = 2444
+  1628, // n = 126, 2*bitrev(126)+1 = 127, (17**127)%3329 = 2154
+  -1628, // n = 127, 2*bitrev(127)+1 = 255, (17**255)%3329 = 1175
+};
+
+#if defined(FIPS203IPD_VEC) || defined(FIPS203IPD_AVX2) || defined(FIPS203IPD_AVX512)
+// NTT_LUT entries multiplied by QINV mod 2^16 (companion factors for
+// Montgomery multiplication by an NTT_LUT entry, used by the SIMD NTT
+// kernels)
+static const int16_t NTT_LUT_QINV[] = {
+  -20, 31498, 14745, 787, 13525, -12402, 28191, -16694,
+  -20907, 27758, -3799, -15690, 10690, 1358, -11202, 31164,
+  -5827, 17363, -26360, -29057, 5571, -1102, 21438, -26242,
+  -28073, 24313, -10532, 8800, 18426, 8859, 26675, -16163,
+  -5689, -6516, 1496, 30967, -23565, 20179, 20710, 25080,
+  -12796, 26616, 16064, -12442, 9134, -650, -25986, 27837,
+  19883, -28250, -15887, -8898, -28309, 9075, -30199, 18249,
+  13426, 14017, -29156, -12757, 16832, 4311, -24155, -17915,
+  -335, 11182, -11477, 13387, -32227, -14233, 20494, -21655,
+  -27738, 13131, 945, -4587, -14883, 23092, 6182, 5493,
+  32010, -32502, 10631, 30317, 29175, -18741, -28762, 12639,
+  -18486, 20100, 17560, 18525, -14430, 19529, -5276, -12619,
+  -31183, 20297, 25435, 2146, -7382, 15355, 24391, -32384,
+  -20927, -6280, 10946, -14903, 24214, -11044, 16989, 14469,
+  10335, -21498, -7934, -20198, -22502, 23210, 10906, -17442,
+  31636, -23860, 28644, -20257, 23998, 7756, -17422, 23132,
+};
+#endif /* FIPS203IPD_VEC || FIPS203IPD_AVX2 || FIPS203IPD_AVX512 */
+
+#ifdef FIPS203IPD_VEC
+// portable vector NTT twiddle factors for the len = 4, 2 layers, in
+// the lane order of split operand b, in Montgomery form
+// ([forward, inverse][layer][pair][lane], used by poly_ntt_vec() and
+// poly_inv_ntt_vec())
+static const int16_t NTT_VEC_ZETAS[2][2][16][8] = {
+  {
+    {
+      { 1223, 1223, 1223, 1223, 652, 652, 652, 652 },
+      { -552, -552, -552, -552, 1015, 1015, 1015, 1015 },
+      { -1293, -1293, -1293, -1293, 1491, 1491, 1491, 1491 },
+      { -282, -282, -282, -282, -1544, -1544, -1544, -1544 },
+      { 516, 516, 516, 516, -8, -8, -8, -8 },
+      { -320, -320, -320, -320, -666, -666, -666, -666 },
+      { -1618, -1618, -1618, -1618, -1162, -1162, -1162, -1162 },
+      { 126, 126, 126, 126, 1469, 1469, 1469, 1469 },
+      { -853, -853, -853, -853, -90, -90, -90, -90 },
+      { -271, -271, -271, -271, 830, 830, 830, 830 },
+      { 107, 107, 107, 107, -1421, -1421, -1421, -1421 },
+      { -247, -247, -247, -247, -951, -951, -951, -951 },
+      { -398, -398, -398, -398, 961, 961, 961, 961 },
+      { -1508, -1508, -1508, -1508, -725, -725, -725, -725 },
+      { 448, 448, 448, 448, -1065, -1065, -1065, -1065 },
+      { 677, 677, 677, 677, -1275, -1275, -1275, -1275 },
+    },
+    {
+      { -1103, -1103, 430, 430, 555, 555, 843, 843 },
+      { -1251, -1251, 871, 871, 1550, 1550, 105, 105 },
+      { 422, 422, 587, 587, 177, 177, -235, -235 },
+      { -291, -291, -460, -460, 1574, 1574, 1653, 1653 },
+      { -246, -246, 778, 778, 1159, 1159, -147, -147 },
+      { -777, -777, 1483, 1483, -602, -602, 1119, 1119 },
+      { -1590, -1590, 644, 644, -872, -872, 349, 349 },
+      { 418, 418, 329, 329, -156, -156, -75, -75 },
+      { 817, 817, 1097, 1097, 603, 603, 610, 610 },
+      { 1322, 1322, -1285, -1285, -1465, -1465, 384, 384 },
+      { -1215, -1215, -136, -136, 1218, 1218, -1335, -1335 },
+      { -874, -874, 220, 220, -1187, -1187, -1659, -1659 },
+      { -1185, -1185, -1530, -1530, -1278, -1278, 794, 794 },
+      { -1510, -1510, -854, -854, -870, -870, 478, 478 },
+      { -108, -108, -308, -308, 996, 996, 991, 991 },
+      { 958, 958, -1460, -1460, 1522, 1522, 1628, 1628 },
+    },
+  },
+  {
+    {
+      { -1275, -1275, -1275, -1275, 677, 677, 677, 677 },
+      { -1065, -1065, -1065, -1065, 448, 448, 448, 448 },
+      { -725, -725, -725, -725, -1508, -1508, -1508, -1508 },
+      { 961, 961, 961, 961, -398, -398, -398, -398 },
+      { -951, -951, -951, -951, -247, -247, -247, -247 },
+      { -1421, -1421, -1421, -1421, 107, 107, 107, 107 },
+      { 830, 830, 830, 830, -271, -271, -271, -271 },
+      { -90, -90, -90, -90, -853, -853, -853, -853 },
+      { 1469, 1469, 1469, 1469, 126, 126, 126, 126 },
+      { -1162, -1162, -1162, -1162, -1618, -1618, -1618, -1618 },
+      { -666, -666, -666, -666, -320, -320, -320, -320 },
+      { -8, -8, -8, -8, 516, 516, 516, 516 },
+      { -1544, -1544, -1544, -1544, -282, -282, -282, -282 },
+      { 1491, 1491, 1491, 1491, -1293, -1293, -1293, -1293 },
+      { 1015, 1015, 1015, 1015, -552, -552, -552, -552 },
+      { 652, 652, 652, 652, 1223, 1223, 1223, 1223 },
+    },
+    {
+      { 1628, 1628, 1522, 1522, -1460, -1460, 958, 958 },
+      { 991, 991, 996, 996, -308, -308, -108, -108 },
+      { 478, 478, -870, -870, -854, -854, -1510, -1510 },
+      { 794, 794, -1278, -1278, -1530, -1530, -1185, -1185 },
+      { -1659, -1659, -1187, -1187, 220, 220, -874, -874 },
+      { -1335, -1335, 1218, 1218, -136, -136, -1215, -1215 },
+      { 384, 384, -1465, -1465, -1285, -1285, 1322, 1322 },
+      { 610, 610, 603, 603, 1097, 1097, 817, 817 },
+      { -75, -75, -156, -156, 329, 329, 418, 418 },
+      { 349, 349, -872, -872, 644, 644, -1590, -1590 },
+      { 1119, 1119, -602, -602, 1483, 1483, -777, -777 },
+      { -147, -147, 1159, 1159, 778, 778, -246, -246 },
+      { 1653, 1653, 1574, 1574, -460, -460, -291, -291 },
+      { -235, -235, 177, 177, 587, 587, 422, 422 },
+      { 105, 105, 1550, 1550, 871, 871, -1251, -1251 },
+      { 843, 843, 555, 555, 430, 430, -1103, -1103 },
+    },
+  },
+};
+
+// NTT_VEC_ZETAS multiplied by QINV mod 2^16 (companion factors for
+// Montgomery multiplication)
+static const int16_t NTT_VEC_ZETAS_QINV[2][2][16][8] = {
+  {
+    {
+      { -5689, -5689, -5689, -5689, -6516, -6516, -6516, -6516 },
+      { 1496, 1496, 1496, 1496, 30967, 30967, 30967, 30967 },
+      { -23565, -23565, -23565, -23565, 20179, 20179, 20179, 20179 },
+      { 20710, 20710, 20710, 20710, 25080, 25080, 25080, 25080 },
+      { -12796, -12796, -12796, -12796, 26616, 26616, 26616, 26616 },
+      { 16064, 16064, 16064, 16064, -12442, -12442, -12442, -12442 },
+      { 9134, 9134, 9134, 9134, -650, -650, -650, -650 },
+      { -25986, -25986, -25986, -25986, 27837, 27837, 27837, 27837 },
+      { 19883, 19883, 19883, 19883, -28250, -28250, -28250, -28250 },
+      { -15887, -15887, -15887, -15887, -8898, -8898, -8898, -8898 },
+      { -28309, -28309, -28309, -28309, 9075, 9075, 9075, 9075 },
+      { -30199, -30199, -30199, -30199, 18249, 18249, 18249, 18249 },
+      { 13426, 13426, 13426, 13426, 14017, 14017, 14017, 14017 },
+      { -29156, -29156, -29156, -29156, -12757, -12757, -12757, -12757 },
+      { 16832, 16832, 16832, 16832, 4311, 4311, 4311, 4311 },
+      { -24155, -24155, -24155, -24155, -17915, -17915, -17915, -17915 },
+    },
+    {
+      { -335, -335, 11182, 11182, -11477, -11477, 13387, 13387 },
+      { -32227, -32227, -14233, -14233, 20494, 20494, -21655, -21655 },
+      { -27738, -27738, 13131, 13131, 945, 945, -4587, -4587 },
+      { -14883, -14883, 23092, 23092, 6182, 6182, 5493, 5493 },
+      { 32010, 32010, -32502, -32502, 10631, 10631, 30317, 30317 },
+      { 29175, 29175, -18741, -18741, -28762, -28762, 12639, 12639 },
+      { -18486, -18486, 20100, 20100, 17560, 17560, 18525, 18525 },
+      { -14430, -14430, 19529, 19529, -5276, -5276, -12619, -12619 },
+      { -31183, -31183, 20297, 20297, 25435, 25435, 2146, 2146 },
+      { -7382, -7382, 15355, 15355, 24391, 24391, -32384, -32384 },
+      { -20927, -20927, -6280, -6280, 10946, 10946, -14903, -14903 },
+      { 24214, 24214, -11044, -11044, 16989, 16989, 14469, 14469 },
+      { 10335, 10335, -21498, -21498, -7934, -7934, -20198, -20198 },
+      { -22502, -22502, 23210, 23210, 10906, 10906, -17442, -17442 },
+      { 31636, 31636, -23860, -23860, 28644, 28644, -20257, -20257 },
+      { 23998, 23998, 7756, 7756, -17422, -17422, 23132, 23132 },
+    },
+  },
+  {
+    {
+      { -17915, -17915, -17915, -17915, -24155, -24155, -24155, -24155 },
+      { 4311, 4311, 4311, 4311, 16832, 16832, 16832, 16832 },
+      { -12757, -12757, -12757, -12757, -29156, -29156, -29156, -29156 },
+      { 14017, 14017, 14017, 14017, 13426, 13426, 13426, 13426 },
+      { 18249, 18249, 18249, 18249, -30199, -30199, -30199, -30199 },
+      { 9075, 9075, 9075, 9075, -28309, -28309, -28309, -28309 },
+      { -8898, -8898, -8898, -8898, -15887, -15887, -15887, -15887 },
+      { -28250, -28250, -28250, -28250, 19883, 19883, 19883, 19883 },
+      { 27837, 27837, 27837, 27837, -25986, -25986, -25986, -25986 },
+      { -650, -650, -650, -650, 9134, 9134, 9134, 9134 },
+      { -12442, -12442, -12442, -12442, 16064, 16064, 16064, 16064 },
+      { 26616, 26616, 26616, 26616, -12796, -12796, -12796, -12796 },
+      { 25080, 25080, 25080, 25080, 20710, 20710, 20710, 20710 },
+      { 20179, 20179, 20179, 20179, -23565, -23565, -23565, -23565 },
+      { 30967, 30967, 30967, 30967, 1496, 1496, 1496, 1496 },
+      { -6516, -6516, -6516, -6516, -5689, -5689, -5689, -5689 },
+    },
+    {
+      { 23132, 23132, -17422, -17422, 7756, 7756, 23998, 23998 },
+      { -20257, -20257, 28644, 28644, -23860, -23860, 31636, 31636 },
+      { -17442, -17442, 10906, 10906, 23210, 23210, -22502, -22502 },
+      { -20198, -20198, -7934, -7934, -21498, -21498, 10335, 10335 },
+      { 14469, 14469, 16989, 16989, -11044, -11044, 24214, 24214 },
+      { -14903, -14903, 10946, 10946, -6280, -6280, -20927, -20927 },
+      { -32384, -32384, 24391, 24391, 15355, 15355, -7382, -7382 },
+      { 2146, 2146, 25435, 25435, 20297, 20297, -31183, -31183 },
+      { -12619, -12619, -5276, -5276, 19529, 19529, -14430, -14430 },
+      { 18525, 18525, 17560, 17560, 20100, 20100, -18486, -18486 },
+      { 12639, 12639, -28762, -28762, -18741, -18741, 29175, 29175 },
+      { 30317, 30317, 10631, 10631, -32502, -32502, 32010, 32010 },
+      { 5493, 5493, 6182, 6182, 23092, 23092, -14883, -14883 },
+      { -4587, -4587, 945, 945, 13131, 13131, -27738, -27738 },
+      { -21655, -21655, 20494, 20494, -14233, -14233, -32227, -32227 },
+      { 13387, 13387, -11477, -11477, 11182, 11182, -335, -335 },
+    },
+  },
+};
+#endif /* FIPS203IPD_VEC */
+
+#ifdef FIPS203IPD_AVX2
+// AVX2 NTT twiddle factors for the len = 8, 4, 2 layers, in the lane
+// order of split operand b, in Montgomery form
+// ([forward, inverse][layer][pair][lane], used by poly_ntt_avx2() and
+// poly_inv_ntt_avx2())
+static const int16_t NTT_AVX2_ZETAS[2][3][8][16] = {
+  {
+    {
+      { 573, 573, 573, 573, 573, 573, 573, 573, -1325, -1325, -1325, -1325, -1325, -1325, -1325, -1325 },
+      { 264, 264, 264, 264, 264, 264, 264, 264, 383, 383, 383, 383, 383, 383, 383, 383 },
+      { -829, -829, -829, -829, -829, -829, -829, -829, 1458, 1458, 1458, 1458, 1458, 1458, 1458, 1458 },
+      { -1602, -1602, -1602, -1602, -1602, -1602, -1602, -1602, -130, -130, -130, -130, -130, -130, -130, -130 },
+      { -681, -681, -681, -681, -681, -681, -681, -681, 1017, 1017, 1017, 1017, 1017, 1017, 1017, 1017 },
+      { 732, 732, 732, 732, 732, 732, 732, 732, 608, 608, 608, 608, 608, 608, 608, 608 },
+      { -1542, -1542, -1542, -1542, -1542, -1542, -1542, -1542, 411, 411, 411, 411, 411, 411, 411, 411 },
+      { -205, -205, -205, -205, -205, -205, -205, -205, -1571, -1571, -1571, -1571, -1571, -1571, -1571, -1571 },
+    },
+    {
+      { 1223, 1223, 1223, 1223, -552, -552, -552, -552, 652, 652, 652, 652, 1015, 1015, 1015, 1015 },
+      { -1293, -1293, -1293, -1293, -282, -282, -282, -282, 1491, 1491, 1491, 1491, -1544, -1544, -1544, -1544 },
+      { 516, 516, 516, 516, -320, -320, -320, -320, -8, -8, -8, -8, -666, -666, -666, -666 },
+      { -1618, -1618, -1618, -1618, 126, 126, 126, 126, -1162, -1162, -1162, -1162, 1469, 1469, 1469, 1469 },
+      { -853, -853, -853, -853, -271, -271, -271, -271, -90, -90, -90, -90, 830, 830, 830, 830 },
+      { 107, 107, 107, 107, -247, -247, -247, -247, -1421, -1421, -1421, -1421, -951, -951, -951, -951 },
+      { -398, -398, -398, -398, -1508, -1508, -1508, -1508, 961, 961, 961, 961, -725, -725, -725, -725 },
+      { 448, 448, 448, 448, 677, 677, 677, 677, -1065, -1065, -1065, -1065, -1275, -1275, -1275, -1275 },
+    },
+    {
+      { -1103, -1103, 430, 430, -1251, -1251, 871, 871, 555, 555, 843, 843, 1550, 1550, 105, 105 },
+      { 422, 422, 587, 587, -291, -291, -460, -460, 177, 177, -235, -235, 1574, 1574, 1653, 1653 },
+      { -246, -246, 778, 778, -777, -777, 1483, 1483, 1159, 1159, -147, -147, -602, -602, 1119, 1119 },
+      { -1590, -1590, 644, 644, 418, 418, 329, 329, -872, -872, 349, 349, -156, -156, -75, -75 },
+      { 817, 817, 1097, 1097, 1322, 1322, -1285, -1285, 603, 603, 610, 610, -1465, -1465, 384, 384 },
+      { -1215, -1215, -136, -136, -874, -874, 220, 220, 1218, 1218, -1335, -1335, -1187, -1187, -1659, -1659 },
+      { -1185, -1185, -1530, -1530, -1510, -1510, -854, -854, -1278, -1278, 794, 794, -870, -870, 478, 478 },
+      { -108, -108, -308, -308, 958, 958, -1460, -1460, 996, 996, 991, 991, 1522, 1522, 1628, 1628 },
+    },
+  },
+  {
+    {
+      { -1571, -1571, -1571, -1571, -1571, -1571, -1571, -1571, -205, -205, -205, -205, -205, -205, -205, -205 },
+      { 411, 411, 411, 411, 411, 411, 411, 411, -1542, -1542, -1542, -1542, -1542, -1542, -1542, -1542 },
+      { 608, 608, 608, 608, 608, 608, 608, 608, 732, 732, 732, 732, 732, 732, 732, 732 },
+      { 1017, 1017, 1017, 1017, 1017, 1017, 1017, 1017, -681, -681, -681, -681, -681, -681, -681, -681 },
+      { -130, -130, -130, -130, -130, -130, -130, -130, -1602, -1602, -1602, -1602, -1602, -1602, -1602, -1602 },
+      { 1458, 1458, 1458, 1458, 1458, 1458, 1458, 1458, -829, -829, -829, -829, -829, -829, -829, -829 },
+      { 383, 383, 383, 383, 383, 383, 383, 383, 264, 264, 264, 264, 264, 264, 264, 264 },
+      { -1325, -1325, -1325, -1325, -1325, -1325, -1325, -1325, 573, 573, 573, 573, 573, 573, 573, 573 },
+    },
+    {
+      { -1275, -1275, -1275, -1275, -1065, -1065, -1065, -1065, 677, 677, 677, 677, 448, 448, 448, 448 },
+      { -725, -725, -725, -725, 961, 961, 961, 961, -1508, -1508, -1508, -1508, -398, -398, -398, -398 },
+      { -951, -951, -951, -951, -1421, -1421, -1421, -1421, -247, -247, -247, -247, 107, 107, 107, 107 },
+      { 830, 830, 830, 830, -90, -90, -90, -90, -271, -271, -271, -271, -853, -853, -853, -853 },
+      { 1469, 1469, 1469, 1469, -1162, -1162, -1162, -1162, 126, 126, 126, 126, -1618, -1618, -1618, -1618 },
+      { -666, -666, -666, -666, -8, -8, -8, -8, -320, -320, -320, -320, 516, 516, 516, 516 },
+      { -1544, -1544, -1544, -1544, 1491, 1491, 1491, 1491, -282, -282, -282, -282, -1293, -1293, -1293, -1293 },
+      { 1015, 1015, 1015, 1015, 652, 652, 652, 652, -552, -552, -552, -552, 1223, 1223, 1223, 1223 },
+    },
+    {
+      { 1628, 1628, 1522, 1522, 991, 991, 996, 996, -1460, -1460, 958, 958, -308, -308, -108, -108 },
+      { 478, 478, -870, -870, 794, 794, -1278, -1278, -854, -854, -1510, -1510, -1530, -1530, -1185, -1185 },
+      { -1659, -1659, -1187, -1187, -1335, -1335, 1218, 1218, 220, 220, -874, -874, -136, -136, -1215, -1215 },
+      { 384, 384, -1465, -1465, 610, 610, 603, 603, -1285, -1285, 1322, 1322, 1097, 1097, 817, 817 },
+      { -75, -75, -156, -156, 349, 349, -872, -872, 329, 329, 418, 418, 644, 644, -1590, -1590 },
+      { 1119, 1119, -602, -602, -147, -147, 1159, 1159, 1483, 1483, -777, -777, 778, 778, -246, -246 },
+      { 1653, 1653, 1574, 1574, -235, -235, 177, 177, -460, -460, -291, -291, 587, 587, 422, 422 },
+      { 105, 105, 1550, 1550, 843, 843, 555, 555, 871, 871, -1251, -1251, 430, 430, -1103, -1103 },
+    },
+  },
+};
+
+// NTT_AVX2_ZETAS multiplied by QINV mod 2^16 (companion factors for
+// Montgomery multiplication)
+static const int16_t NTT_AVX2_ZETAS_QINV[2][3][8][16] = {
+  {
+    {
+      { -5827, -5827, -5827, -5827, -5827, -5827, -5827, -5827, 17363, 17363, 17363, 17363, 17363, 17363, 17363, 17363 },
+      { -26360, -26360, -26360, -26360, -26360, -26360, -26360, -26360, -29057, -29057, -29057, -29057, -29057, -29057, -29057, -29057 },
+      { 5571, 5571, 5571, 5571, 5571, 5571, 5571, 5571, -1102, -1102, -1102, -1102, -1102, -1102, -1102, -1102 },
+      { 21438, 21438, 21438, 21438, 21438, 21438, 21438, 21438, -26242, -26242, -26242, -26242, -26242, -26242, -26242, -26242 },
+      { -28073, -28073, -28073, -28073, -28073, -28073, -28073, -28073, 24313, 24313, 24313, 24313, 24313, 24313, 24313, 24313 },
+      { -10532, -10532, -10532, -10532, -10532, -10532, -10532, -10532, 8800, 8800, 8800, 8800, 8800, 8800, 8800, 8800 },
+      { 18426, 18426, 18426, 18426, 18426, 18426, 18426, 18426, 8859, 8859, 8859, 8859, 8859, 8859, 8859, 8859 },
+      { 26675, 26675, 26675, 26675, 26675, 26675, 26675, 26675, -16163, -16163, -16163, -16163, -16163, -16163, -16163, -16163 },
+    },
+    {
+      { -5689, -5689, -5689, -5689, 1496, 1496, 1496, 1496, -6516, -6516, -6516, -6516, 30967, 30967, 30967, 30967 },
+      { -23565, -23565, -23565, -23565, 20710, 20710, 20710, 20710, 20179, 20179, 20179, 20179, 25080, 25080, 25080, 25080 },
+      { -12796, -12796, -12796, -12796, 16064, 16064, 16064, 16064, 26616, 26616, 26616, 26616, -12442, -12442, -12442, -12442 },
+      { 9134, 9134, 9134, 9134, -25986, -25986, -25986, -25986, -650, -650, -650, -650, 27837, 27837, 27837, 27837 },
+      { 19883, 19883, 19883, 19883, -15887, -15887, -15887, -15887, -28250, -28250, -28250, -28250, -8898, -8898, -8898, -8898 },
+      { -28309, -28309, -28309, -28309, -30199, -30199, -30199, -30199, 9075, 9075, 9075, 9075, 18249, 18249, 18249, 18249 },
+      { 13426, 13426, 13426, 13426, -29156, -29156, -29156, -29156, 14017, 14017, 14017, 14017, -12757, -12757, -12757, -12757 },
+      { 16832, 16832, 16832, 16832, -24155, -24155, -24155, -24155, 4311, 4311, 4311, 4311, -17915, -17915, -17915, -17915 },
+    },
+    {
+      { -335, -335, 11182, 11182, -32227, -32227, -14233, -14233, -11477, -11477, 13387, 13387, 20494, 20494, -21655, -21655 },
+      { -27738, -27738, 13131, 13131, -14883, -14883, 23092, 23092, 945, 945, -4587, -4587, 6182, 6182, 5493, 5493 },
+      { 32010, 32010, -32502, -32502, 29175, 29175, -18741, -18741, 10631, 10631, 30317, 30317, -28762, -28762, 12639, 12639 },
+      { -18486, -18486, 20100, 20100, -14430, -14430, 19529, 19529, 17560, 17560, 18525, 18525, -5276, -5276, -12619, -12619 },
+      { -31183, -31183, 20297, 20297, -7382, -7382, 15355, 15355, 25435, 25435, 2146, 2146, 24391, 24391, -32384, -32384 },
+      { -20927, -20927, -6280, -6280, 24214, 24214, -11044, -11044, 10946, 10946, -14903, -14903, 16989, 16989, 14469, 14469 },
+      { 10335, 10335, -21498, -21498, -22502, -22502, 23210, 23210, -7934, -7934, -20198, -20198, 10906, 10906, -17442, -17442 },
+      { 31636, 31636, -23860, -23860, 23998, 23998, 7756, 7756, 28644, 28644, -20257, -20257, -17422, -17422, 23132, 23132 },
+    },
+  },
+  {
+    {
+      { -16163, -16163, -16163, -16163, -16163, -16163, -16163, -16163, 26675, 26675, 26675, 26675, 26675, 26675, 26675, 26675 },
+      { 8859, 8859, 8859, 8859, 8859, 8859, 8859, 8859, 18426, 18426, 18426, 18426, 18426, 18426, 18426, 18426 },
+      { 8800, 8800, 8800, 8800, 8800, 8800, 8800, 8800, -10532, -10532, -10532, -10532, -10532, -10532, -10532, -10532 },
+      { 24313, 24313, 24313, 24313, 24313, 24313, 24313, 24313, -28073, -28073, -28073, -28073, -28073, -28073, -28073, -28073 },
+      { -26242, -26242, -26242, -26242, -26242, -26242, -26242, -26242, 21438, 21438, 21438, 21438, 21438, 21438, 21438, 21438 },
+      { -1102, -1102, -1102, -1102, -1102, -1102, -1102, -1102, 5571, 5571, 5571, 5571, 5571, 5571, 5571, 5571 },
+      { -29057, -29057, -29057, -29057, -29057, -29057, -29057, -29057, -26360, -26360, -26360, -26360, -26360, -26360, -26360, -26360 },
+      { 17363, 17363, 17363, 17363, 17363, 17363, 17363, 17363, -5827, -5827, -5827, -5827, -5827, -5827, -5827, -5827 },
+    },
+    {
+      { -17915, -17915, -17915, -17915, 4311, 4311, 4311, 4311, -24155, -24155, -24155, -24155, 16832, 16832, 16832, 16832 },
+      { -12757, -12757, -12757, -12757, 14017, 14017, 14017, 14017, -29156, -29156, -29156, -29156, 13426, 13426, 13426, 13426 },
+      { 18249, 18249, 18249, 18249, 9075, 9075, 9075, 9075, -30199, -30199, -30199, -30199, -28309, -28309, -28309, -28309 },
+      { -8898, -8898, -8898, -8898, -28250, -28250, -28250, -28250, -15887, -15887, -15887, -15887, 19883, 19883, 19883, 19883 },
+      { 27837, 27837, 27837, 27837, -650, -650, -650, -650, -25986, -25986, -25986, -25986, 9134, 9134, 9134, 9134 },
+      { -12442, -12442, -12442, -12442, 26616, 26616, 26616, 26616, 16064, 16064, 16064, 16064, -12796, -12796, -12796, -12796 },
+      { 25080, 25080, 25080, 25080, 20179, 20179, 20179, 20179, 20710, 20710, 20710, 20710, -23565, -23565, -23565, -23565 },
+      { 30967, 30967, 30967, 30967, -6516, -6516, -6516, -6516, 1496, 1496, 1496, 1496, -5689, -5689, -5689, -5689 },
+    },
+    {
+      { 23132, 23132, -17422, -17422, -20257, -20257, 28644, 28644, 7756, 7756, 23998, 23998, -23860, -23860, 31636, 31636 },
+      { -17442, -17442, 10906, 10906, -20198, -20198, -7934, -7934, 23210, 23210, -22502, -22502, -21498, -21498, 10335, 10335 },
+      { 14469, 14469, 16989, 16989, -14903, -14903, 10946, 10946, -11044, -11044, 24214, 24214, -6280, -6280, -20927, -20927 },
+      { -32384, -32384, 24391, 24391, 2146, 2146, 25435, 25435, 15355, 15355, -7382, -7382, 20297, 20297, -31183, -31183 },
+      { -12619, -12619, -5276, -5276, 18525, 18525, 17560, 17560, 19529, 19529, -14430, -14430, 20100, 20100, -18486, -18486 },
+      { 12639, 12639, -28762, -28762, 30317, 30317, 10631, 10631, -18741, -18741, 29175, 29175, -32502, -32502, 32010, 32010 },
+      { 5493, 5493, 6182, 6182, -4587, -4587, 945, 945, 23092, 23092, -14883, -14883, 13131, 13131, -27738, -27738 },
+      { -21655, -21655, 20494, 20494, 13387, 13387, -11477, -11477, -14233, -14233, -32227, -32227, 11182, 11182, -335, -335 },
+    },
+  },
+};
+
+// AVX2 rejection sampler left-pack shuffles ([mask of accepted
+// lanes][byte], used by poly_sample_ntt_parse_avx2())
+static const int8_t REJ_AVX2_IDX[256][16] = {
+  { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1 },
+  { 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 10, 11, -1, -1, -1, -1, -1, -1 },
+  { 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1 },
+  { 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 13, -1, -1, -1, -1 },
+  { 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 10, 11, 12, 13, -1, -1, -1, -1 },
+  { 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1 },
+  { 6, 7, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, -1, -1 },
+  { 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 14, 15, -1, -1, -1, -1 },
+  { 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1 },
+  { 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1 },
+  { 6, 7, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 14, 15, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 14, 15, -1, -1 },
+  { 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 6, 7, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 6, 7, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, -1, -1 },
+  { 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 4, 5, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 6, 7, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 4, 5, 6, 7, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 10, 11, 12, 13, 14, 15, -1, -1 },
+  { 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 2, 3, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 4, 5, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1 },
+  { 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1 },
+  { 0, 1, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 2, 3, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 0, 1, 2, 3, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1 },
+  { 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1 },
+  { 0, 1, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1 },
+  { 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+};
+#endif /* FIPS203IPD_AVX2 */
+
+#ifdef FIPS203IPD_AVX512
+// AVX-512 NTT lane permutations for the len = 16, 8, 4, 2 layers
+// ([layer][split a, split b, merge x, merge y][lane], used by
+// poly_ntt_avx512() and poly_inv_ntt_avx512())
+static const uint16_t NTT_AVX512_PERMS[4][4][32] = {
+  {
+    {
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    },
+    {
+      16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    },
+    {
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    },
+    {
+      16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    },
+  },
+  {
+    {
+      0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23, 32, 33, 34, 35, 36, 37, 38, 39, 48, 49, 50, 51, 52, 53, 54, 55,
+    },
+    {
+      8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31, 40, 41, 42, 43, 44, 45, 46, 47, 56, 57, 58, 59, 60, 61, 62, 63,
+    },
+    {
+      0, 1, 2, 3, 4, 5, 6, 7, 32, 33, 34, 35, 36, 37, 38, 39, 8, 9, 10, 11, 12, 13, 14, 15, 40, 41, 42, 43, 44, 45, 46, 47,
+    },
+    {
+      16, 17, 18, 19, 20, 21, 22, 23, 48, 49, 50, 51, 52, 53, 54, 55, 24, 25, 26, 27, 28, 29, 30, 31, 56, 57, 58, 59, 60, 61, 62, 63,
+    },
+  },
+  {
+    {
+      0, 1, 2, 3, 8, 9, 10, 11, 16, 17, 18, 19, 24, 25, 26, 27, 32, 33, 34, 35, 40, 41, 42, 43, 48, 49, 50, 51, 56, 57, 58, 59,
+    },
+    {
+      4, 5, 6, 7, 12, 13, 14, 15, 20, 21, 22, 23, 28, 29, 30, 31, 36, 37, 38, 39, 44, 45, 46, 47, 52, 53, 54, 55, 60, 61, 62, 63,
+    },
+    {
+      0, 1, 2, 3, 32, 33, 34, 35, 4, 5, 6, 7, 36, 37, 38, 39, 8, 9, 10, 11, 40, 41, 42, 43, 12, 13, 14, 15, 44, 45, 46, 47,
+    },
+    {
+      16, 17, 18, 19, 48, 49, 50, 51, 20, 21, 22, 23, 52, 53, 54, 55, 24, 25, 26, 27, 56, 57, 58, 59, 28, 29, 30, 31, 60, 61, 62, 63,
+    },
+  },
+  {
+    {
+      0, 1, 4, 5, 8, 9, 12, 13, 16, 17, 20, 21, 24, 25, 28, 29, 32, 33, 36, 37, 40, 41, 44, 45, 48, 49, 52, 53, 56, 57, 60, 61,
+    },
+    {
+      2, 3, 6, 7, 10, 11, 14, 15, 18, 19, 22, 23, 26, 27, 30, 31, 34, 35, 38, 39, 42, 43, 46, 47, 50, 51, 54, 55, 58, 59, 62, 63,
+    },
+    {
+      0, 1, 32, 33, 2, 3, 34, 35, 4, 5, 36, 37, 6, 7, 38, 39, 8, 9, 40, 41, 10, 11, 42, 43, 12, 13, 44, 45, 14, 15, 46, 47,
+    },
+    {
+      16, 17, 48, 49, 18, 19, 50, 51, 20, 21, 52, 53, 22, 23, 54, 55, 24, 25, 56, 57, 26, 27, 58, 59, 28, 29, 60, 61, 30, 31, 62, 63,
+    },
+  },
+};
+
+// AVX-512 NTT twiddle factors for the len = 16, 8, 4, 2 layers, in the
+// lane order of split operand b, in Montgomery form
+// ([forward, inverse][layer][pair][lane])
+static const int16_t NTT_AVX512_ZETAS[2][4][4][32] = {
+  {
+    {
+      {
+        -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622,
+      },
+      {
+        1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182,
+      },
+      {
+        962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202,
+      },
+      {
+        -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468,
+      },
+    },
+    {
+      {
+        573, 573, 573, 573, 573, 573, 573, 573, -1325, -1325, -1325, -1325, -1325, -1325, -1325, -1325, 264, 264, 264, 264, 264, 264, 264, 264, 383, 383, 383, 383, 383, 383, 383, 383,
+      },
+      {
+        -829, -829, -829, -829, -829, -829, -829, -829, 1458, 1458, 1458, 1458, 1458, 1458, 1458, 1458, -1602, -1602, -1602, -1602, -1602, -1602, -1602, -1602, -130, -130, -130, -130, -130, -130, -130, -130,
+      },
+      {
+        -681, -681, -681, -681, -681, -681, -681, -681, 1017, 1017, 1017, 1017, 1017, 1017, 1017, 1017, 732, 732, 732, 732, 732, 732, 732, 732, 608, 608, 608, 608, 608, 608, 608, 608,
+      },
+      {
+        -1542, -1542, -1542, -1542, -1542, -1542, -1542, -1542, 411, 411, 411, 411, 411, 411, 411, 411, -205, -205, -205, -205, -205, -205, -205, -205, -1571, -1571, -1571, -1571, -1571, -1571, -1571, -1571,
+      },
+    },
+    {
+      {
+        1223, 1223, 1223, 1223, 652, 652, 652, 652, -552, -552, -552, -552, 1015, 1015, 1015, 1015, -1293, -1293, -1293, -1293, 1491, 1491, 1491, 1491, -282, -282, -282, -282, -1544, -1544, -1544, -1544,
+      },
+      {
+        516, 516, 516, 516, -8, -8, -8, -8, -320, -320, -320, -320, -666, -666, -666, -666, -1618, -1618, -1618, -1618, -1162, -1162, -1162, -1162, 126, 126, 126, 126, 1469, 1469, 1469, 1469,
+      },
+      {
+        -853, -853, -853, -853, -90, -90, -90, -90, -271, -271, -271, -271, 830, 830, 830, 830, 107, 107, 107, 107, -1421, -1421, -1421, -1421, -247, -247, -247, -247, -951, -951, -951, -951,
+      },
+      {
+        -398, -398, -398, -398, 961, 961, 961, 961, -1508, -1508, -1508, -1508, -725, -725, -725, -725, 448, 448, 448, 448, -1065, -1065, -1065, -1065, 677, 677, 677, 677, -1275, -1275, -1275, -1275,
+      },
+    },
+    {
+      {
+        -1103, -1103, 430, 430, 555, 555, 843, 843, -1251, -1251, 871, 871, 1550, 1550, 105, 105, 422, 422, 587, 587, 177, 177, -235, -235, -291, -291, -460, -460, 1574, 1574, 1653, 1653,
+      },
+      {
+        -246, -246, 778, 778, 1159, 1159, -147, -147, -777, -777, 1483, 1483, -602, -602, 1119, 1119, -1590, -1590, 644, 644, -872, -872, 349, 349, 418, 418, 329, 329, -156, -156, -75, -75,
+      },
+      {
+        817, 817, 1097, 1097, 603, 603, 610, 610, 1322, 1322, -1285, -1285, -1465, -1465, 384, 384, -1215, -1215, -136, -136, 1218, 1218, -1335, -1335, -874, -874, 220, 220, -1187, -1187, -1659, -1659,
+      },
+      {
+        -1185, -1185, -1530, -1530, -1278, -1278, 794, 794, -1510, -1510, -854, -854, -870, -870, 478, 478, -108, -108, -308, -308, 996, 996, 991, 991, 958, 958, -1460, -1460, 1522, 1522, 1628, 1628,
+      },
+    },
+  },
+  {
+    {
+      {
+        1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, 1468, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474, -1474,
+      },
+      {
+        -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, -1202, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962, 962,
+      },
+      {
+        182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577, 1577,
+      },
+      {
+        622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, 622, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171, -171,
+      },
+    },
+    {
+      {
+        -1571, -1571, -1571, -1571, -1571, -1571, -1571, -1571, -205, -205, -205, -205, -205, -205, -205, -205, 411, 411, 411, 411, 411, 411, 411, 411, -1542, -1542, -1542, -1542, -1542, -1542, -1542, -1542,
+      },
+      {
+        608, 608, 608, 608, 608, 608, 608, 608, 732, 732, 732, 732, 732, 732, 732, 732, 1017, 1017, 1017, 1017, 1017, 1017, 1017, 1017, -681, -681, -681, -681, -681, -681, -681, -681,
+      },
+      {
+        -130, -130, -130, -130, -130, -130, -130, -130, -1602, -1602, -1602, -1602, -1602, -1602, -1602, -1602, 1458, 1458, 1458, 1458, 1458, 1458, 1458, 1458, -829, -829, -829, -829, -829, -829, -829, -829,
+      },
+      {
+        383, 383, 383, 383, 383, 383, 383, 383, 264, 264, 264, 264, 264, 264, 264, 264, -1325, -1325, -1325, -1325, -1325, -1325, -1325, -1325, 573, 573, 573, 573, 573, 573, 573, 573,
+      },
+    },
+    {
+      {
+        -1275, -1275, -1275, -1275, 677, 677, 677, 677, -1065, -1065, -1065, -1065, 448, 448, 448, 448, -725, -725, -725, -725, -1508, -1508, -1508, -1508, 961, 961, 961, 961, -398, -398, -398, -398,
+      },
+      {
+        -951, -951, -951, -951, -247, -247, -247, -247, -1421, -1421, -1421, -1421, 107, 107, 107, 107, 830, 830, 830, 830, -271, -271, -271, -271, -90, -90, -90, -90, -853, -853, -853, -853,
+      },
+      {
+        1469, 1469, 1469, 1469, 126, 126, 126, 126, -1162, -1162, -1162, -1162, -1618, -1618, -1618, -1618, -666, -666, -666, -666, -320, -320, -320, -320, -8, -8, -8, -8, 516, 516, 516, 516,
+      },
+      {
+        -1544, -1544, -1544, -1544, -282, -282, -282, -282, 1491, 1491, 1491, 1491, -1293, -1293, -1293, -1293, 1015, 1015, 1015, 1015, -552, -552, -552, -552, 652, 652, 652, 652, 1223, 1223, 1223, 1223,
+      },
+    },
+    {
+      {
+        1628, 1628, 1522, 1522, -1460, -1460, 958, 958, 991, 991, 996, 996, -308, -308, -108, -108, 478, 478, -870, -870, -854, -854, -1510, -1510, 794, 794, -1278, -1278, -1530, -1530, -1185, -1185,
+      },
+      {
+        -1659, -1659, -1187, -1187, 220, 220, -874, -874, -1335, -1335, 1218, 1218, -136, -136, -1215, -1215, 384, 384, -1465, -1465, -1285, -1285, 1322, 1322, 610, 610, 603, 603, 1097, 1097, 817, 817,
+      },
+      {
+        -75, -75, -156, -156, 329, 329, 418, 418, 349, 349, -872, -872, 644, 644, -1590, -1590, 1119, 1119, -602, -602, 1483, 1483, -777, -777, -147, -147, 1159, 1159, 778, 778, -246, -246,
+      },
+      {
+        1653, 1653, 1574, 1574, -460, -460, -291, -291, -235, -235, 177, 177, 587, 587, 422, 422, 105, 105, 1550, 1550, 871, 871, -1251, -1251, 843, 843, 555, 555, 430, 430, -1103, -1103,
+      },
+    },
+  },
+};
+
+// NTT_AVX512_ZETAS multiplied by QINV mod 2^16 (companion factors for
+// Montgomery multiplication)
+static const int16_t NTT_AVX512_ZETAS_QINV[2][4][4][32] = {
+  {
+    {
+      {
+        -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758,
+      },
+      {
+        -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690,
+      },
+      {
+        10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358,
+      },
+      {
+        -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164,
+      },
+    },
+    {
+      {
+        -5827, -5827, -5827, -5827, -5827, -5827, -5827, -5827, 17363, 17363, 17363, 17363, 17363, 17363, 17363, 17363, -26360, -26360, -26360, -26360, -26360, -26360, -26360, -26360, -29057, -29057, -29057, -29057, -29057, -29057, -29057, -29057,
+      },
+      {
+        5571, 5571, 5571, 5571, 5571, 5571, 5571, 5571, -1102, -1102, -1102, -1102, -1102, -1102, -1102, -1102, 21438, 21438, 21438, 21438, 21438, 21438, 21438, 21438, -26242, -26242, -26242, -26242, -26242, -26242, -26242, -26242,
+      },
+      {
+        -28073, -28073, -28073, -28073, -28073, -28073, -28073, -28073, 24313, 24313, 24313, 24313, 24313, 24313, 24313, 24313, -10532, -10532, -10532, -10532, -10532, -10532, -10532, -10532, 8800, 8800, 8800, 8800, 8800, 8800, 8800, 8800,
+      },
+      {
+        18426, 18426, 18426, 18426, 18426, 18426, 18426, 18426, 8859, 8859, 8859, 8859, 8859, 8859, 8859, 8859, 26675, 26675, 26675, 26675, 26675, 26675, 26675, 26675, -16163, -16163, -16163, -16163, -16163, -16163, -16163, -16163,
+      },
+    },
+    {
+      {
+        -5689, -5689, -5689, -5689, -6516, -6516, -6516, -6516, 1496, 1496, 1496, 1496, 30967, 30967, 30967, 30967, -23565, -23565, -23565, -23565, 20179, 20179, 20179, 20179, 20710, 20710, 20710, 20710, 25080, 25080, 25080, 25080,
+      },
+      {
+        -12796, -12796, -12796, -12796, 26616, 26616, 26616, 26616, 16064, 16064, 16064, 16064, -12442, -12442, -12442, -12442, 9134, 9134, 9134, 9134, -650, -650, -650, -650, -25986, -25986, -25986, -25986, 27837, 27837, 27837, 27837,
+      },
+      {
+        19883, 19883, 19883, 19883, -28250, -28250, -28250, -28250, -15887, -15887, -15887, -15887, -8898, -8898, -8898, -8898, -28309, -28309, -28309, -28309, 9075, 9075, 9075, 9075, -30199, -30199, -30199, -30199, 18249, 18249, 18249, 18249,
+      },
+      {
+        13426, 13426, 13426, 13426, 14017, 14017, 14017, 14017, -29156, -29156, -29156, -29156, -12757, -12757, -12757, -12757, 16832, 16832, 16832, 16832, 4311, 4311, 4311, 4311, -24155, -24155, -24155, -24155, -17915, -17915, -17915, -17915,
+      },
+    },
+    {
+      {
+        -335, -335, 11182, 11182, -11477, -11477, 13387, 13387, -32227, -32227, -14233, -14233, 20494, 20494, -21655, -21655, -27738, -27738, 13131, 13131, 945, 945, -4587, -4587, -14883, -14883, 23092, 23092, 6182, 6182, 5493, 5493,
+      },
+      {
+        32010, 32010, -32502, -32502, 10631, 10631, 30317, 30317, 29175, 29175, -18741, -18741, -28762, -28762, 12639, 12639, -18486, -18486, 20100, 20100, 17560, 17560, 18525, 18525, -14430, -14430, 19529, 19529, -5276, -5276, -12619, -12619,
+      },
+      {
+        -31183, -31183, 20297, 20297, 25435, 25435, 2146, 2146, -7382, -7382, 15355, 15355, 24391, 24391, -32384, -32384, -20927, -20927, -6280, -6280, 10946, 10946, -14903, -14903, 24214, 24214, -11044, -11044, 16989, 16989, 14469, 14469,
+      },
+      {
+        10335, 10335, -21498, -21498, -7934, -7934, -20198, -20198, -22502, -22502, 23210, 23210, 10906, 10906, -17442, -17442, 31636, 31636, -23860, -23860, 28644, 28644, -20257, -20257, 23998, 23998, 7756, 7756, -17422, -17422, 23132, 23132,
+      },
+    },
+  },
+  {
+    {
+      {
+        31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, 31164, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202, -11202,
+      },
+      {
+        1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 1358, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690, 10690,
+      },
+      {
+        -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -15690, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799, -3799,
+      },
+      {
+        27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, 27758, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907, -20907,
+      },
+    },
+    {
+      {
+        -16163, -16163, -16163, -16163, -16163, -16163, -16163, -16163, 26675, 26675, 26675, 26675, 26675, 26675, 26675, 26675, 8859, 8859, 8859, 8859, 8859, 8859, 8859, 8859, 18426, 18426, 18426, 18426, 18426, 18426, 18426, 18426,
+      },
+      {
+        8800, 8800, 8800, 8800, 8800, 8800, 8800, 8800, -10532, -10532, -10532, -10532, -10532, -10532, -10532, -10532, 24313, 24313, 24313, 24313, 24313, 24313, 24313, 24313, -28073, -28073, -28073, -28073, -28073, -28073, -28073, -28073,
+      },
+      {
+        -26242, -26242, -26242, -26242, -26242, -26242, -26242, -26242, 21438, 21438, 21438, 21438, 21438, 21438, 21438, 21438, -1102, -1102, -1102, -1102, -1102, -1102, -1102, -1102, 5571, 5571, 5571, 5571, 5571, 5571, 5571, 5571,
+      },
+      {
+        -29057, -29057, -29057, -29057, -29057, -29057, -29057, -29057, -26360, -26360, -26360, -26360, -26360, -26360, -26360, -26360, 17363, 17363, 17363, 17363, 17363, 17363, 17363, 17363, -5827, -5827, -5827, -5827, -5827, -5827, -5827, -5827,
+      },
+    },
+    {
+      {
+        -17915, -17915, -17915, -17915, -24155, -24155, -24155, -24155, 4311, 4311, 4311, 4311, 16832, 16832, 16832, 16832, -12757, -12757, -12757, -12757, -29156, -29156, -29156, -29156, 14017, 14017, 14017, 14017, 13426, 13426, 13426, 13426,
+      },
+      {
+        18249, 18249, 18249, 18249, -30199, -30199, -30199, -30199, 9075, 9075, 9075, 9075, -28309, -28309, -28309, -28309, -8898, -8898, -8898, -8898, -15887, -15887, -15887, -15887, -28250, -28250, -28250, -28250, 19883, 19883, 19883, 19883,
+      },
+      {
+        27837, 27837, 27837, 27837, -25986, -25986, -25986, -25986, -650, -650, -650, -650, 9134, 9134, 9134, 9134, -12442, -12442, -12442, -12442, 16064, 16064, 16064, 16064, 26616, 26616, 26616, 26616, -12796, -12796, -12796, -12796,
+      },
+      {
+        25080, 25080, 25080, 25080, 20710, 20710, 20710, 20710, 20179, 20179, 20179, 20179, -23565, -23565, -23565, -23565, 30967, 30967, 30967, 30967, 1496, 1496, 1496, 1496, -6516, -6516, -6516, -6516, -5689, -5689, -5689, -5689,
+      },
+    },
+    {
+      {
+        23132, 23132, -17422, -17422, 7756, 7756, 23998, 23998, -20257, -20257, 28644, 28644, -23860, -23860, 31636, 31636, -17442, -17442, 10906, 10906, 23210, 23210, -22502, -22502, -20198, -20198, -7934, -7934, -21498, -21498, 10335, 10335,
+      },
+      {
+        14469, 14469, 16989, 16989, -11044, -11044, 24214, 24214, -14903, -14903, 10946, 10946, -6280, -6280, -20927, -20927, -32384, -32384, 24391, 24391, 15355, 15355, -7382, -7382, 2146, 2146, 25435, 25435, 20297, 20297, -31183, -31183,
+      },
+      {
+        -12619, -12619, -5276, -5276, 19529, 19529, -14430, -14430, 18525, 18525, 17560, 17560, 20100, 20100, -18486, -18486, 12639, 12639, -28762, -28762, -18741, -18741, 29175, 29175, 30317, 30317, 10631, 10631, -32502, -32502, 32010, 32010,
+      },
+      {
+        5493, 5493, 6182, 6182, 23092, 23092, -14883, -14883, -4587, -4587, 945, 945, 13131, 13131, -27738, -27738, -21655, -21655, 20494, 20494, -14233, -14233, -32227, -32227, 13387, 13387, -11477, -11477, 11182, 11182, -335, -335,
+      },
+    },
+  },
+};
+
+// AVX-512 base case multiply factors, MUL_LUT[i] in lane 2i + 1 (used
+// by poly_mul_avx512())
+static const int16_t MUL_AVX512_ZETAS[256] = {
+  0, -1103, 0, 1103, 0, 430, 0, -430, 0, 555, 0, -555, 0, 843, 0, -843, 0, -1251, 0, 1251, 0, 871, 0, -871, 0, 1550, 0, -1550, 0, 105, 0, -105,
+  0, 422, 0, -422, 0, 587, 0, -587, 0, 177, 0, -177, 0, -235, 0, 235, 0, -291, 0, 291, 0, -460, 0, 460, 0, 1574, 0, -1574, 0, 1653, 0, -1653,
+  0, -246, 0, 246, 0, 778, 0, -778, 0, 1159, 0, -1159, 0, -147, 0, 147, 0, -777, 0, 777, 0, 1483, 0, -1483, 0, -602, 0, 602, 0, 1119, 0, -1119,
+  0, -1590, 0, 1590, 0, 644, 0, -644, 0, -872, 0, 872, 0, 349, 0, -349, 0, 418, 0, -418, 0, 329, 0, -329, 0, -156, 0, 156, 0, -75, 0, 75,
+  0, 817, 0, -817, 0, 1097, 0, -1097, 0, 603, 0, -603, 0, 610, 0, -610, 0, 1322, 0, -1322, 0, -1285, 0, 1285, 0, -1465, 0, 1465, 0, 384, 0, -384,
+  0, -1215, 0, 1215, 0, -136, 0, 136, 0, 1218, 0, -1218, 0, -1335, 0, 1335, 0, -874, 0, 874, 0, 220, 0, -220, 0, -1187, 0, 1187, 0, -1659, 0, 1659,
+  0, -1185, 0, 1185, 0, -1530, 0, 1530, 0, -1278, 0, 1278, 0, 794, 0, -794, 0, -1510, 0, 1510, 0, -854, 0, 854, 0, -870, 0, 870, 0, 478, 0, -478,
+  0, -108, 0, 108, 0, -308, 0, 308, 0, 996, 0, -996, 0, 991, 0, -991, 0, 958, 0, -958, 0, -1460, 0, 1460, 0, 1522, 0, -1522, 0, 1628, 0, -1628,
+};
+#endif /* FIPS203IPD_AVX512 */
+
+#ifdef FIPS203IPD_AVX512VBMI
+// AVX-512 VBMI packing byte permutations ([11, 10, 5, 4 bits][even,
+// odd 64-bit lanes][byte], used by poly_encode_bits_vbmi())
+static const uint8_t PACK_VBMI_IDX[4][2][64] = {
+  {
+    { 0, 1, 2, 3, 4, 5, 64, 64, 64, 64, 64, 16, 17, 18, 19, 20, 21, 64, 64, 64, 64, 64, 32, 33, 34, 35, 36, 37, 64, 64, 64, 64, 64, 48, 49, 50, 51, 52, 53, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+    { 64, 64, 64, 64, 64, 8, 9, 10, 11, 12, 13, 64, 64, 64, 64, 64, 24, 25, 26, 27, 28, 29, 64, 64, 64, 64, 64, 40, 41, 42, 43, 44, 45, 64, 64, 64, 64, 64, 56, 57, 58, 59, 60, 61, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+  },
+  {
+    { 0, 1, 2, 3, 4, 64, 64, 64, 64, 64, 16, 17, 18, 19, 20, 64, 64, 64, 64, 64, 32, 33, 34, 35, 36, 64, 64, 64, 64, 64, 48, 49, 50, 51, 52, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+    { 64, 64, 64, 64, 64, 8, 9, 10, 11, 12, 64, 64, 64, 64, 64, 24, 25, 26, 27, 28, 64, 64, 64, 64, 64, 40, 41, 42, 43, 44, 64, 64, 64, 64, 64, 56, 57, 58, 59, 60, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+  },
+  {
+    { 0, 1, 2, 64, 64, 16, 17, 18, 64, 64, 32, 33, 34, 64, 64, 48, 49, 50, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+    { 64, 64, 8, 9, 10, 64, 64, 24, 25, 26, 64, 64, 40, 41, 42, 64, 64, 56, 57, 58, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+  },
+  {
+    { 0, 1, 64, 64, 16, 17, 64, 64, 32, 33, 64, 64, 48, 49, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+    { 64, 64, 8, 9, 64, 64, 24, 25, 64, 64, 40, 41, 64, 64, 56, 57, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 },
+  },
+};
+
+// AVX-512 VBMI unpacking byte permutations ([11, 10, 5, 4 bits][byte],
+// used by poly_decode_bits_vbmi())
+static const uint8_t UNPACK_VBMI_IDX[4][64] = {
+  { 0, 1, 2, 3, 4, 5, 6, 7, 5, 6, 7, 8, 9, 10, 11, 12, 11, 12, 13, 14, 15, 16, 17, 18, 16, 17, 18, 19, 20, 21, 22, 23, 22, 23, 24, 25, 26, 27, 28, 29, 27, 28, 29, 30, 31, 32, 33, 34, 33, 34, 35, 36, 37, 38, 39, 40, 38, 39, 40, 41, 42, 43, 44, 45 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 5, 6, 7, 8, 9, 10, 11, 12, 10, 11, 12, 13, 14, 15, 16, 17, 15, 16, 17, 18, 19, 20, 21, 22, 20, 21, 22, 23, 24, 25, 26, 27, 25, 26, 27, 28, 29, 30, 31, 32, 30, 31, 32, 33, 34, 35, 36, 37, 35, 36, 37, 38, 39, 40, 41, 42 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 2, 3, 4, 5, 6, 7, 8, 9, 5, 6, 7, 8, 9, 10, 11, 12, 7, 8, 9, 10, 11, 12, 13, 14, 10, 11, 12, 13, 14, 15, 16, 17, 12, 13, 14, 15, 16, 17, 18, 19, 15, 16, 17, 18, 19, 20, 21, 22, 17, 18, 19, 20, 21, 22, 23, 24 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 2, 3, 4, 5, 6, 7, 8, 9, 4, 5, 6, 7, 8, 9, 10, 11, 6, 7, 8, 9, 10, 11, 12, 13, 8, 9, 10, 11, 12, 13, 14, 15, 10, 11, 12, 13, 14, 15, 16, 17, 12, 13, 14, 15, 16, 17, 18, 19, 14, 15, 16, 17, 18, 19, 20, 21 },
+};
+
+// AVX-512 VBMI unpacking bit-field offsets for vpmultishiftqb
+// ([11, 10, 5, 4 bits][byte], used by poly_decode_bits_vbmi())
+static const uint8_t UNPACK_VBMI_SHIFTS[4][64] = {
+  { 60, 4, 7, 15, 18, 26, 29, 37, 0, 8, 11, 19, 22, 30, 33, 41, 60, 4, 7, 15, 18, 26, 29, 37, 0, 8, 11, 19, 22, 30, 33, 41, 60, 4, 7, 15, 18, 26, 29, 37, 0, 8, 11, 19, 22, 30, 33, 41, 60, 4, 7, 15, 18, 26, 29, 37, 0, 8, 11, 19, 22, 30, 33, 41 },
+  { 59, 3, 5, 13, 15, 23, 25, 33, 59, 3, 5, 13, 15, 23, 25, 33, 59, 3, 5, 13, 15, 23, 25, 33, 59, 3, 5, 13, 15, 23, 25, 33, 59, 3, 5, 13, 15, 23, 25, 33, 59, 3, 5, 13, 15, 23, 25, 33, 59, 3, 5, 13, 15, 23, 25, 33, 59, 3, 5, 13, 15, 23, 25, 33 },
+  { 54, 62, 59, 3, 0, 8, 5, 13, 58, 2, 63, 7, 4, 12, 9, 17, 54, 62, 59, 3, 0, 8, 5, 13, 58, 2, 63, 7, 4, 12, 9, 17, 54, 62, 59, 3, 0, 8, 5, 13, 58, 2, 63, 7, 4, 12, 9, 17, 54, 62, 59, 3, 0, 8, 5, 13, 58, 2, 63, 7, 4, 12, 9, 17 },
+  { 53, 61, 57, 1, 61, 5, 1, 9, 53, 61, 57, 1, 61, 5, 1, 9, 53, 61, 57, 1, 61, 5, 1, 9, 53, 61, 57, 1, 61, 5, 1, 9, 53, 61, 57, 1, 61, 5, 1, 9, 53, 61, 57, 1, 61, 5, 1, 9, 53, 61, 57, 1, 61, 5, 1, 9, 53, 61, 57, 1, 61, 5, 1, 9 },
 };
+#endif /* FIPS203IPD_AVX512VBMI */
 
 /**
  * Initialize SHAKE128 extendable output function (XOF) by absorbing
@@ -345,8 +1343,8 @@ static inline void xof_init(sha3_xof_t * const xof, const uint8_t r[static 32],
  * absorbing 32-byte `seed` and byte `b`, then read `len` bytes of data
  * from the PRF into the buffer pointed to by `out`.
  *
- * Used by `poly_sample_cbdN()` functions to sample polynomail
- * coefficients.
+ * Used by `poly_sample_cbdN()` functions and `prfs()` to sample
+ * polynomial coefficients.
  *
  * @param[in] seed 32 bytes.
  * @param[in] b 1 byte.
@@ -409,8 +1407,8 @@ static inline void ct_copy(uint8_t c[static 32], const bool sel, const uint8_t a
  * @return Value reduced modulo Q.
  */
 static inline uint16_t ct_mod_q(const uint64_t v) {
-  // exponent (note: 24 bits are sufficient everywhere except
-  // poly_mul(), which requires 36 bits)
+  // exponent (note: 24 bits are sufficient for every caller; 36 bits
+  // keep the reduction exact for any input below 2^36)
   static const uint8_t E = 36;
   static const uint64_t M = (1ULL << E) / Q; // multiplier
   const uint16_t r = v - ((v * M) >> E) * Q; // barret reduction
@@ -418,194 +1416,3452 @@ static inline uint16_t ct_mod_q(const uint64_t v) {
   return r - (Q & mask); // constant-time adjustment
 }
 
-// Polynomial with 256 12-bit coefficients.
-typedef struct {
-  uint16_t cs[256]; // coefficients
-} poly_t;
+// Q^-1 mod 2^16, as a signed 16-bit value (used by mont_reduce()).
+#define QINV -3327
+
+// 128^-1 mod Q (3303) in Montgomery form (3303 * 2^16 mod Q); scales
+// the output of the inverse NTT.
+#define INV_NTT_SCALE 512
+
+// Product of the last inverse NTT twiddle factor (`NTT_LUT[1]`) and
+// `INV_NTT_SCALE`, in centered Montgomery form (1729 * 3303 * 2^16 mod
+// Q).  Folds the 128^-1 scale into the `len = 128` layer of the
+// inverse NTT.
+#define INV_NTT_SCALE_ZETA -266
+
+// 2^32 mod Q; Montgomery multiplying by this value converts a
+// coefficient to Montgomery form (used by poly_tomont()).
+#define MONT_R2 1353
 
 /**
- * Initialize polynomial `a` by sampling coefficients in the NTT domain
- * from SHAKE128 extendable output function (XOF) seeded by 32-byte
- * value `rho`, byte `i`, and byte `j`.
+ * Montgomery reduction: compute `a * 2^-16 mod Q` without a division.
  *
- * @param[out] a Output polynomial with coefficients in the NTT domain.
- * @param[in] rho 32-byte input value used as XOF seed.
- * @param[in] i One byte input value used as XOF seed.
- * @param[in] j One byte input value used as XOF seed.
+ * `t = a * Q^-1 mod 2^16` is chosen so that the low 16 bits of
+ * `a - t * Q` are zero; the high 16 bits are the result.
+ *
+ * @param[in] a Input value in the range (-Q * 2^15, Q * 2^15).
+ * @return Value congruent to `a * 2^-16` in the range (-Q, Q).
  */
-static inline void poly_sample_ntt(poly_t * const a, const uint8_t rho[static 32], const uint8_t i, const uint8_t j) {
-  // init xof by absorbing rho, i, and j
-  sha3_xof_t xof = { 0 };
-  xof_init(&xof, rho, i, j);
+static inline int16_t mont_reduce(const int32_t a) {
+  const int16_t t = (int16_t) a * QINV;
+  return (a - (int32_t) t * Q) >> 16;
+}
 
-  for (size_t i = 0; i < 256;) {
-    // read 3 bytes from xof
-    uint8_t ds[3] = { 0 };
-    shake128_xof_squeeze(&xof, ds, 3);
+/**
+ * Montgomery multiply: compute `a * b * 2^-16 mod Q`.  If `b` is in
+ * Montgomery form (`b = z * 2^16 mod Q`), then this is `a * z mod Q`.
+ *
+ * @param[in] a Input value.
+ * @param[in] b Input value.
+ * @return Value congruent to `a * b * 2^-16` in the range (-Q, Q).
+ */
+static inline int16_t mont_mul(const int16_t a, const int16_t b) {
+  return mont_reduce((int32_t) a * b);
+}
 
-    // split 3 bytes into two 12-bit samples
-    const uint16_t d1 = ((uint16_t) ds[0]) | (((uint16_t) (ds[1] & 0xF)) << 8),
-                   d2 = ((uint16_t) ds[1] >> 4) | (((uint16_t) ds[2]) << 4);
+/**
+ * Constant-time conditional add of Q: map `x` in the range (-Q, Q) to
+ * the range [0, Q).
+ *
+ * @param[in] x Input value in the range (-Q, Q).
+ * @return Value congruent to `x` in the range [0, Q).
+ */
+static inline int16_t ct_add_q(const int16_t x) {
+  return x + ((x >> 15) & Q);
+}
 
-    // sample d1
-    if (d1 < Q) {
-      a->cs[i++] = d1;
-    }
+// Barrett multiplier, round(2^26 / Q) (used by barrett_reduce()).
+#define BARRETT_V 20159
 
-    // sample d2
-    if (d2 < Q && i < 256) {
-      a->cs[i++] = d2;
-    }
-  }
+/**
+ * Barrett reduction: compute the centered representative of `x`
+ * modulo Q.
+ *
+ * `round(x * BARRETT_V / 2^26)` is `round(x / Q)` for every 16-bit
+ * `x`, so `x - round(x / Q) * Q` is in the range
+ * [-(Q - 1) / 2, (Q - 1) / 2].
+ *
+ * @param[in] x Input value (any signed 16-bit value).
+ * @return Value congruent to `x` in the range [-(Q - 1) / 2, (Q - 1) / 2].
+ */
+static inline int16_t barrett_reduce(const int16_t x) {
+  const int16_t t = ((int32_t) BARRETT_V * x + (1 << 25)) >> 26;
+  return x - t * Q;
 }
 
+// Multiplier used by ct_compress() to divide by Q (ceil(2^35 / Q)).
+#define COMPRESS_M 10321340
+
 /**
- * Define function which reads `64 * ETA` bytes from a pseudo-random
- * function (PRF) seeded by 32-byte value `seed` and one byte value `b`,
- * then samples values from the PRF output using the centered binomial
- * distribution (CBD) with error `ETA` and writes the values as the
- * coefficients of output polynomial `p`.
+ * Compress coefficient `x` to `d` bits by computing
+ * `round((2^d / Q) * x) mod 2^d` without a division.
  *
- * @param[out] p Output polynomial with CBD(ETA) distributed coefficients.
- * @param[in] seed 32-byte input value used as PRF seed.
- * @param[in] b 1 byte input value used as PRF seed.
+ * The rounded quotient is `floor((x * 2^d + (Q - 1) / 2) / Q)`.  The
+ * division by Q is replaced by a multiply by `COMPRESS_M` and a 35-bit
+ * shift, which is exact for all numerators below 2^23 (e.g., every
+ * 12-bit `x` and every `d` <= 11).  Constant-time because the sequence
+ * of operations does not depend on `x`.
+ *
+ * @param[in] x Input coefficient (12 bits).
+ * @param[in] d Number of bits in compressed value (1-11).
+ * @return Compressed value (`d` bits).
  */
-#define DEF_POLY_SAMPLE_CBD(ETA) \
-  static inline void poly_sample_cbd ## ETA (poly_t * const p, const uint8_t seed[32], const uint8_t b) { \
-    /* read 64 * eta bytes of data from prf */ \
-    uint8_t buf[64 * ETA] = { 0 }; \
-    prf(seed, b, buf, sizeof(buf)); \
-    \
-    for (size_t i = 0; i < 256; i++) { \
-      uint16_t x = 0; \
-      for (size_t j = 0; j < ETA; j++) { \
-        const size_t ofs = 2 * i * ETA + j; \
-        x += (buf[ofs / 8] >> (ofs % 8)) & 0x01; \
-      } \
-      \
-      uint16_t y = 0; \
-      for (size_t j = 0; j < ETA; j++) { \
-        const size_t ofs = 2 * i * ETA + ETA + j; \
-        y += (buf[ofs / 8] >> (ofs % 8)) & 0x01; \
-      } \
-      \
-      p->cs[i] = ct_mod_q(x + (Q - y)); /* (x - y) % Q */ \
-    } \
-  }
+static inline uint16_t ct_compress(const uint16_t x, const uint8_t d) {
+  const uint64_t n = ((uint32_t) x << d) + (Q - 1) / 2; // numerator
+  return ((n * COMPRESS_M) >> 35) & ((1U << d) - 1);
+}
 
-// define poly_sample_cbd3() (PKE512_ETA1)
-DEF_POLY_SAMPLE_CBD(3)
+/**
+ * Decompress `d`-bit value `x` to a coefficient modulo Q by computing
+ * `round((Q / 2^d) * x)` with a multiply, add, and shift.
+ *
+ * Used by `poly_decode_{11,10,5,4}bit()`.  Constant-time because the
+ * sequence of operations does not depend on `x`.
+ *
+ * @param[in] x Compressed value (`d` bits).
+ * @param[in] d Number of bits in compressed value (1-11).
+ * @return Decompressed coefficient in the range [0, Q).
+ */
+static inline uint16_t ct_decompress(const uint16_t x, const uint8_t d) {
+  return ((uint32_t) x * Q + (1U << (d - 1))) >> d;
+}
 
-// define poly_sample_cbd2() (PKE512_ETA2, PKE768_ETA{1,2}, PKE1024_ETA{1,2}
-DEF_POLY_SAMPLE_CBD(2)
+// SHAKE128 rate, in bytes.
+#define SHAKE128_RATE 168
+
+// Number of SHAKE128 blocks squeezed up front by poly_sample_ntt().
+//
+// 3 blocks (504 bytes) yield 336 12-bit candidates, of which 273 are
+// accepted on average, so more than 256 coefficients are almost
+// always available without squeezing again.
+#define SAMPLE_NTT_INIT_BLOCKS 3
+
+// Number of matrix entries which mat_sample_ntt() samples, and number
+// of PRFs which prfs() reads, at once (1, 4, or 8).  Set at build time
+// with -DFIPS203IPD_XOF_WAYS=N.  1 uses the single-state SHAKE128 and
+// SHAKE256 XOFs, 4 and 8 use the 4-way and 8-way multi-buffer XOFs from
+// sha3.c.  Defaults to 8 when the AVX-512 kernels are compiled in and 4
+// otherwise; 8-way passes are only used when sha3.c has selected its
+// AVX-512 permutations at runtime (see prfs_x8_min()).
+#ifndef FIPS203IPD_XOF_WAYS
+#ifdef FIPS203IPD_AVX512
+#define FIPS203IPD_XOF_WAYS 8
+#else
+#define FIPS203IPD_XOF_WAYS 4
+#endif /* FIPS203IPD_AVX512 */
+#endif /* FIPS203IPD_XOF_WAYS */
+
+// Polynomial with 256 12-bit coefficients.
+//
+// Coefficients are signed so the NTT, inverse NTT, and base case
+// multiply can use Montgomery arithmetic.  NTT-domain operands which
+// are decoded or sampled rather than computed (the matrix A, t, and s)
+// are converted to Montgomery form with poly_tomont() so that the
+// Montgomery factor 2^-16 of poly_mul() cancels out.
+//
+// Coefficients are reduced lazily: they are only reduced when the next
+// operation would run out of 16-bit headroom (|x| < 2^15, about 9.8Q),
+// and once before they are encoded.  Bounds on |x| (Montgomery
+// reduction needs an input below Q * 2^15, and NTT twiddle factors are
+// at most (Q - 1) / 2):
+//
+//   value                       | bound        | reason
+//   ----------------------------+--------------+------------------------
+//   decoded, sampled            | [0, Q)       | canonical
+//   CBD(eta) sampled            | <= eta       | x - y, centered
+//   poly_tomont() output        | < Q          | mont_reduce()
+//   poly_ntt() input            | < Q          |
+//   poly_ntt() after layer l    | < (l + 1)Q   | adds z * b, |z * b| < Q
+//   poly_ntt() output           | <= Q/2       | barrett_reduce() (< 8Q)
+//   poly_mul() inputs           | < Q          | |a0 * b0 + a1 * b1 * z| < 1.5Q^2
+//   poly_mul() output           | < 2Q         | sum of 2 mont_reduce()
+//   poly_basemul_acc() inputs   | < Q          | n <= 4 terms below 2Q^2
+//   poly_basemul_acc() output   | < Q          | one mont_reduce() (< 8Q^2)
+//   poly_inv_ntt() input        | < Q          |
+//   poly_inv_ntt() after l = 3  | < 8Q         | a + b doubles, z * (b - a) < Q
+//   ... after poly_reduce()     | <= Q/2       | barrett_reduce()
+//   poly_inv_ntt() after l = 6  | < 4Q         | a + b doubles 3 more times
+//   poly_inv_ntt() output       | < Q          | l = 7 scaled, mont_mul() (< 8Q)
+//   poly_add(), poly_sub()      | sum of input bounds (no reduction)
+//   t = A * s + e (keygen)      | < 3Q/2       | Q + Q/2
+//   u + e1, v + e2 + mu (enc)   | < 3Q         | Q + Q + Q
+//   v - s * u (dec)             | < 2Q         | Q + Q
+//   poly_encode*() input        | [0, Q)       | poly_normalize()
+//
+// Define FIPS203IPD_CHECK_BOUNDS to check these bounds at runtime with
+// assert() (enabled in test builds).
+typedef struct {
+  int16_t cs[256]; // coefficients
+} poly_t;
+
+#if defined(TEST_FIPS203IPD) && !defined(FIPS203IPD_CHECK_BOUNDS)
+#define FIPS203IPD_CHECK_BOUNDS
+#endif /* TEST_FIPS203IPD && !FIPS203IPD_CHECK_BOUNDS */
+
+#ifdef FIPS203IPD_CHECK_BOUNDS
+#include <assert.h> // assert()
 
 /**
- * Compute in-place number-theoretic transform (NTT) of polynomial `p`.
+ * Check that every coefficient of polynomial `p` is in the range
+ * [lo, hi).  Only used when FIPS203IPD_CHECK_BOUNDS is defined.
  *
- * @param[in,out] p Polynomial.
+ * @param[in] p Polynomial.
+ * @param[in] lo Inclusive lower bound.
+ * @param[in] hi Exclusive upper bound.
  */
-static inline void poly_ntt(poly_t * const p) {
-  uint8_t k = 1;
-  for (uint16_t len = 128; len >= 2; len /= 2) {
-    for (uint16_t start = 0; start < 256; start += 2 * len) {
-      const uint16_t zeta = NTT_LUT[k++];
-
-      for (uint16_t j = start; j < start + len; j++) {
-        const uint16_t t = ct_mod_q(zeta * p->cs[j + len]);
-        p->cs[j + len] = ct_mod_q(p->cs[j] + (Q - t)); // (p[j] - t) % Q
-        p->cs[j] = ct_mod_q(p->cs[j] + t);
-      }
+static inline void poly_check_range(const poly_t * const p, const int32_t lo, const int32_t hi) {
+  for (size_t i = 0; i < 256; i++) {
+    if (p->cs[i] < lo || p->cs[i] >= hi) {
+      assert(!"coefficient out of range");
     }
   }
 }
 
+// check that |x| < bound for every coefficient of `p`
+#define POLY_CHECK_BOUND(p, bound) poly_check_range((p), 1 - (bound), (bound))
+
+// check that every coefficient of `p` is in the range [0, Q)
+#define POLY_CHECK_CANONICAL(p) poly_check_range((p), 0, Q)
+
+// check that every coefficient of `p` fits in 12 bits
+#define POLY_CHECK_12BIT(p) poly_check_range((p), 0, 1 << 12)
+#else
+#define POLY_CHECK_BOUND(p, bound) ((void) 0)
+#define POLY_CHECK_CANONICAL(p) ((void) 0)
+#define POLY_CHECK_12BIT(p) ((void) 0)
+#endif /* FIPS203IPD_CHECK_BOUNDS */
+
+// Base case multiply cache ("mulcache") for an NTT-domain polynomial
+// `b` which is the right-hand operand of several products: the
+// coefficients of `b`, with each odd coefficient `b1` of a degree-one
+// pair premultiplied by its base case multiply factor (`b1 * zeta`).
+// Computed once with poly_mulcache_compute() and passed to
+// poly_basemul_acc() along with `b`.  Coefficients satisfy |x| < Q.
+typedef struct {
+  int16_t cs[256]; // b0, b1 * zeta pairs
+} poly_mulcache_t;
+
 /**
- * Compute in-place inverse number-theoretic transform (NTT) of
- * polynomial `p`.
+ * Convert polynomial `p` to Montgomery form by multiplying each
+ * coefficient by 2^16 mod Q.
  *
  * @param[in,out] p Polynomial.
  */
-static inline void poly_inv_ntt(poly_t * const p) {
-  uint8_t k = 127;
-  for (uint16_t len = 2; len <= 128; len *= 2) {
-    for (uint16_t start = 0; start < 256; start += 2 * len) {
-      const uint16_t zeta = NTT_LUT[k--];
+static inline void poly_tomont(poly_t * const p) {
+  for (size_t i = 0; i < 256; i++) {
+    p->cs[i] = mont_mul(p->cs[i], MONT_R2);
+  }
+}
 
-      for (uint16_t j = start; j < start + len; j++) {
-        const uint16_t t = p->cs[j];
-        p->cs[j] = ct_mod_q(t + p->cs[j + len]); // (t + p[j + len]) % Q
-        p->cs[j + len] = ct_mod_q(zeta * ((p->cs[j + len] + (Q - t))));
-      }
-    }
+/**
+ * Reduce coefficients of polynomial `p` to their centered
+ * representatives, in the range [-(Q - 1) / 2, (Q - 1) / 2].
+ *
+ * @param[in,out] p Polynomial.
+ */
+static inline void poly_reduce(poly_t * const p) {
+  for (size_t i = 0; i < 256; i++) {
+    p->cs[i] = barrett_reduce(p->cs[i]);
   }
+}
+
+/**
+ * Reduce coefficients of polynomial `p` to the range [0, Q).  Called
+ * before coefficients are encoded or compressed.
+ *
+ * @param[in,out] p Polynomial.
+ */
+static inline void poly_normalize(poly_t * const p) {
+  for (size_t i = 0; i < 256; i++) {
+    p->cs[i] = ct_add_q(barrett_reduce(p->cs[i]));
+  }
+}
+
+/**
+ * Parse `len` bytes of SHAKE128 output in `buf` as 12-bit candidates
+ * and append the candidates which are less than Q to polynomial `a`,
+ * starting at coefficient `n`.  Stops once `a` has 256 coefficients
+ * (reference C implementation).
+ *
+ * @param[out] a Output polynomial.
+ * @param[in] n Number of coefficients already sampled.
+ * @param[in] buf XOF output.
+ * @param[in] len Length of XOF output, in bytes (multiple of 3).
+ * @return Number of coefficients sampled.
+ */
+static inline size_t poly_sample_ntt_parse_scalar(poly_t * const a, size_t n, const uint8_t * const buf, const size_t len) {
+  for (size_t ofs = 0; ofs < len && n < 256; ofs += 3) {
+    // read 3 bytes from buffer
+    const uint8_t * const ds = buf + ofs;
+
+    // split 3 bytes into two 12-bit samples
+    const uint16_t d1 = ((uint16_t) ds[0]) | (((uint16_t) (ds[1] & 0xF)) << 8),
+                   d2 = ((uint16_t) ds[1] >> 4) | (((uint16_t) ds[2]) << 4);
+
+    // sample d1
+    if (d1 < Q) {
+      a->cs[n++] = d1;
+    }
+
+    // sample d2
+    if (d2 < Q && n < 256) {
+      a->cs[n++] = d2;
+    }
+  }
+
+  // return number of sampled coefficients
+  return n;
+}
+
+/**
+ * Compute in-place number-theoretic transform (NTT) of polynomial `p`
+ * (reference C implementation).
+ *
+ * @param[in,out] p Polynomial.
+ */
+static inline void poly_ntt_scalar(poly_t * const p) {
+  uint8_t k = 1;
+  for (uint16_t len = 128; len >= 2; len /= 2) {
+    for (uint16_t start = 0; start < 256; start += 2 * len) {
+      const int16_t zeta = NTT_LUT[k++];
+
+      for (uint16_t j = start; j < start + len; j++) {
+        const int16_t t = mont_mul(p->cs[j + len], zeta);
+        p->cs[j + len] = p->cs[j] - t;
+        p->cs[j] = p->cs[j] + t;
+      }
+    }
+  }
+
+  // |x| < 8Q after 7 layers
+  poly_reduce(p);
+}
+
+/**
+ * Compute in-place inverse number-theoretic transform (NTT) of
+ * polynomial `p` (reference C implementation).
+ *
+ * @param[in,out] p Polynomial.
+ */
+static inline void poly_inv_ntt_scalar(poly_t * const p) {
+  uint8_t k = 127;
+  for (uint16_t len = 2; len <= 64; len *= 2) {
+    for (uint16_t start = 0; start < 256; start += 2 * len) {
+      const int16_t zeta = NTT_LUT[k--];
+
+      for (uint16_t j = start; j < start + len; j++) {
+        const int16_t t = p->cs[j];
+        p->cs[j] = t + p->cs[j + len];
+        p->cs[j + len] = mont_mul(p->cs[j + len] - t, zeta);
+      }
+    }
+
+    if (len == 8) {
+      // |x| < 8Q after 3 layers
+      poly_reduce(p);
+    }
+  }
+
+  // layer with len = 128, scaled by 128^-1 mod Q
+  for (size_t j = 0; j < 128; j++) {
+    const int16_t t = p->cs[j];
+    p->cs[j] = mont_mul(t + p->cs[j + 128], INV_NTT_SCALE);
+    p->cs[j + 128] = mont_mul(p->cs[j + 128] - t, INV_NTT_SCALE_ZETA);
+  }
+}
+
+#ifdef FIPS203IPD_VEC
+// 8 signed 16-bit lanes (portable vector kernels)
+typedef int16_t vec_i16 __attribute__((vector_size(16)));
+
+// 8 unsigned 16-bit lanes (wrapping arithmetic)
+typedef uint16_t vec_u16 __attribute__((vector_size(16)));
+
+// Select lanes from vectors `a` and `b` by index: indices 0-7 select
+// lanes of `a` and indices 8-15 select lanes of `b`.
+#ifdef __clang__
+#define VEC_SHUFFLE(a, b, ...) __builtin_shufflevector((a), (b), __VA_ARGS__)
+#else
+#define VEC_SHUFFLE(a, b, ...) __builtin_shuffle((a), (b), (vec_i16) { __VA_ARGS__ })
+#endif /* __clang__ */
+
+/**
+ * Load 8 coefficients from (possibly unaligned) `p`.
+ */
+static inline vec_i16 vec_load(const int16_t * const p) {
+  vec_i16 x;
+  memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+/**
+ * Store 8 coefficients to (possibly unaligned) `p`.
+ */
+static inline void vec_store(int16_t * const p, const vec_i16 x) {
+  memcpy(p, &x, sizeof(x));
+}
+
+/**
+ * Broadcast `x` to all 8 lanes.
+ */
+static inline vec_i16 vec_set1(const int16_t x) {
+  return (vec_i16) { x, x, x, x, x, x, x, x };
+}
+
+/**
+ * Multiply lanes of `a` and `b` and return the low halves of the
+ * 32-bit products (wrapping, like `_mm256_mullo_epi16()`).
+ */
+static inline vec_i16 vec_mullo(const vec_i16 a, const vec_i16 b) {
+  return (vec_i16) ((vec_u16) a * (vec_u16) b);
+}
+
+/**
+ * Multiply lanes of `a` and `b` and return the high halves of the
+ * 32-bit products (like `_mm256_mulhi_epi16()`).
+ *
+ * There is no vector extension operator for a high multiply, but GCC
+ * and Clang recognize this loop and emit one instruction (e.g.,
+ * `pmulhw` on x86-64).
+ */
+static inline vec_i16 vec_mulhi(const vec_i16 a, const vec_i16 b) {
+  vec_i16 r;
+  for (size_t i = 0; i < 8; i++) {
+    r[i] = ((int32_t) a[i] * b[i]) >> 16;
+  }
+  return r;
+}
+
+/**
+ * Reduce 8 coefficients to their centered representatives; see
+ * `barrett_reduce()`.
+ *
+ * The high half of `x * BARRETT_V` is `x * BARRETT_V / 2^16`, and the
+ * rounding shift divides it by 2^10.
+ *
+ * @param[in] x Coefficients (any signed 16-bit value).
+ * @return Coefficients in the range [-(Q - 1) / 2, (Q - 1) / 2].
+ */
+static inline vec_i16 vec_barrett_reduce(const vec_i16 x) {
+  const vec_i16 t = (vec_mulhi(x, vec_set1(BARRETT_V)) + (1 << 9)) >> 10;
+  return x - t * Q;
+}
+
+/**
+ * Montgomery multiply 8 coefficients `x` by `zs`; see
+ * `avx2_mul_mont()`.
+ *
+ * @param[in] x Coefficients (any signed 16-bit value).
+ * @param[in] zs Factors (signed).
+ * @param[in] zqs `zs * QINV mod 2^16`.
+ * @return Products in the range (-Q, Q).
+ */
+static inline vec_i16 vec_mul_mont(const vec_i16 x, const vec_i16 zs, const vec_i16 zqs) {
+  const vec_i16 t = vec_mullo(x, zqs);
+  return vec_mulhi(x, zs) - vec_mulhi(t, vec_set1(Q));
+}
+
+/**
+ * Compute `zs * QINV mod 2^16` for `vec_mul_mont()`.
+ */
+static inline vec_i16 vec_mont_qinv(const vec_i16 zs) {
+  return vec_mullo(zs, vec_set1(QINV));
+}
+
+/**
+ * Forward NTT butterfly on 8 coefficient pairs; see
+ * `avx2_ntt_butterfly()`.
+ */
+static inline void vec_ntt_butterfly(vec_i16 * const a, vec_i16 * const b, const vec_i16 zs, const vec_i16 zqs) {
+  const vec_i16 t = vec_mul_mont(*b, zs, zqs);
+  *b = *a - t;
+  *a = *a + t;
+}
+
+/**
+ * Inverse NTT butterfly on 8 coefficient pairs; see
+ * `avx2_inv_ntt_butterfly()`.
+ */
+static inline void vec_inv_ntt_butterfly(vec_i16 * const a, vec_i16 * const b, const vec_i16 zs, const vec_i16 zqs) {
+  const vec_i16 t = *a;
+  *a = t + *b;
+  *b = vec_mul_mont(*b - t, zs, zqs);
+}
+
+/**
+ * Rearrange coefficients in vectors `x` and `y` (16 consecutive
+ * coefficients) so that `a` holds the first element and `b` holds the
+ * second element of each butterfly pair with distance `len` (4 or 2).
+ * `vec_merge()` undoes the rearrangement.
+ */
+static inline void vec_split(vec_i16 * const a, vec_i16 * const b, const vec_i16 x, const vec_i16 y, const size_t len) {
+  if (len == 4) {
+    *a = VEC_SHUFFLE(x, y, 0, 1, 2, 3, 8, 9, 10, 11);
+    *b = VEC_SHUFFLE(x, y, 4, 5, 6, 7, 12, 13, 14, 15);
+  } else {
+    *a = VEC_SHUFFLE(x, y, 0, 1, 4, 5, 8, 9, 12, 13);
+    *b = VEC_SHUFFLE(x, y, 2, 3, 6, 7, 10, 11, 14, 15);
+  }
+}
+
+/**
+ * Undo `vec_split()`: rearrange butterfly operands `a` and `b` back to
+ * 16 consecutive coefficients in `x` and `y`.
+ */
+static inline void vec_merge(vec_i16 * const x, vec_i16 * const y, const vec_i16 a, const vec_i16 b, const size_t len) {
+  if (len == 4) {
+    *x = VEC_SHUFFLE(a, b, 0, 1, 2, 3, 8, 9, 10, 11);
+    *y = VEC_SHUFFLE(a, b, 4, 5, 6, 7, 12, 13, 14, 15);
+  } else {
+    *x = VEC_SHUFFLE(a, b, 0, 1, 8, 9, 2, 3, 10, 11);
+    *y = VEC_SHUFFLE(a, b, 4, 5, 12, 13, 6, 7, 14, 15);
+  }
+}
+
+/**
+ * Split 16 consecutive coefficients in `x` and `y` into the even
+ * coefficients `e` and the odd coefficients `o`.
+ */
+static inline void vec_deinterleave(vec_i16 * const e, vec_i16 * const o, const vec_i16 x, const vec_i16 y) {
+  *e = VEC_SHUFFLE(x, y, 0, 2, 4, 6, 8, 10, 12, 14);
+  *o = VEC_SHUFFLE(x, y, 1, 3, 5, 7, 9, 11, 13, 15);
+}
+
+/**
+ * Undo `vec_deinterleave()`.
+ */
+static inline void vec_interleave(vec_i16 * const x, vec_i16 * const y, const vec_i16 e, const vec_i16 o) {
+  *x = VEC_SHUFFLE(e, o, 0, 8, 1, 9, 2, 10, 3, 11);
+  *y = VEC_SHUFFLE(e, o, 4, 12, 5, 13, 6, 14, 7, 15);
+}
+
+/**
+ * Compute in-place number-theoretic transform (NTT) of polynomial `p`
+ * (portable vector implementation).
+ *
+ * Produces output congruent to `poly_ntt_scalar()`, with the same
+ * bounds.  Same structure as `poly_ntt_avx2()`, with 8 coefficients
+ * per vector: layers with `len >= 8` use whole vectors, and layers
+ * with `len < 8` rearrange pairs of vectors with `vec_split()` and
+ * `vec_merge()`.
+ *
+ * @param[in,out] p Polynomial.
+ */
+static void poly_ntt_vec(poly_t * const p) {
+  vec_i16 cs[32];
+  for (size_t i = 0; i < 32; i++) {
+    cs[i] = vec_load(p->cs + 8 * i);
+  }
+
+  size_t k = 1;
+
+  // layers with len = 128, 64, 32, 16, 8 (one twiddle factor per group)
+  for (size_t len = 16; len >= 1; len /= 2) {
+    for (size_t start = 0; start < 32; start += 2 * len) {
+      const vec_i16 zs = vec_set1(NTT_LUT[k]),
+                    zqs = vec_set1(NTT_LUT_QINV[k]);
+      k++;
+
+      for (size_t j = start; j < start + len; j++) {
+        vec_ntt_butterfly(cs + j, cs + j + len, zs, zqs);
+      }
+    }
+  }
+
+  // layers with len = 4, 2 (per-lane twiddle factors)
+  for (size_t l = 0; l < 2; l++) {
+    const size_t len = 4 >> l;
+    for (size_t i = 0; i < 32; i += 2) {
+      const vec_i16 zs = vec_load(NTT_VEC_ZETAS[0][l][i / 2]),
+                    zqs = vec_load(NTT_VEC_ZETAS_QINV[0][l][i / 2]);
+
+      vec_i16 a, b;
+      vec_split(&a, &b, cs[i], cs[i + 1], len);
+      vec_ntt_butterfly(&a, &b, zs, zqs);
+      vec_merge(cs + i, cs + i + 1, a, b, len);
+    }
+  }
+
+  // |x| < 8Q after 7 layers
+  for (size_t i = 0; i < 32; i++) {
+    vec_store(p->cs + 8 * i, vec_barrett_reduce(cs[i]));
+  }
+}
+
+/**
+ * Compute in-place inverse number-theoretic transform (NTT) of
+ * polynomial `p` (portable vector implementation).
+ *
+ * Produces output congruent to `poly_inv_ntt_scalar()`, with the
+ * same bounds.  See `poly_ntt_vec()`.
+ *
+ * @param[in,out] p Polynomial.
+ */
+static void poly_inv_ntt_vec(poly_t * const p) {
+  vec_i16 cs[32];
+  for (size_t i = 0; i < 32; i++) {
+    cs[i] = vec_load(p->cs + 8 * i);
+  }
+
+  // layers with len = 2, 4 (per-lane twiddle factors)
+  for (size_t l = 2; l-- > 0;) {
+    const size_t len = 4 >> l;
+    for (size_t i = 0; i < 32; i += 2) {
+      const vec_i16 zs = vec_load(NTT_VEC_ZETAS[1][l][i / 2]),
+                    zqs = vec_load(NTT_VEC_ZETAS_QINV[1][l][i / 2]);
+
+      vec_i16 a, b;
+      vec_split(&a, &b, cs[i], cs[i + 1], len);
+      vec_inv_ntt_butterfly(&a, &b, zs, zqs);
+      vec_merge(cs + i, cs + i + 1, a, b, len);
+    }
+  }
+
+  // layers with len = 8, 16, 32, 64 (one twiddle factor per group)
+  size_t k = 31;
+  for (size_t len = 1; len <= 8; len *= 2) {
+    for (size_t start = 0; start < 32; start += 2 * len) {
+      const vec_i16 zs = vec_set1(NTT_LUT[k]),
+                    zqs = vec_set1(NTT_LUT_QINV[k]);
+      k--;
+
+      for (size_t j = start; j < start + len; j++) {
+        vec_inv_ntt_butterfly(cs + j, cs + j + len, zs, zqs);
+      }
+    }
+
+    if (len == 1) {
+      // |x| < 8Q after 3 layers
+      for (size_t i = 0; i < 32; i++) {
+        cs[i] = vec_barrett_reduce(cs[i]);
+      }
+    }
+  }
+
+  // layer with len = 128, scaled by 128^-1 mod Q
+  const vec_i16 ss = vec_set1(INV_NTT_SCALE),
+                sqs = vec_mont_qinv(ss),
+                zs = vec_set1(INV_NTT_SCALE_ZETA),
+                zqs = vec_mont_qinv(zs);
+  for (size_t j = 0; j < 16; j++) {
+    const vec_i16 a = cs[j], b = cs[j + 16];
+    vec_store(p->cs + 8 * j, vec_mul_mont(a + b, ss, sqs));
+    vec_store(p->cs + 8 * (j + 16), vec_mul_mont(b - a, zs, zqs));
+  }
+}
+
+/**
+ * Add polynomial `a` to polynomial `b` component-wise, and store the
+ * sum in `a` (portable vector implementation).
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+static void poly_add_vec(poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 8) {
+    vec_store(a->cs + i, vec_load(a->cs + i) + vec_load(b->cs + i));
+  }
+}
+
+/**
+ * Subtract polynomial `b` from polynomial `a` component-wise, and
+ * store the result in `a` (portable vector implementation).
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+static void poly_sub_vec(poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 8) {
+    vec_store(a->cs + i, vec_load(a->cs + i) - vec_load(b->cs + i));
+  }
+}
+
+/**
+ * Multiply `a` and `b` and store the product in `c` (portable vector
+ * implementation).
+ *
+ * Produces output congruent to `poly_mul_scalar()`, with the same
+ * bounds.  The coefficients of 8 degree-one polynomials are split into
+ * even and odd lanes with `vec_deinterleave()`, and each 16-bit
+ * product is Montgomery reduced on its own, so each output coefficient
+ * is the sum of two values in the range (-Q, Q).
+ *
+ * @param[out] c Product polynomial, in the NTT domain.
+ * @param[in] a Input polynomial, in the NTT domain.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+static void poly_mul_vec(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 16) {
+    // base case multiply factors MUL_LUT[i / 2, i / 2 + 7]
+    const vec_i16 zs = vec_load(MUL_LUT + i / 2);
+
+    vec_i16 a0, a1, b0, b1;
+    vec_deinterleave(&a0, &a1, vec_load(a->cs + i), vec_load(a->cs + i + 8));
+    vec_deinterleave(&b0, &b1, vec_load(b->cs + i), vec_load(b->cs + i + 8));
+
+    const vec_i16 b0qs = vec_mont_qinv(b0),
+                  b1qs = vec_mont_qinv(b1),
+                  a1b1 = vec_mul_mont(a1, b1, b1qs),
+                  c0 = vec_mul_mont(a0, b0, b0qs) + vec_mul_mont(a1b1, zs, vec_mont_qinv(zs)),
+                  c1 = vec_mul_mont(a0, b1, b1qs) + vec_mul_mont(a1, b0, b0qs);
+
+    vec_interleave(&a0, &a1, c0, c1);
+    vec_store(c->cs + i, a0);
+    vec_store(c->cs + i + 8, a1);
+  }
+}
+
+/**
+ * Multiply `n` pairs of polynomials `a[i]` and `b[i]`, sum the
+ * products, and store the sum in `c` (portable vector implementation).
+ *
+ * Produces output congruent to `poly_basemul_acc_scalar()`, with the
+ * same bounds.  There is no portable widening multiply-add, so unlike
+ * the AVX2 and AVX-512 kernels each product is Montgomery reduced on
+ * its own (see `poly_mul_vec()`), and the 16-bit sums are Barrett
+ * reduced after the last product.
+ *
+ * @param[out] c Sum of products, in the NTT domain.
+ * @param[in] a Input polynomials, in the NTT domain.
+ * @param[in] b Input polynomials, in the NTT domain.
+ * @param[in] bc Mulcaches of `b` (optional, may be `NULL`).
+ * @param[in] n Number of products (at most 4).
+ */
+static void poly_basemul_acc_vec(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b, const poly_mulcache_t * const restrict bc, const size_t n) {
+  for (size_t i = 0; i < 256; i += 16) {
+    // base case multiply factors MUL_LUT[i / 2, i / 2 + 7]
+    const vec_i16 zs = vec_load(MUL_LUT + i / 2),
+                  zqs = vec_mont_qinv(zs);
+
+    vec_i16 c0 = { 0 }, c1 = { 0 };
+    for (size_t j = 0; j < n; j++) {
+      vec_i16 a0, a1, b0, b1, b1z;
+      vec_deinterleave(&a0, &a1, vec_load(a[j].cs + i), vec_load(a[j].cs + i + 8));
+      vec_deinterleave(&b0, &b1, vec_load(b[j].cs + i), vec_load(b[j].cs + i + 8));
+      if (bc) {
+        // odd lanes of mulcache: b1 * zeta
+        b1z = VEC_SHUFFLE(vec_load(bc[j].cs + i), vec_load(bc[j].cs + i + 8), 1, 3, 5, 7, 9, 11, 13, 15);
+      } else {
+        b1z = vec_mul_mont(b1, zs, zqs);
+      }
+
+      const vec_i16 b0qs = vec_mont_qinv(b0),
+                    b1qs = vec_mont_qinv(b1);
+
+      // each product is in the range (-Q, Q), so 4 terms are below 8Q
+      c0 += vec_mul_mont(a0, b0, b0qs) + vec_mul_mont(a1, b1z, vec_mont_qinv(b1z));
+      c1 += vec_mul_mont(a0, b1, b1qs) + vec_mul_mont(a1, b0, b0qs);
+    }
+
+    vec_i16 x, y;
+    vec_interleave(&x, &y, vec_barrett_reduce(c0), vec_barrett_reduce(c1));
+    vec_store(c->cs + i, x);
+    vec_store(c->cs + i + 8, y);
+  }
+}
+
+/**
+ * Compute mulcache `bc` of polynomial `b` (portable vector
+ * implementation).
+ *
+ * @param[out] bc Mulcache of `b`.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+static void poly_mulcache_compute_vec(poly_mulcache_t * const restrict bc, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 16) {
+    // base case multiply factors MUL_LUT[i / 2, i / 2 + 7]
+    const vec_i16 zs = vec_load(MUL_LUT + i / 2);
+
+    vec_i16 b0, b1;
+    vec_deinterleave(&b0, &b1, vec_load(b->cs + i), vec_load(b->cs + i + 8));
+    vec_interleave(&b0, &b1, b0, vec_mul_mont(b1, zs, vec_mont_qinv(zs)));
+    vec_store(bc->cs + i, b0);
+    vec_store(bc->cs + i + 8, b1);
+  }
+}
+
+/**
+ * Compress coefficients of polynomial `p` to `d` bits and store the
+ * compressed values in `ys` (portable vector implementation).
+ *
+ * Produces the same output as `ct_compress()`, in 16-bit lanes.  The
+ * high half of `(x << 3) * floor(2^(13 + d) / Q)` is the quotient
+ * `(x * 2^d + (Q - 1) / 2) / Q` or one less, so the remainder is in
+ * the range [0, 2Q) and 16-bit wrapping arithmetic computes it
+ * exactly; one compare corrects the quotient.
+ *
+ * @param[out] ys Compressed values (256 elements).
+ * @param[in] p Input polynomial (canonical coefficients).
+ * @param[in] d Number of bits in compressed values (1-11).
+ */
+static void poly_compress_vec(uint16_t ys[static 256], const poly_t * const p, const uint8_t d) {
+  const vec_i16 ms = vec_set1((1 << (13 + d)) / Q);
+  const uint16_t mask = (1U << d) - 1;
+
+  for (size_t i = 0; i < 256; i += 8) {
+    const vec_i16 x = vec_load(p->cs + i),
+                  q = vec_mulhi(x << 3, ms),
+                  r = (vec_i16) (((vec_u16) x << d) + (Q - 1) / 2 - (vec_u16) vec_mullo(q, vec_set1(Q)));
+    const vec_u16 y = (vec_u16) (q - (r >= Q)) & mask; // r >= Q is -1 if true
+
+    memcpy(ys + i, &y, sizeof(y));
+  }
+}
+#endif /* FIPS203IPD_VEC */
+
+#ifdef FIPS203IPD_AVX2
+/**
+ * Reduce 16 coefficients to their centered representatives; see
+ * `barrett_reduce()`.
+ *
+ * The high half of `x * BARRETT_V` is `x * BARRETT_V / 2^16`, and the
+ * rounding multiply by 2^5 divides it by 2^10 with rounding.
+ *
+ * @param[in] x Coefficients (any signed 16-bit value).
+ * @return Coefficients in the range [-(Q - 1) / 2, (Q - 1) / 2].
+ */
+__attribute__((target("avx2")))
+static inline __m256i avx2_barrett_reduce(const __m256i x) {
+  const __m256i t = _mm256_mulhrs_epi16(_mm256_mulhi_epi16(x, _mm256_set1_epi16(BARRETT_V)), _mm256_set1_epi16(1 << 5));
+  return _mm256_sub_epi16(x, _mm256_mullo_epi16(t, _mm256_set1_epi16(Q)));
+}
+
+/**
+ * Montgomery multiply 16 coefficients `x` by constants `zs`; see
+ * `mont_mul()`.
+ *
+ * `zqs` holds `zs * QINV mod 2^16`, so the low half of `x * zqs` is
+ * the Montgomery quotient `t` and the result is the difference of the
+ * high halves of `x * zs` and `t * Q`.
+ *
+ * @param[in] x Coefficients (any signed 16-bit value).
+ * @param[in] zs Constants (signed, Montgomery form).
+ * @param[in] zqs `zs * QINV mod 2^16`.
+ * @return Products in the range (-Q, Q).
+ */
+__attribute__((target("avx2")))
+static inline __m256i avx2_mul_mont(const __m256i x, const __m256i zs, const __m256i zqs) {
+  const __m256i t = _mm256_mullo_epi16(x, zqs);
+  return _mm256_sub_epi16(_mm256_mulhi_epi16(x, zs), _mm256_mulhi_epi16(t, _mm256_set1_epi16(Q)));
+}
+
+/**
+ * Compute `zs * QINV mod 2^16` for `avx2_mul_mont()`.
+ */
+__attribute__((target("avx2")))
+static inline __m256i avx2_mont_qinv(const __m256i zs) {
+  return _mm256_mullo_epi16(zs, _mm256_set1_epi16(QINV));
+}
+
+/**
+ * Forward NTT butterfly on 16 coefficient pairs with twiddle factors
+ * `zs` (see `avx2_mul_mont()` for `zqs`).  Computes `a + z * b` and
+ * `a - z * b` without reduction, like the inner loop of
+ * `poly_ntt_scalar()`.
+ */
+__attribute__((target("avx2")))
+static inline void avx2_ntt_butterfly(__m256i * const a, __m256i * const b, const __m256i zs, const __m256i zqs) {
+  const __m256i t = avx2_mul_mont(*b, zs, zqs);
+  *b = _mm256_sub_epi16(*a, t);
+  *a = _mm256_add_epi16(*a, t);
+}
+
+/**
+ * Inverse NTT butterfly on 16 coefficient pairs with twiddle factors
+ * `zs` (see `avx2_mul_mont()` for `zqs`).  Computes `a + b` (without
+ * reduction) and `z * (b - a)`, like the inner loop of
+ * `poly_inv_ntt_scalar()`.
+ */
+__attribute__((target("avx2")))
+static inline void avx2_inv_ntt_butterfly(__m256i * const a, __m256i * const b, const __m256i zs, const __m256i zqs) {
+  const __m256i t = *a;
+  *a = _mm256_add_epi16(t, *b);
+  *b = avx2_mul_mont(_mm256_sub_epi16(*b, t), zs, zqs);
+}
+
+/**
+ * Rearrange coefficients in vectors `x` and `y` (32 consecutive
+ * coefficients) so that `a` holds the first element and `b` holds the
+ * second element of each butterfly pair with distance `len` (8, 4, or
+ * 2).  `avx2_merge()` undoes the rearrangement.
+ */
+__attribute__((target("avx2")))
+static inline void avx2_split(__m256i * const a, __m256i * const b, const __m256i x, const __m256i y, const size_t len) {
+  switch (len) {
+  case 8:
+    // a = x.lo | y.lo, b = x.hi | y.hi
+    *a = _mm256_permute2x128_si256(x, y, 0x20);
+    *b = _mm256_permute2x128_si256(x, y, 0x31);
+    break;
+  case 4:
+    // a = even 64-bit words, b = odd 64-bit words
+    *a = _mm256_unpacklo_epi64(x, y);
+    *b = _mm256_unpackhi_epi64(x, y);
+    break;
+  default:
+    // a = even 32-bit words, b = odd 32-bit words
+    {
+      const __m256i xs = _mm256_shuffle_epi32(x, 0xd8),
+                    ys = _mm256_shuffle_epi32(y, 0xd8);
+      *a = _mm256_unpacklo_epi64(xs, ys);
+      *b = _mm256_unpackhi_epi64(xs, ys);
+    }
+  }
+}
+
+/**
+ * Undo `avx2_split()`: rearrange butterfly operands `a` and `b` back to
+ * 32 consecutive coefficients in `x` and `y`.
+ */
+__attribute__((target("avx2")))
+static inline void avx2_merge(__m256i * const x, __m256i * const y, const __m256i a, const __m256i b, const size_t len) {
+  switch (len) {
+  case 8:
+    *x = _mm256_permute2x128_si256(a, b, 0x20);
+    *y = _mm256_permute2x128_si256(a, b, 0x31);
+    break;
+  case 4:
+    *x = _mm256_unpacklo_epi64(a, b);
+    *y = _mm256_unpackhi_epi64(a, b);
+    break;
+  default:
+    *x = _mm256_shuffle_epi32(_mm256_unpacklo_epi64(a, b), 0xd8);
+    *y = _mm256_shuffle_epi32(_mm256_unpackhi_epi64(a, b), 0xd8);
+  }
+}
+
+/**
+ * Compute number-theoretic transform (NTT) of the 256 coefficients in
+ * `cs`, 16 coefficients per vector, in registers.
+ *
+ * Shared by `poly_ntt_avx2()` and `poly_decode_ntt_avx2()`.
+ * Vector `i` holds coefficients `16 * i` to `16 * i + 15`, on input
+ * and on return.
+ *
+ * @param[in,out] cs Coefficients (16 vectors).
+ */
+__attribute__((target("avx2")))
+static inline void avx2_ntt(__m256i cs[static 16]) {
+  size_t k = 1;
+
+  // layers with len = 128, 64, 32, 16 (one twiddle factor per group)
+  for (size_t len = 8; len >= 1; len /= 2) {
+    for (size_t start = 0; start < 16; start += 2 * len) {
+      const __m256i zs = _mm256_set1_epi16(NTT_LUT[k]),
+                    zqs = _mm256_set1_epi16(NTT_LUT_QINV[k]);
+      k++;
+
+      for (size_t j = start; j < start + len; j++) {
+        avx2_ntt_butterfly(cs + j, cs + j + len, zs, zqs);
+      }
+    }
+  }
+
+  // layers with len = 8, 4, 2 (per-lane twiddle factors)
+  for (size_t l = 0; l < 3; l++) {
+    const size_t len = 8 >> l;
+    for (size_t i = 0; i < 16; i += 2) {
+      const __m256i zs = _mm256_loadu_si256((void*) NTT_AVX2_ZETAS[0][l][i / 2]),
+                    zqs = _mm256_loadu_si256((void*) NTT_AVX2_ZETAS_QINV[0][l][i / 2]);
+
+      __m256i a, b;
+      avx2_split(&a, &b, cs[i], cs[i + 1], len);
+      avx2_ntt_butterfly(&a, &b, zs, zqs);
+      avx2_merge(cs + i, cs + i + 1, a, b, len);
+    }
+  }
+
+  // |x| < 8Q after 7 layers
+  for (size_t i = 0; i < 16; i++) {
+    cs[i] = avx2_barrett_reduce(cs[i]);
+  }
+}
+
+/**
+ * Compute in-place number-theoretic transform (NTT) of polynomial `p`
+ * (AVX2 implementation).
+ *
+ * Produces output congruent to `poly_ntt_scalar()`, with the same
+ * bounds.  Coefficients are processed 16 at a time, multiplied with
+ * Montgomery multiplication, and reduced lazily (see `poly_t`).  Layers
+ * with `len >= 16` use whole vectors, and layers with `len < 16`
+ * rearrange pairs of vectors with `avx2_split()` and `avx2_merge()`.
+ *
+ * @param[in,out] p Polynomial.
+ */
+__attribute__((target("avx2")))
+static void poly_ntt_avx2(poly_t * const p) {
+  __m256i cs[16];
+  for (size_t i = 0; i < 16; i++) {
+    cs[i] = _mm256_loadu_si256((void*) (p->cs + 16 * i));
+  }
+
+  avx2_ntt(cs);
+
+  for (size_t i = 0; i < 16; i++) {
+    _mm256_storeu_si256((void*) (p->cs + 16 * i), cs[i]);
+  }
+}
+
+/**
+ * Decode packed `d`-bit values from input buffer `b`, decompress them,
+ * and store the NTT of the resulting polynomial in `p` (AVX2
+ * implementation).
+ *
+ * Produces the same output as `poly_decode_ntt()` without storing the
+ * decompressed polynomial: each 128-bit lane of a vector is loaded
+ * from the `d` bytes that hold its 8 values, and the values are
+ * unpacked and decompressed in registers before the first NTT layer.
+ * Unpacking gathers the 4 bytes which hold each pair of values into a
+ * 32-bit lane with `vpshufb`, aligns the pair with `vpsrlvd`, and
+ * splits it into two 16-bit lanes.  Each value `x` is then
+ * decompressed with `vpmulhrsw` as `((x << (15 - d)) * Q + 2^14) >>
+ * 15`, which is exactly `ct_decompress(x, d)`.
+ *
+ * @param[out] p Output polynomial (NTT domain).
+ * @param[in] b Input buffer (`32 * d` bytes).
+ * @param[in] d Number of bits in compressed values (10 or 11).
+ */
+__attribute__((target("avx2")))
+static void poly_decode_ntt_avx2(poly_t * const p, const uint8_t * const b, const uint8_t d) {
+  const __m256i idx = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+                  0, 1, 2, 3,
+                  d / 4, d / 4 + 1, d / 4 + 2, d / 4 + 3,
+                  d / 2, d / 2 + 1, d / 2 + 2, d / 2 + 3,
+                  3 * d / 4, 3 * d / 4 + 1, 3 * d / 4 + 2, 3 * d / 4 + 3
+                )),
+                shifts = _mm256_setr_epi32(0, (2 * d) % 8, (4 * d) % 8, (6 * d) % 8, 0, (2 * d) % 8, (4 * d) % 8, (6 * d) % 8),
+                mask = _mm256_set1_epi32((((1 << d) - 1) << (31 - d)) | (((1 << d) - 1) << (15 - d))),
+                qs = _mm256_set1_epi16(Q);
+
+  __m256i cs[16];
+  for (size_t i = 0; i < 16; i++) {
+    // load the d bytes of each 128-bit lane; the last lane would read
+    // past the end of `b`, so it goes through a temporary buffer
+    const uint8_t * const src = b + 2 * d * i;
+    __m128i hi;
+    if (i < 15) {
+      hi = _mm_loadu_si128((void*) (src + d));
+    } else {
+      uint8_t tail[16] = { 0 };
+      memcpy(tail, src + d, d);
+      hi = _mm_loadu_si128((void*) tail);
+    }
+    const __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((void*) src)), hi, 1);
+
+    // unpack pairs of values into 32-bit lanes, then shift each value
+    // to bit 15 - d of its 16-bit lane
+    const __m256i t = _mm256_srlv_epi32(_mm256_shuffle_epi8(x, idx), shifts),
+                  y = _mm256_and_si256(_mm256_blend_epi16(_mm256_slli_epi32(t, 15 - d), _mm256_slli_epi32(t, 31 - 2 * d), 0xaa), mask);
+
+    cs[i] = _mm256_mulhrs_epi16(y, qs); // decompress
+  }
+
+  avx2_ntt(cs);
+
+  for (size_t i = 0; i < 16; i++) {
+    _mm256_storeu_si256((void*) (p->cs + 16 * i), cs[i]);
+  }
+}
+
+/**
+ * Compute inverse number-theoretic transform (NTT) of the 256
+ * coefficients in `cs`, 16 coefficients per vector, in registers.
+ *
+ * Shared by `poly_inv_ntt_avx2()` and `poly_inv_ntt_encode_avx2()`.
+ * On return vector `i` holds coefficients `16 * i` to `16 * i + 15`,
+ * in the range (-Q, Q).
+ *
+ * @param[in,out] cs Coefficients (16 vectors).
+ */
+__attribute__((target("avx2")))
+static inline void avx2_inv_ntt(__m256i cs[static 16]) {
+  // layers with len = 2, 4, 8 (per-lane twiddle factors)
+  for (size_t l = 3; l-- > 0;) {
+    const size_t len = 8 >> l;
+    for (size_t i = 0; i < 16; i += 2) {
+      const __m256i zs = _mm256_loadu_si256((void*) NTT_AVX2_ZETAS[1][l][i / 2]),
+                    zqs = _mm256_loadu_si256((void*) NTT_AVX2_ZETAS_QINV[1][l][i / 2]);
+
+      __m256i a, b;
+      avx2_split(&a, &b, cs[i], cs[i + 1], len);
+      avx2_inv_ntt_butterfly(&a, &b, zs, zqs);
+      avx2_merge(cs + i, cs + i + 1, a, b, len);
+    }
+  }
+
+  // |x| < 8Q after 3 layers
+  for (size_t i = 0; i < 16; i++) {
+    cs[i] = avx2_barrett_reduce(cs[i]);
+  }
+
+  // layers with len = 16, 32, 64 (one twiddle factor per group)
+  size_t k = 15;
+  for (size_t len = 1; len <= 4; len *= 2) {
+    for (size_t start = 0; start < 16; start += 2 * len) {
+      const __m256i zs = _mm256_set1_epi16(NTT_LUT[k]),
+                    zqs = _mm256_set1_epi16(NTT_LUT_QINV[k]);
+      k--;
+
+      for (size_t j = start; j < start + len; j++) {
+        avx2_inv_ntt_butterfly(cs + j, cs + j + len, zs, zqs);
+      }
+    }
+  }
+
+  // layer with len = 128, scaled by 128^-1 mod Q
+  const __m256i ss = _mm256_set1_epi16(INV_NTT_SCALE),
+                sqs = avx2_mont_qinv(ss),
+                zs = _mm256_set1_epi16(INV_NTT_SCALE_ZETA),
+                zqs = avx2_mont_qinv(zs);
+  for (size_t j = 0; j < 8; j++) {
+    const __m256i a = cs[j], b = cs[j + 8];
+    cs[j] = avx2_mul_mont(_mm256_add_epi16(a, b), ss, sqs);
+    cs[j + 8] = avx2_mul_mont(_mm256_sub_epi16(b, a), zs, zqs);
+  }
+}
+
+/**
+ * Compute in-place inverse number-theoretic transform (NTT) of
+ * polynomial `p` (AVX2 implementation).
+ *
+ * Produces output congruent to `poly_inv_ntt_scalar()`, with the
+ * same bounds.  See
+ * `poly_ntt_avx2()`.
+ *
+ * @param[in,out] p Polynomial.
+ */
+__attribute__((target("avx2")))
+static void poly_inv_ntt_avx2(poly_t * const p) {
+  __m256i cs[16];
+  for (size_t i = 0; i < 16; i++) {
+    cs[i] = _mm256_loadu_si256((void*) (p->cs + 16 * i));
+  }
+
+  avx2_inv_ntt(cs);
+
+  for (size_t i = 0; i < 16; i++) {
+    _mm256_storeu_si256((void*) (p->cs + 16 * i), cs[i]);
+  }
+}
+
+/**
+ * Compute the inverse NTT of polynomial `u`, add polynomial `e`,
+ * compress the sum to `d` bits, and serialize the compressed values as
+ * `32 * d` bytes in output buffer `out` (AVX2 implementation).
+ *
+ * Produces the same output as `poly_inv_ntt_encode()` without storing
+ * the intermediate polynomial: each vector of 16 coefficients from the
+ * final inverse NTT layer is reduced to its centered representatives,
+ * compressed as in `poly_compress_vec()`, and packed while it is still
+ * in a register.
+ * Packing combines pairs of `d`-bit values with `vpmaddwd`, pairs of
+ * 32-bit lanes with variable shifts, and then the two 64-bit lanes of
+ * each 128-bit lane with two byte shuffles, so that each 128-bit lane
+ * yields 8 packed values in its low `d` bytes.
+ *
+ * @param[out] out Output buffer (`32 * d` bytes).
+ * @param[in] u Input polynomial (NTT domain).
+ * @param[in] e Noise polynomial.
+ * @param[in] d Number of bits in compressed values (10 or 11).
+ */
+__attribute__((target("avx2")))
+static void poly_inv_ntt_encode_avx2(uint8_t * const out, const poly_t * const u, const poly_t * const e, const uint8_t d) {
+  __m256i cs[16];
+  for (size_t i = 0; i < 16; i++) {
+    cs[i] = _mm256_loadu_si256((void*) (u->cs + 16 * i));
+  }
+
+  avx2_inv_ntt(cs);
+
+  const __m128i ds = _mm_cvtsi32_si128(d);
+  const __m256i qs = _mm256_set1_epi16(Q),
+                q1s = _mm256_set1_epi16(Q - 1),
+                hs = _mm256_set1_epi16((Q - 1) / 2),
+                ms = _mm256_set1_epi16((1 << (13 + d)) / Q),
+                mask = _mm256_set1_epi16((1 << d) - 1),
+                fs = _mm256_set1_epi32((1 << (16 + d)) | 1), // (1, 2^d)
+                s32 = _mm256_set1_epi64x(32 - 2 * d), // 2d-bit pairs to 64-bit lanes
+                s64 = _mm256_setr_epi64x(0, (4 * d) % 8, 0, (4 * d) % 8),
+                lo = _mm256_setr_epi8(
+                  0, 1, 2, 3, 4, (d == 11) ? 5 : -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                  0, 1, 2, 3, 4, (d == 11) ? 5 : -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+                ),
+                hi = _mm256_setr_epi8(
+                  -1, -1, -1, -1, -1, 8, 9, 10, 11, 12, (d == 11) ? 13 : -1, -1, -1, -1, -1, -1,
+                  -1, -1, -1, -1, -1, 8, 9, 10, 11, 12, (d == 11) ? 13 : -1, -1, -1, -1, -1, -1
+                );
+
+  for (size_t i = 0; i < 16; i++) {
+    // x = u + e, reduced to [-(Q - 1) / 2, (Q - 1) / 2]
+    const __m256i x = avx2_barrett_reduce(_mm256_add_epi16(cs[i], _mm256_loadu_si256((void*) (e->cs + 16 * i))));
+
+    // y = compress(x, d) (see poly_compress_vec()); adding Q to x adds
+    // exactly 2^d to the rounded quotient, so x need not be canonical
+    const __m256i q = _mm256_mulhi_epi16(_mm256_slli_epi16(x, 3), ms),
+                  t = _mm256_sub_epi16(_mm256_add_epi16(_mm256_sll_epi16(x, ds), hs), _mm256_mullo_epi16(q, qs)),
+                  y = _mm256_and_si256(_mm256_sub_epi16(q, _mm256_cmpgt_epi16(t, q1s)), mask);
+
+    // pack 8 values per 128-bit lane into the low d bytes of the lane
+    __m256i z = _mm256_madd_epi16(y, fs);
+    z = _mm256_srlv_epi64(_mm256_sllv_epi32(z, s32), s32);
+    z = _mm256_sllv_epi64(z, s64);
+    z = _mm256_or_si256(_mm256_shuffle_epi8(z, lo), _mm256_shuffle_epi8(z, hi));
+
+    // store in order, so each 16-byte store overwrites the unused tail
+    // of the previous one; the last lane would run past the end of
+    // `out`, so it goes through a temporary buffer
+    uint8_t * const dst = out + 2 * d * i;
+    _mm_storeu_si128((void*) dst, _mm256_castsi256_si128(z));
+    if (i < 15) {
+      _mm_storeu_si128((void*) (dst + d), _mm256_extracti128_si256(z, 1));
+    } else {
+      uint8_t tail[16];
+      _mm_storeu_si128((void*) tail, _mm256_extracti128_si256(z, 1));
+      memcpy(dst + d, tail, d);
+    }
+  }
+}
+/**
+ * Montgomery reduce the 32-bit sums in `c0` and `c1` and interleave
+ * the results: even lanes hold `c0 * 2^-16` and odd lanes hold
+ * `c1 * 2^-16`.
+ *
+ * The low half of each sum gives the Montgomery quotient `t`, and the
+ * result is the difference of the high halves of the sum and `t * Q`.
+ *
+ * @param[in] c0 Sums for the even lanes (`|x| < Q * 2^15`).
+ * @param[in] c1 Sums for the odd lanes (`|x| < Q * 2^15`).
+ * @return Reduced coefficients in the range (-Q, Q).
+ */
+__attribute__((target("avx2")))
+static inline __m256i avx2_mont_reduce_pairs(const __m256i c0, const __m256i c1) {
+  const __m256i lo = _mm256_blend_epi16(c0, _mm256_slli_epi32(c1, 16), 0xaa),
+                hi = _mm256_blend_epi16(_mm256_srli_epi32(c0, 16), c1, 0xaa),
+                t = _mm256_mullo_epi16(lo, _mm256_set1_epi16(QINV));
+  return _mm256_sub_epi16(hi, _mm256_mulhi_epi16(t, _mm256_set1_epi16(Q)));
+}
+
+/**
+ * Multiply `n` pairs of polynomials `a[i]` and `b[i]`, sum the
+ * products, and store the sum in `c` (AVX2 implementation).
+ *
+ * Produces output congruent to `poly_basemul_acc_scalar()`, with the
+ * same bounds.  Each 32-bit lane holds the coefficients of one
+ * degree-one polynomial, so `_mm256_madd_epi16()` computes
+ * `a0 * b0 + a1 * (b1 * zeta)` and `a0 * b1 + a1 * b0` directly in
+ * 32 bits.  The sums are reduced once, after the last product.
+ *
+ * @param[out] c Sum of products, in the NTT domain.
+ * @param[in] a Input polynomials, in the NTT domain.
+ * @param[in] b Input polynomials, in the NTT domain.
+ * @param[in] bc Mulcaches of `b` (optional, may be `NULL`).
+ * @param[in] n Number of products (at most 4).
+ */
+__attribute__((target("avx2")))
+static void poly_basemul_acc_avx2(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b, const poly_mulcache_t * const restrict bc, const size_t n) {
+  for (size_t i = 0; i < 256; i += 16) {
+    // odd lanes: base case multiply factors MUL_LUT[i / 2, i / 2 + 7]
+    const __m256i zs = _mm256_slli_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((void*) (MUL_LUT + i / 2))), 16),
+                  zqs = avx2_mont_qinv(zs);
+
+    __m256i c0 = _mm256_setzero_si256(),
+            c1 = _mm256_setzero_si256();
+    for (size_t j = 0; j < n; j++) {
+      const __m256i x = _mm256_loadu_si256((void*) (a[j].cs + i)),
+                    y = _mm256_loadu_si256((void*) (b[j].cs + i)),
+                    yz = bc ? _mm256_loadu_si256((void*) (bc[j].cs + i)) : _mm256_blend_epi16(y, avx2_mul_mont(y, zs, zqs), 0xaa), // b0, b1 * zeta
+                    ys = _mm256_or_si256(_mm256_slli_epi32(y, 16), _mm256_srli_epi32(y, 16)); // b1, b0
+
+      // each term is below 2 * Q^2, so 4 terms are below Q * 2^15
+      c0 = _mm256_add_epi32(c0, _mm256_madd_epi16(x, yz));
+      c1 = _mm256_add_epi32(c1, _mm256_madd_epi16(x, ys));
+    }
+
+    _mm256_storeu_si256((void*) (c->cs + i), avx2_mont_reduce_pairs(c0, c1));
+  }
+}
+
+/**
+ * Compute mulcache `bc` of polynomial `b` (AVX2 implementation).
+ *
+ * @param[out] bc Mulcache of `b`.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+__attribute__((target("avx2")))
+static void poly_mulcache_compute_avx2(poly_mulcache_t * const restrict bc, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 16) {
+    // odd lanes: base case multiply factors MUL_LUT[i / 2, i / 2 + 7]
+    const __m256i zs = _mm256_slli_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((void*) (MUL_LUT + i / 2))), 16),
+                  y = _mm256_loadu_si256((void*) (b->cs + i));
+    _mm256_storeu_si256((void*) (bc->cs + i), _mm256_blend_epi16(y, avx2_mul_mont(y, zs, avx2_mont_qinv(zs)), 0xaa));
+  }
+}
+
+/**
+ * Sample coefficients of polynomial `p` from CBD(2), using 128 bytes
+ * of PRF output `buf` (AVX2 implementation).
+ *
+ * Produces the same output as `poly_cbd2_scalar()`, with the same
+ * bit tricks on 32 bytes (64 coefficients) at a time; each byte holds
+ * two coefficients, which are unpacked to bytes and sign-extended.
+ *
+ * @param[out] p Output polynomial, coefficients in the range [-2, 2].
+ * @param[in] buf PRF output (128 bytes).
+ */
+__attribute__((target("avx2")))
+static void poly_cbd2_avx2(poly_t * const p, const uint8_t buf[static 128]) {
+  const __m256i m55 = _mm256_set1_epi8(0x55),
+                m33 = _mm256_set1_epi8(0x33),
+                m0f = _mm256_set1_epi8(0x0f),
+                twos = _mm256_set1_epi8(2);
+
+  for (size_t i = 0; i < 4; i++) {
+    const __m256i w = _mm256_loadu_si256((void*) (buf + 32 * i)),
+                  t = _mm256_add_epi8(_mm256_and_si256(w, m55), _mm256_and_si256(_mm256_srli_epi16(w, 1), m55)), // 2-bit sums
+                  u = _mm256_sub_epi8(_mm256_add_epi8(_mm256_and_si256(t, m33), _mm256_set1_epi8(0x22)), _mm256_and_si256(_mm256_srli_epi16(t, 2), m33)), // x - y + 2
+                  lo = _mm256_sub_epi8(_mm256_and_si256(u, m0f), twos), // even coefficients
+                  hi = _mm256_sub_epi8(_mm256_and_si256(_mm256_srli_epi16(u, 4), m0f), twos), // odd coefficients
+                  a = _mm256_unpacklo_epi8(lo, hi), // coefficients 0-15, 32-47
+                  b = _mm256_unpackhi_epi8(lo, hi); // coefficients 16-31, 48-63
+
+    int16_t * const cs = p->cs + 64 * i;
+    _mm256_storeu_si256((void*) cs, _mm256_cvtepi8_epi16(_mm256_castsi256_si128(a)));
+    _mm256_storeu_si256((void*) (cs + 16), _mm256_cvtepi8_epi16(_mm256_castsi256_si128(b)));
+    _mm256_storeu_si256((void*) (cs + 32), _mm256_cvtepi8_epi16(_mm256_extracti128_si256(a, 1)));
+    _mm256_storeu_si256((void*) (cs + 48), _mm256_cvtepi8_epi16(_mm256_extracti128_si256(b, 1)));
+  }
+}
+
+/**
+ * Sample coefficients of polynomial `p` from CBD(3), using 192 bytes
+ * of PRF output `buf` (AVX2 implementation).
+ *
+ * Produces the same output as `poly_cbd3_scalar()`.  Each iteration
+ * spreads 24 bytes (32 coefficients) across the 32-bit lanes, 3 bytes
+ * per lane, and applies the same bit tricks to every lane.  The last
+ * iteration loads the final 32 bytes of `buf` so that it does not read
+ * past the end.
+ *
+ * @param[out] p Output polynomial, coefficients in the range [-3, 3].
+ * @param[in] buf PRF output (192 bytes).
+ */
+__attribute__((target("avx2")))
+static void poly_cbd3_avx2(poly_t * const p, const uint8_t buf[static 192]) {
+  // spread bytes 0-11 of the low 128-bit lane and bytes 4-15 of the
+  // high 128-bit lane to 3 bytes per 32-bit lane
+  const __m256i idx = _mm256_setr_epi8(
+    0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+    4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1
+  );
+  const __m256i m249 = _mm256_set1_epi32(0x249249),
+                m07 = _mm256_set1_epi32(0x7),
+                m70 = _mm256_set1_epi32(0x7 << 16),
+                threes = _mm256_set1_epi16(3);
+
+  for (size_t i = 0; i < 8; i++) {
+    // 64-bit words 0, 1, 1, 2 of the 24 bytes at buf + 24 * i
+    const __m256i v = (i < 7) ? _mm256_permute4x64_epi64(_mm256_loadu_si256((void*) (buf + 24 * i)), 0x94) : _mm256_permute4x64_epi64(_mm256_loadu_si256((void*) (buf + 160)), 0xe9),
+                  w = _mm256_shuffle_epi8(v, idx),
+                  t = _mm256_add_epi32(_mm256_add_epi32(_mm256_and_si256(w, m249), _mm256_and_si256(_mm256_srli_epi32(w, 1), m249)), _mm256_and_si256(_mm256_srli_epi32(w, 2), m249)), // 3-bit sums
+                  u = _mm256_sub_epi32(_mm256_add_epi32(t, _mm256_set1_epi32(0x6db6db)), _mm256_srli_epi32(t, 3)), // x - y + 3 in even fields
+
+                  // coefficients 0 and 1 of each lane (bits 0-2 and 6-8)
+                  c01 = _mm256_sub_epi16(_mm256_or_si256(_mm256_and_si256(u, m07), _mm256_and_si256(_mm256_slli_epi32(u, 10), m70)), threes),
+                  // coefficients 2 and 3 of each lane (bits 12-14 and 18-20)
+                  c23 = _mm256_sub_epi16(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(u, 12), m07), _mm256_and_si256(_mm256_srli_epi32(u, 2), m70)), threes),
+                  a = _mm256_unpacklo_epi32(c01, c23), // coefficients 0-7, 16-23
+                  b = _mm256_unpackhi_epi32(c01, c23); // coefficients 8-15, 24-31
+
+    _mm256_storeu_si256((void*) (p->cs + 32 * i), _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256((void*) (p->cs + 32 * i + 16), _mm256_permute2x128_si256(a, b, 0x31));
+  }
+}
+
+/**
+ * Parse `len` bytes of SHAKE128 output in `buf` as 12-bit candidates
+ * and append the candidates which are less than Q to polynomial `a`,
+ * starting at coefficient `n` (AVX2 implementation).  See
+ * `poly_sample_ntt_parse_scalar()`.
+ *
+ * Unpacks 16 candidates (24 bytes) per step, compares them with Q, and
+ * left-packs the accepted candidates of each 128-bit lane with a
+ * `pshufb` from REJ_AVX2_IDX.  Each lane is stored as a whole, so
+ * coefficients after the returned count may be overwritten, and the
+ * loop stops once fewer than 16 coefficients are left; the last
+ * coefficients and bytes are parsed by the reference C implementation.
+ *
+ * @param[out] a Output polynomial.
+ * @param[in] n Number of coefficients already sampled.
+ * @param[in] buf XOF output.
+ * @param[in] len Length of XOF output, in bytes (multiple of 3).
+ * @return Number of coefficients sampled.
+ */
+__attribute__((target("avx2")))
+static size_t poly_sample_ntt_parse_avx2(poly_t * const a, size_t n, const uint8_t * const buf, const size_t len) {
+  // spread bytes 0-11 of the low 128-bit lane and bytes 4-15 of the
+  // high 128-bit lane to 2 bytes per 16-bit lane
+  const __m256i idx = _mm256_setr_epi8(
+    0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11,
+    4, 5, 5, 6, 7, 8, 8, 9, 10, 11, 11, 12, 13, 14, 14, 15
+  );
+  const __m256i m12 = _mm256_set1_epi16(0xfff),
+                qs = _mm256_set1_epi16(Q);
+
+  size_t ofs = 0;
+  for (; ofs + 24 <= len && n <= 256 - 16; ofs += 24) {
+    // bytes 0-15 in the low 128-bit lane, bytes 8-23 in the high one
+    const __m128i lo = _mm_loadu_si128((void*) (buf + ofs)),
+                  hi = _mm_loadu_si128((void*) (buf + ofs + 8));
+    const __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), idx),
+                  ds = _mm256_blend_epi16(_mm256_and_si256(v, m12), _mm256_srli_epi16(v, 4), 0xaa), // candidates
+                  ok = _mm256_cmpgt_epi16(qs, ds); // accepted candidates
+
+    // bits 0-7: accepted lanes of low 128-bit lane, bits 16-23: high
+    const uint32_t mask = _mm256_movemask_epi8(_mm256_packs_epi16(ok, _mm256_setzero_si256()));
+    const uint8_t m0 = mask & 0xff, m1 = (mask >> 16) & 0xff;
+
+    // left-pack accepted candidates of each 128-bit lane and append them
+    _mm_storeu_si128((void*) (a->cs + n), _mm_shuffle_epi8(_mm256_castsi256_si128(ds), _mm_loadu_si128((void*) REJ_AVX2_IDX[m0])));
+    n += __builtin_popcount(m0);
+    _mm_storeu_si128((void*) (a->cs + n), _mm_shuffle_epi8(_mm256_extracti128_si256(ds, 1), _mm_loadu_si128((void*) REJ_AVX2_IDX[m1])));
+    n += __builtin_popcount(m1);
+  }
+
+  // parse remaining bytes
+  return poly_sample_ntt_parse_scalar(a, n, buf + ofs, len - ofs);
+}
+/**
+ * Pack 12-bit coefficients of polynomial `a` and serialize them into
+ * 384 bytes of the output buffer `out` (AVX2 implementation).  See
+ * `poly_encode_scalar()`.
+ *
+ * Each step joins pairs of coefficients into 24-bit values with
+ * `vpmaddwd`, gathers the 3 low bytes of each 32-bit lane with a
+ * shuffle, and stores 16 coefficients as 24 bytes.
+ *
+ * @param[out] out Output buffer (384 bytes).
+ * @param[in] a Input polynomial.
+ */
+__attribute__((target("avx2")))
+static void poly_encode_avx2(uint8_t out[static 384], const poly_t * const a) {
+  // move the 3 low bytes of each 32-bit lane to the first 12 bytes of
+  // each 128-bit lane, then move those to the first 24 bytes
+  const __m256i idx = _mm256_setr_epi8(
+    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+  );
+  const __m256i perm = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7),
+                ms = _mm256_set1_epi32(0x10000001); // 1, 2^12
+
+  for (size_t i = 0; i < 16; i++) {
+    const __m256i v = _mm256_loadu_si256((void*) (a->cs + 16 * i)),
+                  w = _mm256_madd_epi16(v, ms), // a0 | (a1 << 12)
+                  x = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(w, idx), perm);
+
+    _mm_storeu_si128((void*) (out + 24 * i), _mm256_castsi256_si128(x));
+    _mm_storel_epi64((void*) (out + 24 * i + 16), _mm256_extracti128_si256(x, 1));
+  }
+}
+
+/**
+ * Deserialize 384-byte buffer `b` as 256 12-bit integers, reduce them
+ * modulo Q, and save them as the coefficients of polynomial `p` (AVX2
+ * implementation).  See `poly_decode_scalar()`.
+ *
+ * Unpacks 16 integers (24 bytes) per step with the same shuffle as
+ * `poly_sample_ntt_parse_avx2()`, checks them against Q, and reduces
+ * them with a conditional subtraction (unsigned minimum of `x` and `x -
+ * Q`).
+ *
+ * @param[out] p Output polynomial.
+ * @param[in] b Input buffer (384 bytes).
+ * @return True if every integer was less than Q.
+ */
+__attribute__((target("avx2")))
+static bool poly_decode_avx2(poly_t * const p, const uint8_t b[static 384]) {
+  // spread bytes 0-11 of the low 128-bit lane and bytes 4-15 of the
+  // high 128-bit lane to 2 bytes per 16-bit lane
+  const __m256i idx = _mm256_setr_epi8(
+    0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11,
+    4, 5, 5, 6, 7, 8, 8, 9, 10, 11, 11, 12, 13, 14, 14, 15
+  );
+  const __m256i m12 = _mm256_set1_epi16(0xfff),
+                qs = _mm256_set1_epi16(Q),
+                q1s = _mm256_set1_epi16(Q - 1);
+
+  __m256i bad = _mm256_setzero_si256(); // lanes with integers >= Q
+  for (size_t i = 0; i < 16; i++) {
+    // bytes 0-15 in the low 128-bit lane, bytes 8-23 in the high one
+    const __m128i lo = _mm_loadu_si128((void*) (b + 24 * i)),
+                  hi = _mm_loadu_si128((void*) (b + 24 * i + 8));
+    const __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), idx),
+                  ds = _mm256_blend_epi16(_mm256_and_si256(v, m12), _mm256_srli_epi16(v, 4), 0xaa);
+
+    bad = _mm256_or_si256(bad, _mm256_cmpgt_epi16(ds, q1s));
+    _mm256_storeu_si256((void*) (p->cs + 16 * i), _mm256_min_epu16(ds, _mm256_sub_epi16(ds, qs)));
+  }
+
+  return _mm256_testz_si256(bad, bad);
+}
+
+#endif /* FIPS203IPD_AVX2 */
+
+/**
+ * Add polynomial `a` to polynomial `b` component-wise, and store the
+ * sum in `a` (reference C implementation).
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+static inline void poly_add_scalar(poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i++) {
+    a->cs[i] += b->cs[i];
+  }
+}
+
+/**
+ * Subtract polynomial `b` from polynomial `a` component-wise, and store the
+ * result in `a` (reference C implementation).
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+static inline void poly_sub_scalar(poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i++) {
+    a->cs[i] -= b->cs[i];
+  }
+}
+
+/**
+ * Multiply `a` and `b` and store the product in `c` (reference C
+ * implementation).
+ *
+ * The base case multiply is a Montgomery multiply, so `c` is
+ * `a * b * 2^-16`; the product is exact when one operand is in
+ * Montgomery form (see poly_tomont()).
+ *
+ * Note: `a` and `b` are assumed to be in the NTT domain.
+ *
+ * @param[out] c Product polynomial, in the NTT domain.
+ * @param[in] a Input polynomial, in the NTT domain.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+static inline void poly_mul_scalar(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 128; i++) {
+    const int32_t a0 = a->cs[2 * i],
+                  a1 = a->cs[2 * i + 1],
+                  b0 = b->cs[2 * i],
+                  b1 = b->cs[2 * i + 1];
+
+    // both sums are below 2 * Q^2, so one reduction each suffices
+    const int32_t c0 = a0 * b0 + (int32_t) mont_mul(a1, b1) * MUL_LUT[i],
+                  c1 = a0 * b1 + a1 * b0;
+    c->cs[2 * i] = mont_reduce(c0);
+    c->cs[2 * i + 1] = mont_reduce(c1);
+  }
+}
+
+/**
+ * Multiply `n` pairs of polynomials `a[i]` and `b[i]`, sum the products,
+ * and store the sum in `c` (reference C implementation).
+ *
+ * The base case products are accumulated in 32 bits and reduced once,
+ * so `c` is `(a[0] * b[0] + ... + a[n - 1] * b[n - 1]) * 2^-16`, like
+ * `poly_mul_scalar()`.
+ *
+ * Note: `a` and `b` are assumed to be in the NTT domain.
+ *
+ * @param[out] c Sum of products, in the NTT domain.
+ * @param[in] a Input polynomials, in the NTT domain.
+ * @param[in] b Input polynomials, in the NTT domain.
+ * @param[in] bc Mulcaches of `b` (optional, may be `NULL`).
+ * @param[in] n Number of products (at most 4).
+ */
+static inline void poly_basemul_acc_scalar(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b, const poly_mulcache_t * const restrict bc, const size_t n) {
+  for (size_t i = 0; i < 128; i++) {
+    int32_t c0 = 0, c1 = 0;
+    for (size_t j = 0; j < n; j++) {
+      const int32_t a0 = a[j].cs[2 * i],
+                    a1 = a[j].cs[2 * i + 1],
+                    b0 = b[j].cs[2 * i],
+                    b1 = b[j].cs[2 * i + 1],
+                    b1z = bc ? bc[j].cs[2 * i + 1] : mont_mul(b1, MUL_LUT[i]);
+
+      // each term is below 2 * Q^2, so 4 terms are below Q * 2^15
+      c0 += a0 * b0 + a1 * b1z;
+      c1 += a0 * b1 + a1 * b0;
+    }
+
+    c->cs[2 * i] = mont_reduce(c0);
+    c->cs[2 * i + 1] = mont_reduce(c1);
+  }
+}
+
+/**
+ * Compute mulcache `bc` of polynomial `b` (reference C implementation).
+ *
+ * @param[out] bc Mulcache of `b`.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+static inline void poly_mulcache_compute_scalar(poly_mulcache_t * const restrict bc, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 128; i++) {
+    bc->cs[2 * i] = b->cs[2 * i];
+    bc->cs[2 * i + 1] = mont_mul(b->cs[2 * i + 1], MUL_LUT[i]);
+  }
+}
+
+/**
+ * Sample coefficients of polynomial `p` from the centered binomial
+ * distribution CBD(2), using 128 bytes of PRF output `buf` (reference
+ * C implementation).
+ *
+ * Bitsliced: each byte holds the 4 bits of 2 coefficients.  Adding the
+ * odd bits to the even bits gives the 2-bit sums `x` and `y` of both
+ * coefficients at once, and adding 2 to `x` before subtracting `y`
+ * keeps each 4-bit field in the range [0, 4], so the fields do not
+ * borrow from each other.  The loop has no branches or cross-byte
+ * dependencies, so the compiler can vectorize it.
+ *
+ * @param[out] p Output polynomial, coefficients in the range [-2, 2].
+ * @param[in] buf PRF output (128 bytes).
+ */
+static inline void poly_cbd2_scalar(poly_t * const p, const uint8_t buf[static 128]) {
+  for (size_t i = 0; i < 128; i++) {
+    const uint8_t t = (buf[i] & 0x55) + ((buf[i] >> 1) & 0x55), // 2-bit sums
+                  u = (t & 0x33) + 0x22 - ((t >> 2) & 0x33); // x - y + 2
+
+    p->cs[2 * i] = (int16_t) (u & 0xf) - 2;
+    p->cs[2 * i + 1] = (int16_t) (u >> 4) - 2;
+  }
+}
+
+/**
+ * Sample coefficients of polynomial `p` from the centered binomial
+ * distribution CBD(3), using 192 bytes of PRF output `buf` (reference
+ * C implementation).
+ *
+ * Bitsliced like `poly_cbd2_scalar()`: each 24-bit word holds the 6
+ * bits of 4 coefficients, and the 3-bit sums `x` and `y` are in
+ * adjacent 3-bit fields.  Adding 3 to every field before subtracting
+ * the next field keeps each field in the range [0, 6].  The words are
+ * computed first and unpacked in a second loop, which lets the
+ * compiler vectorize both loops.
+ *
+ * @param[out] p Output polynomial, coefficients in the range [-3, 3].
+ * @param[in] buf PRF output (192 bytes).
+ */
+static inline void poly_cbd3_scalar(poly_t * const p, const uint8_t buf[static 192]) {
+  uint32_t us[64] = { 0 };
+  for (size_t i = 0; i < 64; i++) {
+    // load 4 coefficients (24 bits, little-endian)
+    const uint32_t w = ((uint32_t) buf[3 * i]) | ((uint32_t) buf[3 * i + 1] << 8) | ((uint32_t) buf[3 * i + 2] << 16),
+                   t = (w & 0x249249) + ((w >> 1) & 0x249249) + ((w >> 2) & 0x249249); // 3-bit sums
+    us[i] = t + 0x6db6db - (t >> 3); // x - y + 3 in even fields
+  }
+
+  for (size_t i = 0; i < 64; i++) {
+    p->cs[4 * i] = (int16_t) (us[i] & 0x7) - 3;
+    p->cs[4 * i + 1] = (int16_t) ((us[i] >> 6) & 0x7) - 3;
+    p->cs[4 * i + 2] = (int16_t) ((us[i] >> 12) & 0x7) - 3;
+    p->cs[4 * i + 3] = (int16_t) ((us[i] >> 18) & 0x7) - 3;
+  }
+}
+
+#ifdef FIPS203IPD_AVX512
+/**
+ * Reduce 32 coefficients to their centered representatives.  See
+ * `avx2_barrett_reduce()`.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i avx512_barrett_reduce(const __m512i x) {
+  const __m512i t = _mm512_mulhrs_epi16(_mm512_mulhi_epi16(x, _mm512_set1_epi16(BARRETT_V)), _mm512_set1_epi16(1 << 5));
+  return _mm512_sub_epi16(x, _mm512_mullo_epi16(t, _mm512_set1_epi16(Q)));
+}
+
+/**
+ * Montgomery multiply 32 coefficients `x` by `ys`.  See
+ * `avx2_mul_mont()`.
+ *
+ * @param[in] x Signed coefficients.
+ * @param[in] ys Signed coefficients (`|x * ys| < Q * 2^15`).
+ * @param[in] yqs `ys * QINV mod 2^16`.
+ * @return Products in the range (-Q, Q).
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i avx512_mul_mont(const __m512i x, const __m512i ys, const __m512i yqs) {
+  const __m512i t = _mm512_mullo_epi16(x, yqs);
+  return _mm512_sub_epi16(_mm512_mulhi_epi16(x, ys), _mm512_mulhi_epi16(t, _mm512_set1_epi16(Q)));
+}
+
+/**
+ * Compute `ys * QINV mod 2^16` for `avx512_mul_mont()`.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i avx512_mont_qinv(const __m512i ys) {
+  return _mm512_mullo_epi16(ys, _mm512_set1_epi16(QINV));
+}
+
+/**
+ * Forward NTT butterfly on 32 coefficient pairs.  See
+ * `avx2_ntt_butterfly()`.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline void avx512_ntt_butterfly(__m512i * const a, __m512i * const b, const __m512i zs, const __m512i zqs) {
+  const __m512i t = avx512_mul_mont(*b, zs, zqs);
+  *b = _mm512_sub_epi16(*a, t);
+  *a = _mm512_add_epi16(*a, t);
+}
+
+/**
+ * Inverse NTT butterfly on 32 coefficient pairs.  See
+ * `avx2_inv_ntt_butterfly()`.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline void avx512_inv_ntt_butterfly(__m512i * const a, __m512i * const b, const __m512i zs, const __m512i zqs) {
+  const __m512i t = *a;
+  *a = _mm512_add_epi16(t, *b);
+  *b = avx512_mul_mont(_mm512_sub_epi16(*b, t), zs, zqs);
+}
+
+/**
+ * Compute number-theoretic transform (NTT) of the 256 coefficients in
+ * `cs`, 32 coefficients per vector, in registers.
+ *
+ * Shared by `poly_ntt_avx512()` and `poly_decode_ntt_avx512()`.
+ * Vector `i` holds coefficients `32 * i` to `32 * i + 31`, on input
+ * and on return.
+ *
+ * @param[in,out] cs Coefficients (8 vectors).
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline void avx512_ntt(__m512i cs[static 8]) {
+  // layers with len = 128, 64, 32 (one twiddle factor per group)
+  size_t k = 1;
+  for (size_t len = 4; len >= 1; len /= 2) {
+    for (size_t start = 0; start < 8; start += 2 * len) {
+      const __m512i zs = _mm512_set1_epi16(NTT_LUT[k]),
+                    zqs = _mm512_set1_epi16(NTT_LUT_QINV[k]);
+      k++;
+
+      for (size_t j = start; j < start + len; j++) {
+        avx512_ntt_butterfly(cs + j, cs + j + len, zs, zqs);
+      }
+    }
+  }
+
+  // layers with len = 16, 8, 4, 2 (per-lane twiddle factors)
+  for (size_t l = 0; l < 4; l++) {
+    const __m512i pa = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][0]),
+                  pb = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][1]),
+                  px = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][2]),
+                  py = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][3]);
+
+    for (size_t i = 0; i < 4; i++) {
+      const __m512i zs = _mm512_loadu_si512((void*) NTT_AVX512_ZETAS[0][l][i]),
+                    zqs = _mm512_loadu_si512((void*) NTT_AVX512_ZETAS_QINV[0][l][i]);
+
+      __m512i a = _mm512_permutex2var_epi16(cs[2 * i], pa, cs[2 * i + 1]),
+              b = _mm512_permutex2var_epi16(cs[2 * i], pb, cs[2 * i + 1]);
+      avx512_ntt_butterfly(&a, &b, zs, zqs);
+      cs[2 * i] = _mm512_permutex2var_epi16(a, px, b);
+      cs[2 * i + 1] = _mm512_permutex2var_epi16(a, py, b);
+    }
+  }
+
+  // |x| < 8Q after 7 layers
+  for (size_t i = 0; i < 8; i++) {
+    cs[i] = avx512_barrett_reduce(cs[i]);
+  }
+}
+
+/**
+ * Compute in-place number-theoretic transform (NTT) of polynomial `p`
+ * (AVX-512 implementation).
+ *
+ * Produces output congruent to `poly_ntt_scalar()`, with the same
+ * bounds.  The coefficients
+ * are held in 8 vectors of 32 lanes.  Layers with `len >= 32` use
+ * whole vectors.  Layers with `len <= 16` split each pair of vectors
+ * into butterfly operands with `vpermt2w` and the lane permutations in
+ * `NTT_AVX512_PERMS`, and read per-lane twiddle factors from
+ * `NTT_AVX512_ZETAS`.
+ *
+ * @param[in,out] p Polynomial.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_ntt_avx512(poly_t * const p) {
+  __m512i cs[8];
+  for (size_t i = 0; i < 8; i++) {
+    cs[i] = _mm512_loadu_si512((void*) (p->cs + 32 * i));
+  }
+
+  avx512_ntt(cs);
+
+  for (size_t i = 0; i < 8; i++) {
+    _mm512_storeu_si512((void*) (p->cs + 32 * i), cs[i]);
+  }
+}
+
+/**
+ * Decode packed `d`-bit values from input buffer `b`, decompress them,
+ * and store the NTT of the resulting polynomial in `p` (AVX-512
+ * implementation).
+ *
+ * Produces the same output as `poly_decode_ntt()`.  Unpacks and
+ * decompresses each vector of 32 values in registers like
+ * `poly_decode_ntt_avx2()`, but reads the `4 * d` bytes of each
+ * vector with one masked load, and moves the bytes of each 128-bit
+ * lane into place with `vpermw`.  Lanes which start on an odd byte
+ * start one 16-bit word early and skip the extra byte in the
+ * `vpshufb` indices.
+ *
+ * @param[out] p Output polynomial (NTT domain).
+ * @param[in] b Input buffer (`32 * d` bytes).
+ * @param[in] d Number of bits in compressed values (10 or 11).
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_decode_ntt_avx512(poly_t * const p, const uint8_t * const b, const uint8_t d) {
+  // first 16-bit word of 128-bit lanes 1 to 3, and odd byte offset of
+  // lanes 1 and 3
+  const uint32_t w1 = d / 2, w2 = d, w3 = 3 * d / 2, o = (d & 1) * 0x01010101;
+  const __mmask64 load_mask = (1ULL << (4 * d)) - 1;
+  const __m512i words = _mm512_add_epi16(
+                  _mm512_broadcast_i32x4(_mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7)),
+                  _mm512_setr_epi32(0, 0, 0, 0, w1 * 0x10001, w1 * 0x10001, w1 * 0x10001, w1 * 0x10001, w2 * 0x10001, w2 * 0x10001, w2 * 0x10001, w2 * 0x10001, w3 * 0x10001, w3 * 0x10001, w3 * 0x10001, w3 * 0x10001)
+                ),
+                idx = _mm512_add_epi8(
+                  _mm512_broadcast_i32x4(_mm_setr_epi8(
+                    0, 1, 2, 3,
+                    d / 4, d / 4 + 1, d / 4 + 2, d / 4 + 3,
+                    d / 2, d / 2 + 1, d / 2 + 2, d / 2 + 3,
+                    3 * d / 4, 3 * d / 4 + 1, 3 * d / 4 + 2, 3 * d / 4 + 3
+                  )),
+                  _mm512_setr_epi32(0, 0, 0, 0, o, o, o, o, 0, 0, 0, 0, o, o, o, o)
+                ),
+                shifts = _mm512_broadcast_i32x4(_mm_setr_epi32(0, (2 * d) % 8, (4 * d) % 8, (6 * d) % 8)),
+                mask = _mm512_set1_epi32((((1 << d) - 1) << (31 - d)) | (((1 << d) - 1) << (15 - d))),
+                qs = _mm512_set1_epi16(Q);
+
+  __m512i cs[8];
+  for (size_t i = 0; i < 8; i++) {
+    const __m512i x = _mm512_permutexvar_epi16(words, _mm512_maskz_loadu_epi8(load_mask, b + 4 * d * i));
+
+    // unpack pairs of values into 32-bit lanes, then shift each value
+    // to bit 15 - d of its 16-bit lane
+    const __m512i t = _mm512_srlv_epi32(_mm512_shuffle_epi8(x, idx), shifts),
+                  y = _mm512_and_si512(_mm512_mask_blend_epi16(0xaaaaaaaa, _mm512_slli_epi32(t, 15 - d), _mm512_slli_epi32(t, 31 - 2 * d)), mask);
+
+    cs[i] = _mm512_mulhrs_epi16(y, qs); // decompress
+  }
+
+  avx512_ntt(cs);
+
+  for (size_t i = 0; i < 8; i++) {
+    _mm512_storeu_si512((void*) (p->cs + 32 * i), cs[i]);
+  }
+}
+
+/**
+ * Compute inverse number-theoretic transform (NTT) of the 256
+ * coefficients in `cs`, 32 coefficients per vector, in registers.
+ *
+ * Shared by `poly_inv_ntt_avx512()` and `poly_inv_ntt_encode_avx512()`.
+ * On return vector `i` holds coefficients `32 * i` to `32 * i + 31`,
+ * in the range (-Q, Q).
+ *
+ * @param[in,out] cs Coefficients (8 vectors).
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline void avx512_inv_ntt(__m512i cs[static 8]) {
+  // layers with len = 2, 4, 8, 16 (per-lane twiddle factors)
+  for (size_t l = 4; l-- > 0;) {
+    const __m512i pa = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][0]),
+                  pb = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][1]),
+                  px = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][2]),
+                  py = _mm512_loadu_si512((void*) NTT_AVX512_PERMS[l][3]);
+
+    for (size_t i = 0; i < 4; i++) {
+      const __m512i zs = _mm512_loadu_si512((void*) NTT_AVX512_ZETAS[1][l][i]),
+                    zqs = _mm512_loadu_si512((void*) NTT_AVX512_ZETAS_QINV[1][l][i]);
+
+      __m512i a = _mm512_permutex2var_epi16(cs[2 * i], pa, cs[2 * i + 1]),
+              b = _mm512_permutex2var_epi16(cs[2 * i], pb, cs[2 * i + 1]);
+      avx512_inv_ntt_butterfly(&a, &b, zs, zqs);
+      cs[2 * i] = _mm512_permutex2var_epi16(a, px, b);
+      cs[2 * i + 1] = _mm512_permutex2var_epi16(a, py, b);
+    }
+
+    if (l == 1) {
+      // |x| < 8Q after 3 layers (len = 2, 4, 8)
+      for (size_t i = 0; i < 8; i++) {
+        cs[i] = avx512_barrett_reduce(cs[i]);
+      }
+    }
+  }
+
+  // layers with len = 32, 64 (one twiddle factor per group)
+  size_t k = 7;
+  for (size_t len = 1; len <= 2; len *= 2) {
+    for (size_t start = 0; start < 8; start += 2 * len) {
+      const __m512i zs = _mm512_set1_epi16(NTT_LUT[k]),
+                    zqs = _mm512_set1_epi16(NTT_LUT_QINV[k]);
+      k--;
+
+      for (size_t j = start; j < start + len; j++) {
+        avx512_inv_ntt_butterfly(cs + j, cs + j + len, zs, zqs);
+      }
+    }
+  }
+
+  // layer with len = 128, scaled by 128^-1 mod Q
+  const __m512i ss = _mm512_set1_epi16(INV_NTT_SCALE),
+                sqs = avx512_mont_qinv(ss),
+                zs = _mm512_set1_epi16(INV_NTT_SCALE_ZETA),
+                zqs = avx512_mont_qinv(zs);
+  for (size_t j = 0; j < 4; j++) {
+    const __m512i a = cs[j], b = cs[j + 4];
+    cs[j] = avx512_mul_mont(_mm512_add_epi16(a, b), ss, sqs);
+    cs[j + 4] = avx512_mul_mont(_mm512_sub_epi16(b, a), zs, zqs);
+  }
+}
+
+/**
+ * Compute in-place inverse number-theoretic transform (NTT) of
+ * polynomial `p` (AVX-512 implementation).
+ *
+ * Produces output congruent to `poly_inv_ntt_scalar()`, with the
+ * same bounds.  See
+ * `poly_ntt_avx512()`.
+ *
+ * @param[in,out] p Polynomial.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_inv_ntt_avx512(poly_t * const p) {
+  __m512i cs[8];
+  for (size_t i = 0; i < 8; i++) {
+    cs[i] = _mm512_loadu_si512((void*) (p->cs + 32 * i));
+  }
+
+  avx512_inv_ntt(cs);
+
+  for (size_t i = 0; i < 8; i++) {
+    _mm512_storeu_si512((void*) (p->cs + 32 * i), cs[i]);
+  }
+}
+
+/**
+ * Compute the inverse NTT of polynomial `u`, add polynomial `e`,
+ * compress the sum to `d` bits, and serialize the compressed values as
+ * `32 * d` bytes in output buffer `out` (AVX-512 implementation).
+ *
+ * Produces the same output as `poly_inv_ntt_encode()`.  Reduces,
+ * compresses, and packs each vector of 32 coefficients from the final
+ * inverse NTT layer in registers, like `poly_inv_ntt_encode_avx2()`,
+ * so each of the four 128-bit lanes yields 8 packed values in its low
+ * `d` bytes.
+ *
+ * @param[out] out Output buffer (`32 * d` bytes).
+ * @param[in] u Input polynomial (NTT domain).
+ * @param[in] e Noise polynomial.
+ * @param[in] d Number of bits in compressed values (10 or 11).
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_inv_ntt_encode_avx512(uint8_t * const out, const poly_t * const u, const poly_t * const e, const uint8_t d) {
+  __m512i cs[8];
+  for (size_t i = 0; i < 8; i++) {
+    cs[i] = _mm512_loadu_si512((void*) (u->cs + 32 * i));
+  }
+
+  avx512_inv_ntt(cs);
+
+  const __m128i ds = _mm_cvtsi32_si128(d);
+  const __m512i qs = _mm512_set1_epi16(Q),
+                q1s = _mm512_set1_epi16(Q - 1),
+                hs = _mm512_set1_epi16((Q - 1) / 2),
+                ms = _mm512_set1_epi16((1 << (13 + d)) / Q),
+                ones = _mm512_set1_epi16(1),
+                mask = _mm512_set1_epi16((1 << d) - 1),
+                fs = _mm512_set1_epi32((1 << (16 + d)) | 1), // (1, 2^d)
+                s32 = _mm512_set1_epi64(32 - 2 * d), // 2d-bit pairs to 64-bit lanes
+                s64 = _mm512_broadcast_i32x4(_mm_set_epi64x((4 * d) % 8, 0)),
+                lo = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 2, 3, 4, (d == 11) ? 5 : -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                hi = _mm512_broadcast_i32x4(_mm_setr_epi8(-1, -1, -1, -1, -1, 8, 9, 10, 11, 12, (d == 11) ? 13 : -1, -1, -1, -1, -1, -1));
+
+  for (size_t i = 0; i < 8; i++) {
+    // x = u + e, reduced to [-(Q - 1) / 2, (Q - 1) / 2]
+    const __m512i x = avx512_barrett_reduce(_mm512_add_epi16(cs[i], _mm512_loadu_si512((void*) (e->cs + 32 * i))));
+
+    // y = compress(x, d) (see poly_compress_vec() and
+    // poly_inv_ntt_encode_avx2())
+    const __m512i q = _mm512_mulhi_epi16(_mm512_slli_epi16(x, 3), ms),
+                  t = _mm512_sub_epi16(_mm512_add_epi16(_mm512_sll_epi16(x, ds), hs), _mm512_mullo_epi16(q, qs)),
+                  y = _mm512_and_si512(_mm512_mask_add_epi16(q, _mm512_cmpgt_epi16_mask(t, q1s), q, ones), mask);
+
+    // pack 8 values per 128-bit lane into the low d bytes of the lane
+    __m512i z = _mm512_madd_epi16(y, fs);
+    z = _mm512_srlv_epi64(_mm512_sllv_epi32(z, s32), s32);
+    z = _mm512_sllv_epi64(z, s64);
+    z = _mm512_or_si512(_mm512_shuffle_epi8(z, lo), _mm512_shuffle_epi8(z, hi));
+
+    // store lanes in order (see poly_inv_ntt_encode_avx2())
+    uint8_t * const dst = out + 4 * d * i;
+    _mm_storeu_si128((void*) dst, _mm512_castsi512_si128(z));
+    _mm_storeu_si128((void*) (dst + d), _mm512_extracti32x4_epi32(z, 1));
+    _mm_storeu_si128((void*) (dst + 2 * d), _mm512_extracti32x4_epi32(z, 2));
+    if (i < 7) {
+      _mm_storeu_si128((void*) (dst + 3 * d), _mm512_extracti32x4_epi32(z, 3));
+    } else {
+      uint8_t tail[16];
+      _mm_storeu_si128((void*) tail, _mm512_extracti32x4_epi32(z, 3));
+      memcpy(dst + 3 * d, tail, d);
+    }
+  }
+}
+
+/**
+ * Add polynomial `a` to polynomial `b` component-wise, and store the
+ * sum in `a` (AVX-512 implementation).
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_add_avx512(poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 32) {
+    const __m512i x = _mm512_loadu_si512((void*) (a->cs + i)),
+                  y = _mm512_loadu_si512((void*) (b->cs + i));
+    _mm512_storeu_si512((void*) (a->cs + i), _mm512_add_epi16(x, y));
+  }
+}
+
+/**
+ * Subtract polynomial `b` from polynomial `a` component-wise, and store
+ * the result in `a` (AVX-512 implementation).
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_sub_avx512(poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 32) {
+    const __m512i x = _mm512_loadu_si512((void*) (a->cs + i)),
+                  y = _mm512_loadu_si512((void*) (b->cs + i));
+    _mm512_storeu_si512((void*) (a->cs + i), _mm512_sub_epi16(x, y));
+  }
+}
+
+/**
+ * Multiply `a` and `b` and store the product in `c` (AVX-512
+ * implementation).
+ *
+ * Produces output congruent to `poly_mul_scalar()`, in the range
+ * (-2Q, 2Q).  Works on the
+ * interleaved coefficients directly: even lanes hold the constant
+ * terms and odd lanes hold the linear terms of the 128 degree-one
+ * products.  Products are computed with Montgomery multiplication,
+ * so `c` is `a * b * 2^-16`, like `poly_mul_scalar()`; the base case
+ * multiply factors in `MUL_AVX512_ZETAS` are in Montgomery form.
+ *
+ * @param[out] c Product polynomial, in the NTT domain.
+ * @param[in] a Input polynomial, in the NTT domain.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_mul_avx512(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 32) {
+    const __m512i x = _mm512_loadu_si512((void*) (a->cs + i)),
+                  y = _mm512_loadu_si512((void*) (b->cs + i)),
+                  ys = _mm512_rol_epi32(y, 16),
+                  zs = _mm512_loadu_si512((void*) (MUL_AVX512_ZETAS + i));
+
+    // even lanes: a0 * b0, odd lanes: a1 * b1 (times 2^-16)
+    const __m512i p = avx512_mul_mont(x, y, avx512_mont_qinv(y));
+
+    // even lanes: a0 * b1, odd lanes: a1 * b0 (times 2^-16)
+    const __m512i q = avx512_mul_mont(x, ys, avx512_mont_qinv(ys));
+
+    // odd lanes: a1 * b1 * zeta (times 2^-16)
+    const __m512i pz = avx512_mul_mont(p, zs, avx512_mont_qinv(zs));
+
+    // even lanes: a0 * b0 + a1 * b1 * zeta, odd lanes: a0 * b1 + a1 * b0
+    const __m512i c0 = _mm512_add_epi16(p, _mm512_rol_epi32(pz, 16)),
+                  c1 = _mm512_add_epi16(q, _mm512_rol_epi32(q, 16)),
+                  r = _mm512_mask_blend_epi16(0xaaaaaaaa, c0, c1);
+    _mm512_storeu_si512((void*) (c->cs + i), r);
+  }
+}
+
+/**
+ * Montgomery reduce the 32-bit sums in `c0` and `c1` and interleave
+ * the results.  See `avx2_mont_reduce_pairs()`.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i avx512_mont_reduce_pairs(const __m512i c0, const __m512i c1) {
+  const __m512i lo = _mm512_mask_blend_epi16(0xaaaaaaaa, c0, _mm512_slli_epi32(c1, 16)),
+                hi = _mm512_mask_blend_epi16(0xaaaaaaaa, _mm512_srli_epi32(c0, 16), c1),
+                t = _mm512_mullo_epi16(lo, _mm512_set1_epi16(QINV));
+  return _mm512_sub_epi16(hi, _mm512_mulhi_epi16(t, _mm512_set1_epi16(Q)));
+}
+
+/**
+ * Multiply `n` pairs of polynomials `a[i]` and `b[i]`, sum the
+ * products, and store the sum in `c` (AVX-512 implementation).
+ *
+ * Produces output congruent to `poly_basemul_acc_scalar()`, with the
+ * same bounds.  See `poly_basemul_acc_avx2()`.
+ *
+ * @param[out] c Sum of products, in the NTT domain.
+ * @param[in] a Input polynomials, in the NTT domain.
+ * @param[in] b Input polynomials, in the NTT domain.
+ * @param[in] bc Mulcaches of `b` (optional, may be `NULL`).
+ * @param[in] n Number of products (at most 4).
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_basemul_acc_avx512(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b, const poly_mulcache_t * const restrict bc, const size_t n) {
+  for (size_t i = 0; i < 256; i += 32) {
+    const __m512i zs = _mm512_loadu_si512((void*) (MUL_AVX512_ZETAS + i)),
+                  zqs = avx512_mont_qinv(zs);
+
+    __m512i c0 = _mm512_setzero_si512(),
+            c1 = _mm512_setzero_si512();
+    for (size_t j = 0; j < n; j++) {
+      const __m512i x = _mm512_loadu_si512((void*) (a[j].cs + i)),
+                    y = _mm512_loadu_si512((void*) (b[j].cs + i)),
+                    yz = bc ? _mm512_loadu_si512((void*) (bc[j].cs + i)) : _mm512_mask_blend_epi16(0xaaaaaaaa, y, avx512_mul_mont(y, zs, zqs)), // b0, b1 * zeta
+                    ys = _mm512_rol_epi32(y, 16); // b1, b0
+
+      // each term is below 2 * Q^2, so 4 terms are below Q * 2^15
+      c0 = _mm512_add_epi32(c0, _mm512_madd_epi16(x, yz));
+      c1 = _mm512_add_epi32(c1, _mm512_madd_epi16(x, ys));
+    }
+
+    _mm512_storeu_si512((void*) (c->cs + i), avx512_mont_reduce_pairs(c0, c1));
+  }
+}
+
+/**
+ * Compute mulcache `bc` of polynomial `b` (AVX-512 implementation).
+ *
+ * @param[out] bc Mulcache of `b`.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_mulcache_compute_avx512(poly_mulcache_t * const restrict bc, const poly_t * const restrict b) {
+  for (size_t i = 0; i < 256; i += 32) {
+    const __m512i zs = _mm512_loadu_si512((void*) (MUL_AVX512_ZETAS + i)),
+                  y = _mm512_loadu_si512((void*) (b->cs + i));
+    _mm512_storeu_si512((void*) (bc->cs + i), _mm512_mask_blend_epi16(0xaaaaaaaa, y, avx512_mul_mont(y, zs, avx512_mont_qinv(zs))));
+  }
+}
+/**
+ * Pack 12-bit coefficients of polynomial `a` and serialize them into
+ * 384 bytes of the output buffer `out` (AVX-512 implementation).  See
+ * `poly_encode_avx2()`.
+ *
+ * Stores 32 coefficients (48 bytes) per step with a masked store.
+ *
+ * @param[out] out Output buffer (384 bytes).
+ * @param[in] a Input polynomial.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void poly_encode_avx512(uint8_t out[static 384], const poly_t * const a) {
+  // move the 3 low bytes of each 32-bit lane to the first 12 bytes of
+  // each 128-bit lane, then move those to the first 48 bytes
+  const __m512i idx = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)),
+                perm = _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15),
+                ms = _mm512_set1_epi32(0x10000001); // 1, 2^12
+
+  for (size_t i = 0; i < 8; i++) {
+    const __m512i v = _mm512_loadu_si512((void*) (a->cs + 32 * i)),
+                  w = _mm512_madd_epi16(v, ms); // a0 | (a1 << 12)
+    _mm512_mask_storeu_epi8(out + 48 * i, 0xffffffffffffULL, _mm512_permutexvar_epi32(perm, _mm512_shuffle_epi8(w, idx)));
+  }
+}
+
+/**
+ * Deserialize 384-byte buffer `b` as 256 12-bit integers, reduce them
+ * modulo Q, and save them as the coefficients of polynomial `p`
+ * (AVX-512 implementation).  See `poly_decode_avx2()`.
+ *
+ * Loads 32 integers (48 bytes) per step with a masked load and spreads
+ * them to 12 bytes per 128-bit lane before unpacking them.
+ *
+ * @param[out] p Output polynomial.
+ * @param[in] b Input buffer (384 bytes).
+ * @return True if every integer was less than Q.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static bool poly_decode_avx512(poly_t * const p, const uint8_t b[static 384]) {
+  // move 32-bit words 0-2, 3-5, 6-8, and 9-11 to the 128-bit lanes,
+  // then spread each lane's 12 bytes to 2 bytes per 16-bit lane
+  const __m512i perm = _mm512_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0, 6, 7, 8, 0, 9, 10, 11, 0),
+                idx = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11)),
+                m12 = _mm512_set1_epi16(0xfff),
+                qs = _mm512_set1_epi16(Q);
+
+  __mmask32 bad = 0; // lanes with integers >= Q
+  for (size_t i = 0; i < 8; i++) {
+    const __m512i v = _mm512_shuffle_epi8(_mm512_permutexvar_epi32(perm, _mm512_maskz_loadu_epi8(0xffffffffffffULL, b + 48 * i)), idx),
+                  ds = _mm512_mask_blend_epi16(0xaaaaaaaa, _mm512_and_si512(v, m12), _mm512_srli_epi16(v, 4));
+
+    bad |= _mm512_cmpge_epu16_mask(ds, qs);
+    _mm512_storeu_si512((void*) (p->cs + 32 * i), _mm512_min_epu16(ds, _mm512_sub_epi16(ds, qs)));
+  }
+
+  return !bad;
+}
+
+#endif /* FIPS203IPD_AVX512 */
+
+#ifdef FIPS203IPD_AVX512VBMI
+/**
+ * Compress coefficients of polynomial `p` to `d` bits and serialize
+ * the compressed values as `32 * d` bytes in output buffer `out`
+ * (AVX-512 VBMI implementation).
+ *
+ * Used by `poly_encode_{11,10,5,4}bit()`.  Compresses 32 coefficients
+ * per vector as in `poly_compress_vec()`, squeezes the 4 values in each
+ * 64-bit lane into the low `4 * d` bits of the lane with `vpmaddwd` and
+ * variable shifts, and then moves the bytes of all 8 lanes to their
+ * packed positions with two `vpermt2b` permutes (see `PACK_VBMI_IDX`)
+ * and one masked store.
+ *
+ * @param[out] out Output buffer (`32 * d` bytes).
+ * @param[in] p Input polynomial (canonical coefficients).
+ * @param[in] d Number of bits in compressed values (11, 10, 5, or 4).
+ */
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static void poly_encode_bits_vbmi(uint8_t * const out, const poly_t * const p, const uint8_t d) {
+  const size_t row = (d > 5) ? (11 - d) : (7 - d); // table row
+  const __mmask64 store_mask = (1ULL << (4 * d)) - 1;
+  const __m128i ds = _mm_cvtsi32_si128(d);
+  const __m512i qs = _mm512_set1_epi16(Q),
+                q1s = _mm512_set1_epi16(Q - 1),
+                hs = _mm512_set1_epi16((Q - 1) / 2),
+                ms = _mm512_set1_epi16((1 << (13 + d)) / Q),
+                ones = _mm512_set1_epi16(1),
+                mask = _mm512_set1_epi16((1 << d) - 1),
+                fs = _mm512_set1_epi32((1 << (16 + d)) | 1), // (1, 2^d)
+                s32 = _mm512_set1_epi64(32 - 2 * d), // 2d-bit pairs to 64-bit lanes
+                s64 = _mm512_broadcast_i32x4(_mm_set_epi64x((4 * d) % 8, 0)),
+                even = _mm512_loadu_si512((void*) PACK_VBMI_IDX[row][0]),
+                odd = _mm512_loadu_si512((void*) PACK_VBMI_IDX[row][1]),
+                zero = _mm512_setzero_si512();
+
+  for (size_t i = 0; i < 8; i++) {
+    // y = compress(x, d) (see poly_compress_vec())
+    const __m512i x = _mm512_loadu_si512((void*) (p->cs + 32 * i)),
+                  q = _mm512_mulhi_epi16(_mm512_slli_epi16(x, 3), ms),
+                  t = _mm512_sub_epi16(_mm512_add_epi16(_mm512_sll_epi16(x, ds), hs), _mm512_mullo_epi16(q, qs)),
+                  y = _mm512_and_si512(_mm512_mask_add_epi16(q, _mm512_cmpgt_epi16_mask(t, q1s), q, ones), mask);
+
+    // squeeze each 64-bit lane, then move the bytes into place
+    __m512i z = _mm512_madd_epi16(y, fs);
+    z = _mm512_srlv_epi64(_mm512_sllv_epi32(z, s32), s32);
+    z = _mm512_sllv_epi64(z, s64);
+    z = _mm512_or_si512(_mm512_permutex2var_epi8(z, even, zero), _mm512_permutex2var_epi8(z, odd, zero));
+
+    _mm512_mask_storeu_epi8(out + 4 * d * i, store_mask, z);
+  }
+}
+
+/**
+ * Deserialize `32 * d` bytes of packed `d`-bit values from input
+ * buffer `b`, decompress them, and save them as the coefficients of
+ * polynomial `p` (AVX-512 VBMI implementation).
+ *
+ * Used by `poly_decode_{11,10,5,4}bit()`.  Reads 32 values (`4 * d`
+ * bytes) per vector with a masked load, moves the 8 bytes which hold
+ * the 4 values of each 64-bit lane into the lane with `vpermb`, and
+ * extracts each value with `vpmultishiftqb` so that it ends at bit 14
+ * of its 16-bit lane (see `UNPACK_VBMI_IDX` and `UNPACK_VBMI_SHIFTS`).
+ * Each value `x` is then decompressed with `vpmulhrsw` as
+ * `((x << (15 - d)) * Q + 2^14) >> 15`, which is exactly
+ * `ct_decompress(x, d)`.
+ *
+ * @param[out] p Output polynomial.
+ * @param[in] b Input buffer (`32 * d` bytes).
+ * @param[in] d Number of bits in compressed values (11, 10, 5, or 4).
+ */
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static void poly_decode_bits_vbmi(poly_t * const p, const uint8_t * const b, const uint8_t d) {
+  const size_t row = (d > 5) ? (11 - d) : (7 - d); // table row
+  const __mmask64 load_mask = (1ULL << (4 * d)) - 1;
+  const __m512i idx = _mm512_loadu_si512((void*) UNPACK_VBMI_IDX[row]),
+                shifts = _mm512_loadu_si512((void*) UNPACK_VBMI_SHIFTS[row]),
+                mask = _mm512_set1_epi16(((1 << d) - 1) << (15 - d)),
+                qs = _mm512_set1_epi16(Q);
+
+  for (size_t i = 0; i < 8; i++) {
+    const __m512i x = _mm512_permutexvar_epi8(idx, _mm512_maskz_loadu_epi8(load_mask, b + 4 * d * i)),
+                  y = _mm512_and_si512(_mm512_multishift_epi64_epi8(shifts, x), mask);
+    _mm512_storeu_si512((void*) (p->cs + 32 * i), _mm512_mulhrs_epi16(y, qs));
+  }
+}
+#endif /* FIPS203IPD_AVX512VBMI */
+
+#ifdef FIPS203IPD_AVX512VBMI2
+/**
+ * Parse `len` bytes of SHAKE128 output in `buf` as 12-bit candidates
+ * and append the candidates which are less than Q to polynomial `a`,
+ * starting at coefficient `n` (AVX-512 VBMI2 implementation).  See
+ * `poly_sample_ntt_parse_scalar()`.
+ *
+ * Reads 32 candidates (48 bytes) per step with a masked load, spreads
+ * the 12 bytes of each 128-bit lane to 16-bit lanes as in
+ * `poly_sample_ntt_parse_avx2()`, compares the candidates with Q, and
+ * appends the accepted ones with one `vpcompressw` store.  Once fewer
+ * than 32 coefficients are left, `pdep` keeps only as many accepted
+ * candidates as fit, so nothing past the last coefficient is written
+ * and the last coefficients need no branchy scalar tail.  Bytes after
+ * the last 48-byte step are parsed by the reference C implementation.
+ *
+ * @param[out] a Output polynomial.
+ * @param[in] n Number of coefficients already sampled.
+ * @param[in] buf XOF output.
+ * @param[in] len Length of XOF output, in bytes (multiple of 3).
+ * @return Number of coefficients sampled.
+ */
+__attribute__((target("avx512f,avx512bw,avx512vbmi2,bmi2")))
+static size_t poly_sample_ntt_parse_vbmi2(poly_t * const a, size_t n, const uint8_t * const buf, const size_t len) {
+  // bytes 12 * i to 12 * i + 15 in 128-bit lane i (dwords 3 * i to
+  // 3 * i + 3), spread to 2 bytes per 16-bit lane
+  const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6, 6, 7, 8, 9, 9, 10, 11, 12),
+                idx = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11)),
+                m12 = _mm512_set1_epi16(0xfff),
+                qs = _mm512_set1_epi16(Q);
+
+  size_t ofs = 0;
+  for (; ofs + 48 <= len && n < 256; ofs += 48) {
+    const __m512i v = _mm512_shuffle_epi8(_mm512_permutexvar_epi32(lanes, _mm512_maskz_loadu_epi8(0xffffffffffffULL, buf + ofs)), idx),
+                  ds = _mm512_mask_srli_epi16(_mm512_and_si512(v, m12), 0xaaaaaaaa, v, 4); // candidates
+    __mmask32 ok = _mm512_cmplt_epu16_mask(ds, qs); // accepted candidates
+    if (n > 256 - 32) {
+      ok = _pdep_u32((1U << (256 - n)) - 1, ok); // first 256 - n accepted candidates
+    }
+
+    // left-pack accepted candidates and append them
+    _mm512_mask_compressstoreu_epi16(a->cs + n, ok, ds);
+    n += __builtin_popcount(ok);
+  }
+
+  // parse remaining bytes
+  return poly_sample_ntt_parse_scalar(a, n, buf + ofs, len - ofs);
+}
+#endif /* FIPS203IPD_AVX512VBMI2 */
+
+// Instruction set extensions used by the polynomial kernels (same
+// values as the public fips203ipd_backend_t).
+typedef enum {
+  ISA_SCALAR = FIPS203IPD_BACKEND_SCALAR, // reference C
+  ISA_VEC = FIPS203IPD_BACKEND_VEC, // portable vector extensions
+  ISA_AVX2 = FIPS203IPD_BACKEND_AVX2, // AVX2
+  ISA_AVX512 = FIPS203IPD_BACKEND_AVX512, // AVX-512F and AVX-512BW
+  ISA_AVX512VBMI = FIPS203IPD_BACKEND_AVX512VBMI, // AVX-512F, AVX-512BW, and AVX-512 VBMI
+  ISA_AVX512VBMI2 = FIPS203IPD_BACKEND_AVX512VBMI2, // AVX-512F, AVX-512BW, AVX-512 VBMI, and AVX-512 VBMI2
+} isa_t;
+
+// Backend names (indexed by isa_t).
+static const char * const BACKEND_NAMES[] = { "scalar", "vec", "avx2", "avx512", "avx512vbmi", "avx512vbmi2" };
+
+/**
+ * Get the best instruction set extension supported by this CPU (and
+ * compiled in).
+ *
+ * @return Instruction set extension.
+ */
+static inline isa_t cpu_isa(void) {
+#ifdef FIPS203IPD_AVX512VBMI2
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi") && __builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("bmi2")) {
+    return ISA_AVX512VBMI2;
+  }
+#endif /* FIPS203IPD_AVX512VBMI2 */
+
+#ifdef FIPS203IPD_AVX512VBMI
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi")) {
+    return ISA_AVX512VBMI;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
+
+#ifdef FIPS203IPD_AVX512
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return ISA_AVX512;
+  }
+#endif /* FIPS203IPD_AVX512 */
+
+#ifdef FIPS203IPD_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return ISA_AVX2;
+  }
+#endif /* FIPS203IPD_AVX2 */
+
+#ifdef FIPS203IPD_VEC
+  return ISA_VEC;
+#else
+  return ISA_SCALAR;
+#endif /* FIPS203IPD_VEC */
+}
+
+/**
+ * Check whether the kernels of instruction set extension `isa` were
+ * compiled in (see FIPS203IPD_NO_VEC, FIPS203IPD_NO_AVX2,
+ * FIPS203IPD_NO_AVX512, FIPS203IPD_NO_AVX512VBMI, and
+ * FIPS203IPD_NO_AVX512VBMI2).
+ *
+ * @param[in] isa Instruction set extension.
+ *
+ * @return True if the kernels of `isa` were compiled in.
+ */
+static inline bool backend_compiled(const isa_t isa) {
+  switch (isa) {
+  case ISA_SCALAR:
+    return true;
+  case ISA_VEC:
+#ifdef FIPS203IPD_VEC
+    return true;
+#else
+    return false;
+#endif /* FIPS203IPD_VEC */
+  case ISA_AVX2:
+#ifdef FIPS203IPD_AVX2
+    return true;
+#else
+    return false;
+#endif /* FIPS203IPD_AVX2 */
+  case ISA_AVX512:
+#ifdef FIPS203IPD_AVX512
+    return true;
+#else
+    return false;
+#endif /* FIPS203IPD_AVX512 */
+  case ISA_AVX512VBMI:
+#ifdef FIPS203IPD_AVX512VBMI
+    return true;
+#else
+    return false;
+#endif /* FIPS203IPD_AVX512VBMI */
+  case ISA_AVX512VBMI2:
+#ifdef FIPS203IPD_AVX512VBMI2
+    return true;
+#else
+    return false;
+#endif /* FIPS203IPD_AVX512VBMI2 */
+  default:
+    return false;
+  }
+}
+
+// Instruction set extension used by the polynomial kernels (the
+// backend).  Resolved once at startup by backend_init(), and changed
+// with fips203ipd_backend_set() (e.g., by the tests and benchmarks, to
+// compare kernels).
+static isa_t backend = ISA_SCALAR;
+
+/**
+ * Get the instruction set extension used by the polynomial kernels.
+ *
+ * @return Instruction set extension.
+ */
+static inline isa_t poly_isa(void) {
+  return backend;
+}
+
+fips203ipd_backend_t fips203ipd_backend(void) {
+  return (fips203ipd_backend_t) backend;
+}
+
+const char *fips203ipd_backend_name(const fips203ipd_backend_t b) {
+  return ((size_t) b < sizeof(BACKEND_NAMES) / sizeof(BACKEND_NAMES[0])) ? BACKEND_NAMES[b] : NULL;
+}
+
+bool fips203ipd_backend_set(const fips203ipd_backend_t b) {
+  if ((isa_t) b > cpu_isa() || !backend_compiled((isa_t) b)) {
+    return false;
+  }
+  backend = (isa_t) b;
+
+  // use the matching keccak permutations, or the best ones below them if
+  // sha3.c was built without them
+  sha3_backend_t sb = (b >= FIPS203IPD_BACKEND_AVX512) ? SHA3_BACKEND_AVX512 : ((b >= FIPS203IPD_BACKEND_AVX2) ? SHA3_BACKEND_AVX2 : SHA3_BACKEND_SCALAR);
+  while (!sha3_backend_set(sb)) {
+    sb--;
+  }
+
+  return true;
+}
+
+#ifdef __GNUC__
+/**
+ * Resolve the backend at startup: the best one supported by this CPU,
+ * or the one named by the FIPS203IPD_BACKEND environment variable, if
+ * it is supported.
+ *
+ * Runs after the constructor which resolves the Keccak permutation
+ * backend in sha3.c (priority 101), so the environment variable
+ * overrides both.
+ */
+__attribute__((constructor(102)))
+static void backend_init(void) {
+#if defined(FIPS203IPD_AVX2) || defined(FIPS203IPD_AVX512)
+  __builtin_cpu_init(); // needed before __builtin_cpu_supports() in constructors
+#endif /* FIPS203IPD_AVX2 || FIPS203IPD_AVX512 */
+  backend = cpu_isa();
+
+  const char * const name = getenv("FIPS203IPD_BACKEND");
+  for (size_t i = 0; name && i < sizeof(BACKEND_NAMES) / sizeof(BACKEND_NAMES[0]); i++) {
+    if (!strcmp(name, BACKEND_NAMES[i])) {
+      fips203ipd_backend_set((fips203ipd_backend_t) i);
+    }
+  }
+}
+#endif /* __GNUC__ */
+
+/**
+ * Compute in-place number-theoretic transform (NTT) of polynomial `p`.
+ * Input coefficients must satisfy |x| < Q; output coefficients satisfy
+ * |x| <= (Q - 1) / 2 (see `poly_t`).
+ *
+ * Dispatches to the AVX-512, AVX2, portable vector, or reference C
+ * implementation.
+ *
+ * @param[in,out] p Polynomial.
+ */
+static inline void poly_ntt(poly_t * const p) {
+  POLY_CHECK_BOUND(p, Q);
+
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_ntt_avx512(p);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    poly_ntt_avx2(p);
+    break;
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_VEC
+  case ISA_VEC:
+    poly_ntt_vec(p);
+    break;
+#endif /* FIPS203IPD_VEC */
+  default:
+    poly_ntt_scalar(p);
+  }
+
+  POLY_CHECK_BOUND(p, (Q + 1) / 2);
+}
+
+/**
+ * Compute in-place inverse number-theoretic transform (NTT) of
+ * polynomial `p`.  Input and output coefficients satisfy |x| < Q (see
+ * `poly_t`).
+ *
+ * Dispatches to the AVX-512, AVX2, portable vector, or reference C
+ * implementation.
+ *
+ * @param[in,out] p Polynomial.
+ */
+static inline void poly_inv_ntt(poly_t * const p) {
+  POLY_CHECK_BOUND(p, Q);
+
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_inv_ntt_avx512(p);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    poly_inv_ntt_avx2(p);
+    break;
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_VEC
+  case ISA_VEC:
+    poly_inv_ntt_vec(p);
+    break;
+#endif /* FIPS203IPD_VEC */
+  default:
+    poly_inv_ntt_scalar(p);
+  }
+
+  POLY_CHECK_BOUND(p, Q);
+}
+
+/**
+ * Add polynomial `a` to polynomial `b` component-wise, and store the
+ * sum in `a`.  The sum is not reduced (see `poly_t`).
+ *
+ * Dispatches to the AVX-512, portable vector, or reference C
+ * implementation.
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+static inline void poly_add(poly_t * const restrict a, const poly_t * const restrict b) {
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_add_avx512(a, b);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_VEC
+  case ISA_AVX2: // no AVX2 kernel
+  case ISA_VEC:
+    poly_add_vec(a, b);
+    break;
+#endif /* FIPS203IPD_VEC */
+  default:
+    poly_add_scalar(a, b);
+  }
+
+  POLY_CHECK_BOUND(a, 8 * Q);
+}
+
+/**
+ * Subtract polynomial `b` from polynomial `a` component-wise, and store the
+ * result in `a`.  The difference is not reduced (see `poly_t`).
+ *
+ * Dispatches to the AVX-512, portable vector, or reference C
+ * implementation.
+ *
+ * @param[in,out] a Polynomial.
+ * @param[in] b Polynomial.
+ */
+static inline void poly_sub(poly_t * const restrict a, const poly_t * const restrict b) {
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_sub_avx512(a, b);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_VEC
+  case ISA_AVX2: // no AVX2 kernel
+  case ISA_VEC:
+    poly_sub_vec(a, b);
+    break;
+#endif /* FIPS203IPD_VEC */
+  default:
+    poly_sub_scalar(a, b);
+  }
+
+  POLY_CHECK_BOUND(a, 8 * Q);
+}
+
+/**
+ * Multiply `a` and `b` and store the product in `c`.
+ *
+ * Note: `a` and `b` are assumed to be in the NTT domain.  Input
+ * coefficients must satisfy |x| < Q; output coefficients satisfy
+ * |x| < 2Q (see `poly_t`).
+ *
+ * Dispatches to the AVX-512, portable vector, or reference C
+ * implementation.
+ *
+ * @param[out] c Product polynomial, in the NTT domain.
+ * @param[in] a Input polynomial, in the NTT domain.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+static inline void poly_mul(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b) {
+  POLY_CHECK_BOUND(a, Q);
+  POLY_CHECK_BOUND(b, Q);
+
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_mul_avx512(c, a, b);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_VEC
+  case ISA_AVX2: // no AVX2 kernel
+  case ISA_VEC:
+    poly_mul_vec(c, a, b);
+    break;
+#endif /* FIPS203IPD_VEC */
+  default:
+    poly_mul_scalar(c, a, b);
+  }
+
+  POLY_CHECK_BOUND(c, 2 * Q);
+}
+
+/**
+ * Multiply `n` pairs of polynomials `a[i]` and `b[i]`, sum the
+ * products, and store the sum in `c`.
+ *
+ * Fused replacement for `n` calls to `poly_mul()` and `poly_add()`: the
+ * products are accumulated in 32 bits and reduced once.  If `bc` is
+ * not `NULL`, then it must hold the mulcaches of `b` (see
+ * `poly_mulcache_compute()`), which saves one multiply per odd
+ * coefficient of each product.
+ *
+ * Note: `a` and `b` are assumed to be in the NTT domain.  Input
+ * coefficients must satisfy |x| < Q and `n` must be at most 4; output
+ * coefficients satisfy |x| < Q (see `poly_t`).
+ *
+ * Dispatches to the AVX-512, AVX2, portable vector, or reference C
+ * implementation.
+ *
+ * @param[out] c Sum of products, in the NTT domain.
+ * @param[in] a Input polynomials, in the NTT domain.
+ * @param[in] b Input polynomials, in the NTT domain.
+ * @param[in] bc Mulcaches of `b` (optional, may be `NULL`).
+ * @param[in] n Number of products (at most 4).
+ */
+static inline void poly_basemul_acc(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b, const poly_mulcache_t * const restrict bc, const size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    POLY_CHECK_BOUND(a + i, Q);
+    POLY_CHECK_BOUND(b + i, Q);
+  }
+
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_basemul_acc_avx512(c, a, b, bc, n);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    poly_basemul_acc_avx2(c, a, b, bc, n);
+    break;
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_VEC
+  case ISA_VEC:
+    poly_basemul_acc_vec(c, a, b, bc, n);
+    break;
+#endif /* FIPS203IPD_VEC */
+  default:
+    poly_basemul_acc_scalar(c, a, b, bc, n);
+  }
+
+  POLY_CHECK_BOUND(c, Q);
+}
+
+/**
+ * Compute mulcache `bc` of polynomial `b`, for use as the right-hand
+ * operand of several `poly_basemul_acc()` calls.
+ *
+ * Note: `b` is assumed to be in the NTT domain.  Input coefficients
+ * must satisfy |x| < Q.
+ *
+ * Dispatches to the AVX-512, AVX2, portable vector, or reference C
+ * implementation.
+ *
+ * @param[out] bc Mulcache of `b`.
+ * @param[in] b Input polynomial, in the NTT domain.
+ */
+static inline void poly_mulcache_compute(poly_mulcache_t * const restrict bc, const poly_t * const restrict b) {
+  POLY_CHECK_BOUND(b, Q);
+
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_mulcache_compute_avx512(bc, b);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    poly_mulcache_compute_avx2(bc, b);
+    break;
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_VEC
+  case ISA_VEC:
+    poly_mulcache_compute_vec(bc, b);
+    break;
+#endif /* FIPS203IPD_VEC */
+  default:
+    poly_mulcache_compute_scalar(bc, b);
+  }
+}
+
+/**
+ * Compress coefficients of polynomial `p` to `d` bits and store the
+ * compressed values in `ys`.
+ *
+ * Shared by `poly_encode_{11,10,5,4}bit()`.  Dispatches to the
+ * portable vector implementation if it is compiled in; otherwise the
+ * loop is a flat multiply-and-shift with no branches or divisions so
+ * that the compiler can vectorize it.
+ *
+ * @param[out] ys Compressed values (256 elements).
+ * @param[in] p Input polynomial.
+ * @param[in] d Number of bits in compressed values (1-11).
+ */
+static inline void poly_compress(uint16_t ys[static 256], const poly_t * const p, const uint8_t d) {
+  POLY_CHECK_CANONICAL(p);
+
+#ifdef FIPS203IPD_VEC
+  if (poly_isa() >= ISA_VEC) {
+    poly_compress_vec(ys, p, d);
+    return;
+  }
+#endif /* FIPS203IPD_VEC */
+
+  for (size_t i = 0; i < 256; i++) {
+    ys[i] = ct_compress(p->cs[i], d);
+  }
+}
+
+/**
+ * Define function which samples coefficients of polynomial `p` from
+ * CBD(ETA) using `64 * ETA` bytes of PRF output `buf`.
+ *
+ * Dispatches to the AVX2 or reference C implementation.
+ *
+ * @param[out] p Output polynomial, coefficients in the range [-ETA, ETA].
+ * @param[in] buf PRF output (`64 * ETA` bytes).
+ */
+#ifdef FIPS203IPD_AVX2
+#define DEF_POLY_CBD(ETA) \
+  static inline void poly_cbd ## ETA (poly_t * const p, const uint8_t buf[static 64 * ETA]) { \
+    if (poly_isa() >= ISA_AVX2) { \
+      poly_cbd ## ETA ## _avx2(p, buf); \
+    } else { \
+      poly_cbd ## ETA ## _scalar(p, buf); \
+    } \
+    POLY_CHECK_BOUND(p, ETA + 1); \
+  }
+#else
+#define DEF_POLY_CBD(ETA) \
+  static inline void poly_cbd ## ETA (poly_t * const p, const uint8_t buf[static 64 * ETA]) { \
+    poly_cbd ## ETA ## _scalar(p, buf); \
+    POLY_CHECK_BOUND(p, ETA + 1); \
+  }
+#endif /* FIPS203IPD_AVX2 */
+
+// define poly_cbd3() (PKE512_ETA1)
+DEF_POLY_CBD(3)
+
+// define poly_cbd2() (PKE512_ETA2, PKE768_ETA{1,2}, PKE1024_ETA{1,2}
+DEF_POLY_CBD(2)
+
+/**
+ * Parse `len` bytes of SHAKE128 output in `buf` as 12-bit candidates
+ * and append the candidates which are less than Q to polynomial `a`,
+ * starting at coefficient `n`.  Stops once `a` has 256 coefficients.
+ * Coefficients after the returned count are unspecified.  Used by
+ * `poly_sample_ntt()`, `poly_sample_ntt_x4()`, and
+ * `poly_sample_ntt_x8()`.
+ *
+ * Dispatches to the AVX-512 VBMI2, AVX2, or reference C
+ * implementation.  AVX-512F and VBMI have no 16-bit compress
+ * (`vpcompressw` needs VBMI2), so those CPUs use the AVX2 kernel.
+ *
+ * @param[out] a Output polynomial.
+ * @param[in] n Number of coefficients already sampled.
+ * @param[in] buf XOF output.
+ * @param[in] len Length of XOF output, in bytes (multiple of 3).
+ * @return Number of coefficients sampled.
+ */
+static inline size_t poly_sample_ntt_parse(poly_t * const a, const size_t n, const uint8_t * const buf, const size_t len) {
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512VBMI2
+  case ISA_AVX512VBMI2:
+    return poly_sample_ntt_parse_vbmi2(a, n, buf, len);
+#endif /* FIPS203IPD_AVX512VBMI2 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX512VBMI: // no 16-bit compress
+  case ISA_AVX512:
+  case ISA_AVX2:
+    return poly_sample_ntt_parse_avx2(a, n, buf, len);
+#endif /* FIPS203IPD_AVX2 */
+  default:
+    return poly_sample_ntt_parse_scalar(a, n, buf, len);
+  }
+}
+
+/**
+ * Initialize polynomial `a` by sampling coefficients in the NTT domain
+ * from SHAKE128 extendable output function (XOF) seeded by 32-byte
+ * value `rho`, byte `i`, and byte `j`.
+ *
+ * @param[out] a Output polynomial with coefficients in the NTT domain.
+ * @param[in] rho 32-byte input value used as XOF seed.
+ * @param[in] i One byte input value used as XOF seed.
+ * @param[in] j One byte input value used as XOF seed.
+ */
+static inline void poly_sample_ntt(poly_t * const a, const uint8_t rho[static 32], const uint8_t i, const uint8_t j) {
+  // init xof by absorbing rho, i, and j
+  sha3_xof_t xof = { 0 };
+  xof_init(&xof, rho, i, j);
+
+  // squeeze SAMPLE_NTT_INIT_BLOCKS blocks from xof up front
+  uint8_t buf[SAMPLE_NTT_INIT_BLOCKS * SHAKE128_RATE] = { 0 };
+  shake128_xof_squeeze(&xof, buf, sizeof(buf));
+  size_t n = poly_sample_ntt_parse(a, 0, buf, sizeof(buf));
+
+  while (n < 256) {
+    // buffer exhausted, squeeze another block from xof
+    shake128_xof_squeeze(&xof, buf, SHAKE128_RATE);
+    n = poly_sample_ntt_parse(a, n, buf, SHAKE128_RATE);
+  }
+}
+
+/**
+ * Initialize four polynomials in `as` by sampling coefficients in the
+ * NTT domain from four SHAKE128 XOFs at once.  Polynomial `as[k]` is
+ * seeded by 32-byte value `rho`, byte `is[k]`, and byte `js[k]`.
+ *
+ * Produces the same output as four calls to `poly_sample_ntt()`, but
+ * uses the 4-way SHAKE128 XOF so the four Keccak permutations run in
+ * parallel.  All four XOFs are squeezed in lockstep, so a polynomial
+ * which needs extra blocks costs a 4-way permutation rather than a
+ * single one.
+ *
+ * @param[out] as Four output polynomials with coefficients in the NTT domain.
+ * @param[in] rho 32-byte input value used as XOF seed.
+ * @param[in] is Four one byte input values used as XOF seeds.
+ * @param[in] js Four one byte input values used as XOF seeds.
+ */
+static inline void poly_sample_ntt_x4(poly_t as[static 4], const uint8_t rho[static 32], const uint8_t is[static 4], const uint8_t js[static 4]) {
+  // build seeds (rho || i || j)
+  uint8_t seeds[4][34] = { 0 };
+  for (size_t k = 0; k < 4; k++) {
+    memcpy(seeds[k], rho, 32);
+    seeds[k][32] = is[k];
+    seeds[k][33] = js[k];
+  }
+
+  // init 4-way xof by absorbing seeds
+  sha3_xof_x4_t xof = { 0 };
+  shake128x4_xof_init(&xof);
+  const uint8_t * const ms[4] = { seeds[0], seeds[1], seeds[2], seeds[3] };
+  shake128x4_xof_absorb(&xof, ms, sizeof(seeds[0]));
+
+  // squeeze SAMPLE_NTT_INIT_BLOCKS blocks from each xof up front
+  uint8_t bufs[4][SAMPLE_NTT_INIT_BLOCKS * SHAKE128_RATE] = { 0 };
+  uint8_t * const dsts[4] = { bufs[0], bufs[1], bufs[2], bufs[3] };
+  shake128x4_xof_squeeze(&xof, dsts, sizeof(bufs[0]));
+
+  size_t ns[4] = { 0 };
+  for (size_t k = 0; k < 4; k++) {
+    ns[k] = poly_sample_ntt_parse(as + k, 0, bufs[k], sizeof(bufs[k]));
+  }
+
+  while (ns[0] < 256 || ns[1] < 256 || ns[2] < 256 || ns[3] < 256) {
+    // at least one buffer exhausted, squeeze another block from each xof
+    shake128x4_xof_squeeze(&xof, dsts, SHAKE128_RATE);
+    for (size_t k = 0; k < 4; k++) {
+      ns[k] = poly_sample_ntt_parse(as + k, ns[k], bufs[k], SHAKE128_RATE);
+    }
+  }
+}
+
+/**
+ * Initialize eight polynomials in `as` by sampling coefficients in the
+ * NTT domain from eight SHAKE128 XOFs at once.  Polynomial `as[k]` is
+ * seeded by 32-byte value `rho`, byte `is[k]`, and byte `js[k]`.
+ *
+ * Same as `poly_sample_ntt_x4()`, but uses the 8-way SHAKE128 XOF.
+ *
+ * @param[out] as Eight output polynomials with coefficients in the NTT domain.
+ * @param[in] rho 32-byte input value used as XOF seed.
+ * @param[in] is Eight one byte input values used as XOF seeds.
+ * @param[in] js Eight one byte input values used as XOF seeds.
+ */
+static inline void poly_sample_ntt_x8(poly_t as[static 8], const uint8_t rho[static 32], const uint8_t is[static 8], const uint8_t js[static 8]) {
+  // build seeds (rho || i || j)
+  uint8_t seeds[8][34] = { 0 };
+  const uint8_t *ms[8] = { 0 };
+  for (size_t k = 0; k < 8; k++) {
+    memcpy(seeds[k], rho, 32);
+    seeds[k][32] = is[k];
+    seeds[k][33] = js[k];
+    ms[k] = seeds[k];
+  }
+
+  // init 8-way xof by absorbing seeds
+  sha3_xof_x8_t xof = { 0 };
+  shake128x8_xof_init(&xof);
+  shake128x8_xof_absorb(&xof, ms, sizeof(seeds[0]));
+
+  // squeeze SAMPLE_NTT_INIT_BLOCKS blocks from each xof up front
+  uint8_t bufs[8][SAMPLE_NTT_INIT_BLOCKS * SHAKE128_RATE] = { 0 };
+  uint8_t *dsts[8] = { 0 };
+  for (size_t k = 0; k < 8; k++) {
+    dsts[k] = bufs[k];
+  }
+  shake128x8_xof_squeeze(&xof, dsts, sizeof(bufs[0]));
+
+  size_t ns[8] = { 0 }, done = 0;
+  for (size_t k = 0; k < 8; k++) {
+    ns[k] = poly_sample_ntt_parse(as + k, 0, bufs[k], sizeof(bufs[k]));
+    done += (ns[k] == 256);
+  }
+
+  while (done < 8) {
+    // at least one buffer exhausted, squeeze another block from each xof
+    shake128x8_xof_squeeze(&xof, dsts, SHAKE128_RATE);
+    done = 0;
+    for (size_t k = 0; k < 8; k++) {
+      ns[k] = poly_sample_ntt_parse(as + k, ns[k], bufs[k], SHAKE128_RATE);
+      done += (ns[k] == 256);
+    }
+  }
+}
+
+// Minimum number of remaining PRFs read by an 8-way pass of prfs(),
+// and of remaining matrix entries sampled by an 8-way pass of
+// mat_sample_ntt_pass(), for the current Keccak permutation backend of
+// sha3.c.  Without the AVX-512 8-way permutation, an 8-way pass costs
+// as much as two scalar 4-way passes, and more than two AVX2 ones, so
+// it is not used.
+static inline size_t prfs_x8_min(void) {
+  return (sha3_backend() >= SHA3_BACKEND_AVX512) ? 5 : SIZE_MAX;
+}
+
+// Minimum number of remaining PRFs read by a 4-way pass of prfs(), and
+// of remaining matrix entries sampled by a 4-way pass of
+// mat_sample_ntt_pass(), for the current Keccak permutation backend of
+// sha3.c.
+static inline size_t prfs_x4_min(void) {
+  return (sha3_backend() >= SHA3_BACKEND_AVX2) ? 3 : 4;
+}
+
+/**
+ * Get XOF seed bytes for `n` consecutive entries of the `k` by `k`
+ * matrix A hat, starting at entry `ofs` (row-major).  Entry `(i, j)` is
+ * seeded by `i` and `j`, or by `j` and `i` if `transpose` is true.
+ *
+ * @param[out] is First seed byte of each entry.
+ * @param[out] js Second seed byte of each entry.
+ * @param[in] ofs Offset of first entry.
+ * @param[in] n Number of entries.
+ * @param[in] k Matrix dimension (2, 3, or 4).
+ * @param[in] transpose Sample transposed matrix.
+ */
+static inline void mat_seed_ij(uint8_t * const is, uint8_t * const js, const size_t ofs, const size_t n, const size_t k, const bool transpose) {
+  for (size_t m = 0; m < n; m++) {
+    const uint8_t i = (ofs + m) / k, j = (ofs + m) % k;
+    is[m] = transpose ? j : i;
+    js[m] = transpose ? i : j;
+  }
+}
+
+/**
+ * Sample entries of the `k` by `k` matrix A hat into `a`, starting at
+ * entry `ofs` (row-major), with the widest pass which is worth using
+ * for the remaining entries (see `prfs()`) and which fits in `room`
+ * polynomials.  Entry `(i, j)` is seeded by `rho`, `i`, and `j`, or by
+ * `rho`, `j`, and `i` if `transpose` is true.
+ *
+ * A 4-way or 8-way pass writes all four or eight polynomials, even if
+ * fewer entries are left, so it is only used if `room` fits all of
+ * them.  `room` must be at least 1.
+ *
+ * Not inlined, so that the XOF states and buffers of the widest pass
+ * are only on the stack while the pass runs, rather than in the frame
+ * of every caller.
+ *
+ * @param[out] a Output entries (NTT domain).
+ * @param[in] room Number of polynomials available in `a`.
+ * @param[in] k Matrix dimension (2, 3, or 4).
+ * @param[in] rho 32-byte input value used as XOF seed.
+ * @param[in] transpose Sample transposed matrix.
+ * @param[in] ofs Offset of first entry (less than `k * k`).
+ *
+ * @return Number of entries sampled.
+ */
+static __attribute__((noinline)) size_t mat_sample_ntt_pass(poly_t * const a, const size_t room, const size_t k, const uint8_t rho[static 32], const bool transpose, const size_t ofs) {
+  const size_t left = k * k - ofs;
+
+#if FIPS203IPD_XOF_WAYS >= 8
+  if (left >= prfs_x8_min() && room >= 8) {
+    // sample up to eight entries at a time
+    uint8_t is[8] = { 0 }, js[8] = { 0 };
+    const size_t num = (left < 8) ? left : 8;
+    mat_seed_ij(is, js, ofs, num, k, transpose);
+    poly_sample_ntt_x8(a, rho, is, js);
+    return num;
+  }
+#endif /* FIPS203IPD_XOF_WAYS >= 8 */
+
+#if FIPS203IPD_XOF_WAYS >= 4
+  if (left >= prfs_x4_min() && room >= 4) {
+    // sample up to four entries at a time
+    uint8_t is[4] = { 0 }, js[4] = { 0 };
+    const size_t num = (left < 4) ? left : 4;
+    mat_seed_ij(is, js, ofs, num, k, transpose);
+    poly_sample_ntt_x4(a, rho, is, js);
+    return num;
+  }
+#endif /* FIPS203IPD_XOF_WAYS >= 4 */
+
+  // sample one entry
+  (void) left;
+  (void) room;
+  uint8_t i = 0, j = 0;
+  mat_seed_ij(&i, &j, ofs, 1, k, transpose);
+  poly_sample_ntt(a, rho, i, j);
+  return 1;
+}
+
+/**
+ * Sample the `k` by `k` matrix A hat into `a` (row-major),
+ * `FIPS203IPD_XOF_WAYS` entries at a time.  Entry `(i, j)` is seeded by
+ * `rho`, `i`, and `j`, or by `rho`, `j`, and `i` if `transpose` is true.
+ *
+ * With 8 ways, KEM1024 samples all 16 entries in two passes.  Entries
+ * left over after the widest pass are sampled with narrower passes.
+ * The sampled entries are converted to Montgomery form.
+ *
+ * @param[out] a Output matrix (`k * k` polynomials, NTT domain,
+ * Montgomery form).
+ * @param[in] k Matrix dimension (2, 3, or 4).
+ * @param[in] rho 32-byte input value used as XOF seed.
+ * @param[in] transpose Sample transposed matrix.
+ */
+static inline void mat_sample_ntt(poly_t * const a, const size_t k, const uint8_t rho[static 32], const bool transpose) {
+  const size_t num_polys = k * k;
+  for (size_t ofs = 0; ofs < num_polys;) {
+    ofs += mat_sample_ntt_pass(a + ofs, num_polys - ofs, k, rho, transpose, ofs);
+  }
+
+  // convert entries to Montgomery form for poly_mul()
+  for (size_t i = 0; i < num_polys; i++) {
+    poly_tomont(a + i);
+  }
+}
+
+// Number of matrix entries held at once by mat_mul_sample_ntt().
+//
+// By default this fits the passes which mat_sample_ntt() uses for every
+// matrix size, plus the entries of a partial row left over from the
+// previous pass (KEM768 with 4 ways: 1 + 4), so the matrix is sampled
+// as fast as with mat_sample_ntt().
+//
+// Build with -DFIPS203IPD_LOW_STACK to hold only one row of the largest
+// matrix (KEM1024) instead.  This saves up to 2 KiB more stack, but
+// passes which do not fit fall back to narrower ones, which makes
+// KEM768 and KEM1024 up to about a third slower with 8 ways.
+#ifdef FIPS203IPD_LOW_STACK
+#define MAT_MUL_SAMPLE_POLYS PKE1024_K
+#elif FIPS203IPD_XOF_WAYS >= 8
+#define MAT_MUL_SAMPLE_POLYS 8
+#else
+#define MAT_MUL_SAMPLE_POLYS 5
+#endif /* FIPS203IPD_LOW_STACK */
+
+/**
+ * Sample the `k` by `k` matrix A hat in the same passes as
+ * `mat_sample_ntt()`, multiply each row by vector `vec` as soon as it
+ * is complete, and store the product in vector `out` (reduced, see
+ * `poly_t`).  `vec_mc` holds the mulcaches of `vec`, or is NULL.
+ *
+ * Produces the same output as `mat_sample_ntt()` followed by
+ * `matN_mul()`, but holds at most MAT_MUL_SAMPLE_POLYS entries at once
+ * instead of the whole matrix (4 KiB or less instead of 8 KiB for
+ * KEM1024), and multiplies the entries while they are still in L1
+ * cache.
+ *
+ * @param[out] out Output vector (`k` polynomials, NTT domain).
+ * @param[in] k Matrix dimension (2, 3, or 4).
+ * @param[in] rho 32-byte input value used as XOF seed.
+ * @param[in] transpose Sample transposed matrix.
+ * @param[in] vec Input vector (`k` polynomials, NTT domain).
+ * @param[in] vec_mc Mulcaches of `vec` (`k` mulcaches), or NULL.
+ */
+static inline void mat_mul_sample_ntt(poly_t * const out, const size_t k, const uint8_t rho[static 32], const bool transpose, const poly_t * const vec, const poly_mulcache_t * const vec_mc) {
+  poly_t a[MAT_MUL_SAMPLE_POLYS] = { 0 }; // entries of rows y and up
+  size_t ofs = 0, // offset of a[0] in matrix (start of row y)
+         y = 0, // next row to multiply
+         num = 0; // number of sampled entries in `a`
+
+  while (y < k) {
+    // sample next entries, convert them to Montgomery form
+    const size_t n = mat_sample_ntt_pass(a + num, MAT_MUL_SAMPLE_POLYS - num, k, rho, transpose, ofs + num);
+    for (size_t i = num; i < num + n; i++) {
+      poly_tomont(a + i);
+    }
+    num += n;
+
+    // multiply complete rows by vec
+    const size_t num_rows = num / k;
+    for (size_t i = 0; i < num_rows; i++) {
+      poly_basemul_acc(out + y + i, a + k * i, vec, vec_mc, k);
+    }
+
+    // move entries of partial row to front
+    y += num_rows;
+    ofs += k * num_rows;
+    num -= k * num_rows;
+    memmove(a, a + k * num_rows, num * sizeof(poly_t));
+  }
+}
+
+// Maximum PRF output length of prf_x4(), prf_x8(), and prfs(), in
+// bytes (64 * eta for the largest eta, PKE512_ETA1).
+#define PRF_MAX_LEN (64 * PKE512_ETA1)
+
+/**
+ * Read `len` bytes from each of four PRFs at once into `out`.  PRF `k`
+ * is seeded by 32-byte `seed` and byte `bs[k]` (see `prf()`), and its
+ * output is written to `out + k * len`.
+ *
+ * Only the first `n` outputs are stored; the remaining lanes of the
+ * 4-way SHAKE256 XOF are squeezed into a scratch buffer, so that a
+ * partial batch still costs a single 4-way permutation.
+ *
+ * @param[in] seed 32 bytes.
+ * @param[in] bs Four one byte input values (only the first `n` are used).
+ * @param[in] n Number of outputs (1 to 4).
+ * @param[out] out Output buffer (`n * len` bytes).
+ * @param[in] len Length of each output, at most PRF_MAX_LEN.
+ */
+static inline void prf_x4(const uint8_t seed[static 32], const uint8_t bs[static 4], const size_t n, uint8_t * const out, const size_t len) {
+  // build seeds (seed || b)
+  uint8_t seeds[4][33] = { 0 };
+  for (size_t k = 0; k < 4; k++) {
+    memcpy(seeds[k], seed, 32);
+    seeds[k][32] = (k < n) ? bs[k] : 0;
+  }
+
+  // absorb seeds into 4-way xof
+  sha3_xof_x4_t xof = { 0 };
+  shake256x4_xof_init(&xof);
+  const uint8_t * const ms[4] = { seeds[0], seeds[1], seeds[2], seeds[3] };
+  shake256x4_xof_absorb(&xof, ms, sizeof(seeds[0]));
+
+  // squeeze unused lanes into scratch buffer
+  uint8_t scratch[PRF_MAX_LEN] = { 0 };
+  uint8_t *dsts[4] = { 0 };
+  for (size_t k = 0; k < 4; k++) {
+    dsts[k] = (k < n) ? (out + k * len) : scratch;
+  }
+  shake256x4_xof_squeeze(&xof, dsts, len);
+}
+
+/**
+ * Read `len` bytes from each of eight PRFs at once into `out`.
+ *
+ * Same as `prf_x4()`, but uses the 8-way SHAKE256 XOF.
+ *
+ * @param[in] seed 32 bytes.
+ * @param[in] bs Eight one byte input values (only the first `n` are used).
+ * @param[in] n Number of outputs (1 to 8).
+ * @param[out] out Output buffer (`n * len` bytes).
+ * @param[in] len Length of each output, at most PRF_MAX_LEN.
+ */
+static inline void prf_x8(const uint8_t seed[static 32], const uint8_t bs[static 8], const size_t n, uint8_t * const out, const size_t len) {
+  // build seeds (seed || b)
+  uint8_t seeds[8][33] = { 0 };
+  const uint8_t *ms[8] = { 0 };
+  for (size_t k = 0; k < 8; k++) {
+    memcpy(seeds[k], seed, 32);
+    seeds[k][32] = (k < n) ? bs[k] : 0;
+    ms[k] = seeds[k];
+  }
+
+  // absorb seeds into 8-way xof
+  sha3_xof_x8_t xof = { 0 };
+  shake256x8_xof_init(&xof);
+  shake256x8_xof_absorb(&xof, ms, sizeof(seeds[0]));
+
+  // squeeze unused lanes into scratch buffer
+  uint8_t scratch[PRF_MAX_LEN] = { 0 };
+  uint8_t *dsts[8] = { 0 };
+  for (size_t k = 0; k < 8; k++) {
+    dsts[k] = (k < n) ? (out + k * len) : scratch;
+  }
+  shake256x8_xof_squeeze(&xof, dsts, len);
+}
+
+/**
+ * Read `len` bytes from each of `n` PRFs into `out`, up to
+ * `FIPS203IPD_XOF_WAYS` PRFs at a time.  PRF `k` is seeded by 32-byte
+ * `seed` and byte `bs[k]` (see `prf()`), and its output is written to
+ * `out + k * len`.
+ *
+ * When sha3.c uses a SIMD permutation for a multi-buffer XOF (AVX2 for
+ * 4-way, AVX-512 for 8-way), a partial pass is cheaper than the single
+ * PRFs it replaces once enough lanes are used: a 4-way SHAKE256 costs
+ * about 2.3 single ones, and an 8-way about 2.9.  Without one, a pass
+ * costs as much as the single PRFs, so only full passes are used (see
+ * prfs_x4_min() and prfs_x8_min()).
+ *
+ * Used by `polys_sample_cbd()` and the `poly_batch_sample_cbdN()`
+ * functions.
+ *
+ * @param[in] seed 32 bytes.
+ * @param[in] bs One byte input values (one for each PRF).
+ * @param[in] n Number of PRFs.
+ * @param[out] out Output buffer (`n * len` bytes).
+ * @param[in] len Length of each output, at most PRF_MAX_LEN.
+ */
+static inline void prfs(const uint8_t seed[static 32], const uint8_t * const bs, const size_t n, uint8_t * const out, const size_t len) {
+  size_t ofs = 0;
+
+  while (ofs < n) {
+    const size_t left = n - ofs;
+#if FIPS203IPD_XOF_WAYS >= 8
+    if (left >= prfs_x8_min()) {
+      // read up to eight prfs at a time
+      const size_t num = (left < 8) ? left : 8;
+      prf_x8(seed, bs + ofs, num, out + ofs * len, len);
+      ofs += num;
+      continue;
+    }
+#endif /* FIPS203IPD_XOF_WAYS >= 8 */
+
+#if FIPS203IPD_XOF_WAYS >= 4
+    if (left >= prfs_x4_min()) {
+      // read up to four prfs at a time
+      const size_t num = (left < 4) ? left : 4;
+      prf_x4(seed, bs + ofs, num, out + ofs * len, len);
+      ofs += num;
+      continue;
+    }
+#endif /* FIPS203IPD_XOF_WAYS >= 4 */
+
+    // read remaining prfs one at a time
+    (void) left;
+    prf(seed, bs[ofs], out + ofs * len, len);
+    ofs++;
+  }
+}
+
+/**
+ * Define function which reads `64 * ETA` bytes from a pseudo-random
+ * function (PRF) seeded by 32-byte value `seed` and one byte value `b`,
+ * then samples values from the PRF output using the centered binomial
+ * distribution (CBD) with error `ETA` and writes the values as the
+ * coefficients of output polynomial `p`.
+ *
+ * The coefficients are centered (`x - y`, in the range [-ETA, ETA])
+ * rather than reduced modulo Q (see `poly_t`).
+ *
+ * @param[out] p Output polynomial with CBD(ETA) distributed coefficients.
+ * @param[in] seed 32-byte input value used as PRF seed.
+ * @param[in] b 1 byte input value used as PRF seed.
+ */
+#define DEF_POLY_SAMPLE_CBD(ETA) \
+  static inline void poly_sample_cbd ## ETA (poly_t * const p, const uint8_t seed[32], const uint8_t b) { \
+    /* read 64 * eta bytes of data from prf */ \
+    uint8_t buf[64 * ETA] = { 0 }; \
+    prf(seed, b, buf, sizeof(buf)); \
+    poly_cbd ## ETA (p, buf); \
+  }
+
+// define poly_sample_cbd3() (PKE512_ETA1)
+DEF_POLY_SAMPLE_CBD(3)
+
+// define poly_sample_cbd2() (PKE512_ETA2, PKE768_ETA{1,2}, PKE1024_ETA{1,2}
+DEF_POLY_SAMPLE_CBD(2)
 
-  for (size_t i = 0; i < 256; i++) {
-    p->cs[i] = ct_mod_q((uint32_t) p->cs[i] * 3303);
-  }
-}
+// Maximum number of polynomials sampled by polys_sample_cbd() (r, e1,
+// and e2 for PKE1024).
+#define POLYS_SAMPLE_CBD_MAX (2 * PKE1024_K + 1)
 
 /**
- * Add polynomial `a` to polynomial `b` component-wise, and store the
- * sum in `a`.
+ * Sample the `n1 + n2` polynomials of `ps` from CBD: the first `n1`
+ * polynomials from CBD(`eta1`), and the remaining `n2` polynomials from
+ * CBD(2).  Polynomial `k` is sampled from the PRF output for `seed` and
+ * byte `k`, like `poly_sample_cbdN(ps + k, seed, k)`.
  *
- * @param[in,out] a Polynomial.
- * @param[in] b Polynomial.
+ * The PRF outputs are read with `prfs()`, so the s and e vectors of
+ * key generation, or the r, e1, and e2 vectors of encryption, are
+ * sampled with multi-buffer SHAKE256 passes rather than one SHAKE256
+ * per polynomial.  When `eta1` is 2, all outputs are read with one
+ * call.  Otherwise the CBD(eta1) and CBD(2) outputs are read with
+ * separate calls, because a common pass would squeeze 192 bytes (two
+ * SHAKE256 blocks) for every polynomial.
+ *
+ * The coefficients are centered (see `poly_sample_cbdN()`).
+ *
+ * @param[out] ps Output polynomials (`n1 + n2`).
+ * @param[in] seed 32-byte input value used as PRF seed.
+ * @param[in] eta1 CBD parameter of the first `n1` polynomials (2 or 3).
+ * @param[in] n1 Number of CBD(eta1) polynomials.
+ * @param[in] n2 Number of CBD(2) polynomials.
  */
-static inline void poly_add(poly_t * const restrict a, const poly_t * const restrict b) {
-  for (size_t i = 0; i < 256; i++) {
-    a->cs[i] = ct_mod_q((uint32_t) a->cs[i] + (uint32_t) b->cs[i]);
+static inline void polys_sample_cbd(poly_t * const ps, const uint8_t seed[static 32], const size_t eta1, const size_t n1, const size_t n2) {
+  // number of polynomials read with 64 * eta1 byte prf outputs
+  const size_t n = n1 + n2, m = (eta1 == 2) ? n : n1, len = 64 * eta1;
+
+  // prf bytes (0, 1, ..., n - 1)
+  uint8_t bs[POLYS_SAMPLE_CBD_MAX] = { 0 };
+  for (size_t k = 0; k < n; k++) {
+    bs[k] = k;
   }
-}
 
-/**
- * Subtract polynomial `b` from polynomial `a` component-wise, and store the
- * result in `a`.
- *
- * @param[in,out] a Polynomial.
- * @param[in] b Polynomial.
- */
-static inline void poly_sub(poly_t * const restrict a, const poly_t * const restrict b) {
-  for (size_t i = 0; i < 256; i++) {
-    a->cs[i] = ct_mod_q((uint32_t) a->cs[i] + (uint32_t) (Q - b->cs[i]));
+  // read prf output for all polynomials: 64 * eta1 bytes for the first
+  // `m`, then 128 bytes for the rest
+  uint8_t bufs[POLYS_SAMPLE_CBD_MAX * PRF_MAX_LEN] = { 0 };
+  uint8_t * const bufs2 = bufs + m * len;
+  prfs(seed, bs, m, bufs, len);
+  prfs(seed, bs + m, n - m, bufs2, 128);
+
+  for (size_t k = 0; k < m; k++) {
+    if (eta1 == 3) {
+      poly_cbd3(ps + k, bufs + k * len);
+    } else {
+      poly_cbd2(ps + k, bufs + k * len);
+    }
+  }
+  for (size_t k = m; k < n; k++) {
+    poly_cbd2(ps + k, bufs2 + (k - m) * 128);
   }
 }
 
 /**
- * Multiply `a` and `b` and store the product in `c`.
+ * Pack 12-bit coefficients of polynomial `a` and serialize them into
+ * 384 bytes of the output buffer `out` (reference C implementation).
  *
- * Note: `a` and `b` are assumed to be in the NTT domain.
- *
- * @param[out] c Product polynomial, in the NTT domain.
- * @param[in] a Input polynomial, in the NTT domain.
- * @param[in] b Input polynomial, in the NTT domain.
+ * @param[out] out Output buffer (384 bytes).
+ * @param[in] a Input polynomial.
  */
-static inline void poly_mul(poly_t * const restrict c, const poly_t * const restrict a, const poly_t * const restrict b) {
+static inline void poly_encode_scalar(uint8_t out[static 384], const poly_t * const a) {
   for (size_t i = 0; i < 128; i++) {
-    // note: uint64_t is required here or the zeta multiply overflows
-    // for x^3*x^5
-    const uint64_t a0 = a->cs[2 * i],
-                   a1 = a->cs[2 * i + 1],
-                   b0 = b->cs[2 * i],
-                   b1 = b->cs[2 * i + 1];
-    c->cs[2 * i] = ct_mod_q(a0 * b0 + a1 * b1 * MUL_LUT[i]);
-    c->cs[2 * i + 1] = ct_mod_q(a0 * b1 + a1 * b0);
+    const uint16_t a0 = a->cs[2 * i],
+                   a1 = a->cs[2 * i + 1];
+    out[3 * i] = a0 & 0x0ff;
+    out[3 * i + 1] = ((a0 & 0xf00) >> 8) | ((a1 & 0x0f) << 4);
+    out[3 * i + 2] = (a1 & 0xff0) >> 4;
   }
 }
 
 /**
- * Pack 12-bit coefficients of polynomial `p` and serialize them into
+ * Pack 12-bit coefficients of polynomial `a` and serialize them into
  * 384 bytes of the output buffer `out`.
  *
+ * Dispatches to the AVX-512, AVX2, or reference C implementation.
+ *
  * @param[out] out Output buffer (384 bytes).
- * @param[in] Input polynomial.
+ * @param[in] a Input polynomial.
  */
 static void poly_encode(uint8_t out[static 384], const poly_t * const a) {
-  for (size_t i = 0; i < 128; i++) {
-    const uint16_t a0 = a->cs[2 * i],
-                   a1 = a->cs[2 * i + 1];
-    out[3 * i] = a0 & 0x0ff;
-    out[3 * i + 1] = ((a0 & 0xf00) >> 8) | ((a1 & 0x0f) << 4);
-    out[3 * i + 2] = (a1 & 0xff0) >> 4;
+  POLY_CHECK_12BIT(a);
+
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_encode_avx512(out, a);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    poly_encode_avx2(out, a);
+    break;
+#endif /* FIPS203IPD_AVX2 */
+  default:
+    poly_encode_scalar(out, a);
   }
 }
 
@@ -617,12 +4873,20 @@ static void poly_encode(uint8_t out[static 384], const poly_t * const a) {
  * @param[in] p Input polynomial.
  */
 static inline void poly_encode_11bit(uint8_t out[static 352], const poly_t * const p) {
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    POLY_CHECK_CANONICAL(p);
+    poly_encode_bits_vbmi(out, p, 11);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
+
+  // compress coefficients
+  uint16_t ys[256] = { 0 };
+  poly_compress(ys, p, 11);
+
   for (size_t i = 0; i < 32; i++) {
-    uint16_t y[8] = { 0 };
-    for (size_t j = 0; j < 8; j++) {
-      const uint16_t x = p->cs[8 * i + j];
-      y[j] = 0x7ff & (((x << 12) + Q)/Q >> 1); // mask(round(x*(2^11/Q)))
-    }
+    const uint16_t * const y = ys + 8 * i;
 
     // 00000000 11111000 22111111 22222222
     // 33333332 44443333 54444444 55555555
@@ -649,13 +4913,20 @@ static inline void poly_encode_11bit(uint8_t out[static 352], const poly_t * con
  * @param[in] p Input polynomial.
  */
 static inline void poly_encode_10bit(uint8_t out[static 320], const poly_t * const p) {
-  for (size_t i = 0; i < 64; i++) {
-    uint16_t y[4] = { 0 };
-    for (size_t j = 0; j < 4; j++) {
-      const uint16_t x = p->cs[4 * i + j];
-      y[j] ^= 0x3ff & (((x << 11) + Q)/Q >> 1); // mask(round(x*(2^10/Q)))
-    }
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    POLY_CHECK_CANONICAL(p);
+    poly_encode_bits_vbmi(out, p, 10);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
 
+  // compress coefficients
+  uint16_t ys[256] = { 0 };
+  poly_compress(ys, p, 10);
+
+  for (size_t i = 0; i < 64; i++) {
+    const uint16_t * const y = ys + 4 * i;
     out[5 * i + 0] = y[0] & 0xff;
     out[5 * i + 1] = ((y[0] >> 8) & 0x03) | ((y[1] & 0x3f) << 2);
     out[5 * i + 2] = ((y[1] >> 6) & 0xf) | ((y[2] & 0xf) << 4);
@@ -664,6 +4935,51 @@ static inline void poly_encode_10bit(uint8_t out[static 320], const poly_t * con
   }
 }
 
+/**
+ * Compute the inverse NTT of polynomial `u`, add noise polynomial `e`,
+ * compress the sum to `d` bits, and serialize the compressed values as
+ * `32 * d` bytes in output buffer `out`.
+ *
+ * Output stage for the ciphertext vector `u` in `pke*_encrypt()`.  The
+ * AVX2 and AVX-512 kernels add, reduce, compress, and pack each block
+ * of coefficients as it leaves the final inverse NTT layer, without
+ * writing the intermediate polynomial back to memory.  Otherwise this
+ * falls back to `poly_inv_ntt()`, `poly_add()`, `poly_normalize()`, and
+ * `poly_encode_{11,10}bit()`, which clobbers `u`.
+ *
+ * @param[out] out Output buffer (`32 * d` bytes).
+ * @param[in,out] u Input polynomial (NTT domain).  Clobbered.
+ * @param[in] e Noise polynomial.
+ * @param[in] d Number of bits in compressed values (10 or 11).
+ */
+static void poly_inv_ntt_encode(uint8_t * const out, poly_t * const u, const poly_t * const e, const uint8_t d) {
+  POLY_CHECK_BOUND(u, Q);
+
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_inv_ntt_encode_avx512(out, u, e, d);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    poly_inv_ntt_encode_avx2(out, u, e, d);
+    break;
+#endif /* FIPS203IPD_AVX2 */
+  default:
+    poly_inv_ntt(u);
+    poly_add(u, e);
+    poly_normalize(u);
+    if (d == 11) {
+      poly_encode_11bit(out, u);
+    } else {
+      poly_encode_10bit(out, u);
+    }
+  }
+}
+
 /**
  * Compress coefficients of polynomial `p` to 5 bits and then serialize
  * them as 160 bytes in output buffer `out`.
@@ -672,14 +4988,20 @@ static inline void poly_encode_10bit(uint8_t out[static 320], const poly_t * con
  * @param[in] p Input polynomial.
  */
 static inline void poly_encode_5bit(uint8_t out[static 160], const poly_t * const p) {
-  for (size_t i = 0; i < 32; i++) {
-    uint16_t y[8] = { 0 };
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    POLY_CHECK_CANONICAL(p);
+    poly_encode_bits_vbmi(out, p, 5);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
 
-    for (size_t j = 0; j < 8; j++) {
-      const uint32_t x = p->cs[8 * i + j];
-      y[j] = 0x1f & (((x << 6) + Q)/Q >> 1); // mask(round(x*(2^5/Q)))
-    }
+  // compress coefficients
+  uint16_t ys[256] = { 0 };
+  poly_compress(ys, p, 5);
 
+  for (size_t i = 0; i < 32; i++) {
+    const uint16_t * const y = ys + 8 * i;
     out[5 * i + 0] = y[0] | ((y[1] & 0x07) << 5);                   // 11100000
     out[5 * i + 1] = (y[1] >> 3) | (y[2] << 2) | ((y[3] & 1) << 7); // 32222211
     out[5 * i + 2] = (y[3] >> 1) | ((y[4] & 0xf) << 4);             // 44443333
@@ -696,15 +5018,20 @@ static inline void poly_encode_5bit(uint8_t out[static 160], const poly_t * cons
  * @param[in] p Input polynomial.
  */
 static inline void poly_encode_4bit(uint8_t out[static 128], const poly_t * const p) {
-  for (size_t i = 0; i < 128; i++) {
-    uint16_t y[2] = { 0 };
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    POLY_CHECK_CANONICAL(p);
+    poly_encode_bits_vbmi(out, p, 4);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
 
-    for (size_t j = 0; j < 2; j++) {
-      const uint16_t x = p->cs[2 * i + j];
-      y[j] = 0xf & (((x << 5) + Q)/Q >> 1); // mask(round(x*(2^4/Q)))
-    }
+  // compress coefficients
+  uint16_t ys[256] = { 0 };
+  poly_compress(ys, p, 4);
 
-    out[i] = y[0] | (y[1] << 4);
+  for (size_t i = 0; i < 128; i++) {
+    out[i] = ys[2 * i] | (ys[2 * i + 1] << 4);
   }
 }
 
@@ -716,6 +5043,11 @@ static inline void poly_encode_4bit(uint8_t out[static 128], const poly_t * cons
  * @param[in] p Input polynomial.
  */
 static inline void poly_encode_1bit(uint8_t out[static 32], const poly_t * const p) {
+  POLY_CHECK_CANONICAL(p);
+
+  // compressing to 1 bit maps coefficients in the range [833, 2496] to
+  // 1 and all other coefficients to 0, so a range check is cheaper than
+  // going through poly_compress()
   for (size_t i = 0; i < 32; i++) {
     out[i] = (IN_RANGE(p->cs[8 * i + 0], 833, 2496)) |
              (IN_RANGE(p->cs[8 * i + 1], 833, 2496) << 1) |
@@ -728,6 +5060,31 @@ static inline void poly_encode_1bit(uint8_t out[static 32], const poly_t * const
   }
 }
 
+/**
+ * Deserialize 384-byte buffer `b` as 256 12-bit integers, reduce them
+ * modulo Q, and save them as the coefficients of polynomial `p`
+ * (reference C implementation).  See `poly_decode()`.
+ *
+ * @param[out] p Output polynomial.
+ * @param[in] b Input buffer (384 bytes).
+ * @return True if every integer was less than Q.
+ */
+static inline bool poly_decode_scalar(poly_t * const p, const uint8_t b[static 384]) {
+  uint32_t bad = 0; // bit 31 set if any integer is >= Q
+  for (size_t i = 0; i < 128; i++) {
+    const uint8_t b0 = b[3 * i],
+                  b1 = b[3 * i + 1],
+                  b2 = b[3 * i + 2];
+    const uint16_t d0 = ((uint16_t) b0) | ((((uint16_t) b1) & 0xf) << 8),
+                   d1 = (((uint16_t) b1 & 0xf0) >> 4) | (((uint16_t) b2) << 4);
+    bad |= ((uint32_t) (Q - 1 - d0)) | ((uint32_t) (Q - 1 - d1));
+    p->cs[2 * i] = ct_mod_q(d0);
+    p->cs[2 * i + 1] = ct_mod_q(d1);
+  }
+
+  return !(bad >> 31);
+}
+
 /**
  * Read 384 bytes from input buffer `b`, parse bytes as 256 packed
  * 12-bit integers, and then save the integers as coefficients of output
@@ -743,16 +5100,30 @@ static inline void poly_encode_1bit(uint8_t out[static 32], const poly_t * const
  *
  * https://groups.google.com/a/list.nist.gov/d/msgid/pqc-forum/ZRQvPT7kQ51NIRyJ%40disp3269
  *
+ * The range check is done in the same pass: the return value is true
+ * if every integer was less than Q, and is computed in constant time.
+ * It is used to check encapsulation keys (see `ek_check()`).
+ *
+ * Dispatches to the AVX-512, AVX2, or reference C implementation.
+ *
  * @param[out] p Output polynomial.
  * @param[in] b Input buffer (384 bytes).
+ * @return True if every integer was less than Q.
  */
-static inline void poly_decode(poly_t * const p, const uint8_t b[static 384]) {
-  for (size_t i = 0; i < 128; i++) {
-    const uint8_t b0 = b[3 * i],
-                  b1 = b[3 * i + 1],
-                  b2 = b[3 * i + 2];
-    p->cs[2 * i] = ct_mod_q(((uint16_t) b0) | ((((uint16_t) b1) & 0xf) << 8));
-    p->cs[2 * i + 1] = ct_mod_q((((uint16_t) b1 & 0xf0) >> 4) | (((uint16_t) b2) << 4));
+static inline bool poly_decode(poly_t * const p, const uint8_t b[static 384]) {
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    return poly_decode_avx512(p, b);
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    return poly_decode_avx2(p, b);
+#endif /* FIPS203IPD_AVX2 */
+  default:
+    return poly_decode_scalar(p, b);
   }
 }
 
@@ -764,6 +5135,13 @@ static inline void poly_decode(poly_t * const p, const uint8_t b[static 384]) {
  * @param[in] b Input buffer (352 bytes).
  */
 static inline void poly_decode_11bit(poly_t * const p, const uint8_t b[static 352]) {
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    poly_decode_bits_vbmi(p, b, 11);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
+
   for (size_t i = 0; i < 32; i++) {
     const uint16_t b0 = b[11 * i + 0],
                    b1 = b[11 * i + 1],
@@ -791,18 +5169,9 @@ static inline void poly_decode_11bit(poly_t * const p, const uint8_t b[static 35
       (b9 >> 5) | (b10 << 3),
     };
 
-    // decode
-    uint16_t y[8] = { 0 };
-    for (size_t j = 0; j < 2048; j++) {
-      for (size_t k = 0; k < 8; k++) {
-        const uint32_t v = (j * Q + (1 << 10)) >> 11; // decode/round
-        y[k] ^= ((x[k] == j) ? 0xfff : 0x000) & v;
-      }
-    }
-
-    // write to result
+    // decompress, write to result
     for (size_t j = 0; j < 8; j++) {
-      p->cs[8 * i + j] = y[j];
+      p->cs[8 * i + j] = ct_decompress(x[j], 11);
     }
   }
 }
@@ -815,6 +5184,13 @@ static inline void poly_decode_11bit(poly_t * const p, const uint8_t b[static 35
  * @param[in] b Input buffer (320 bytes).
  */
 static inline void poly_decode_10bit(poly_t * const p, const uint8_t b[static 320]) {
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    poly_decode_bits_vbmi(p, b, 10);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
+
   for (size_t i = 0; i < 64; i++) {
     const uint8_t b0 = b[5 * i + 0],
                   b1 = b[5 * i + 1],
@@ -828,20 +5204,51 @@ static inline void poly_decode_10bit(poly_t * const p, const uint8_t b[static 32
       (b3 >> 6) | (b4 << 2),
     };
 
-    // decode
-    uint16_t y[4] = { 0 };
-    for (size_t j = 0; j < 1024; j++) {
-      for (size_t k = 0; k < 4; k++) {
-        const uint32_t v = (j * Q + (1 << 9)) >> 10; // decode/round
-        y[k] ^= ((x[k] == j) ? 0xfff : 0x000) & v;
-      }
+    // decompress, write to result
+    for (size_t j = 0; j < 4; j++) {
+      p->cs[4 * i + j] = ct_decompress(x[j], 10);
     }
+  }
+}
 
-    // write to result
-    for (size_t j = 0; j < 4; j++) {
-      p->cs[4 * i + j] = y[j];
+/**
+ * Decode packed `d`-bit values from input buffer `b`, decompress them,
+ * and store the NTT of the resulting polynomial in `p`.
+ *
+ * Input stage for the ciphertext vector `u` in `pke*_decrypt()`.  The
+ * AVX2 and AVX-512 kernels unpack and decompress each block of
+ * coefficients in registers and feed it straight into the first NTT
+ * layer.  Otherwise this falls back to `poly_decode_{11,10}bit()`
+ * followed by `poly_ntt()`.
+ *
+ * @param[out] p Output polynomial (NTT domain).
+ * @param[in] b Input buffer (`32 * d` bytes).
+ * @param[in] d Number of bits in compressed values (10 or 11).
+ */
+static void poly_decode_ntt(poly_t * const p, const uint8_t * const b, const uint8_t d) {
+  switch (poly_isa()) {
+#ifdef FIPS203IPD_AVX512
+  case ISA_AVX512VBMI2: // no VBMI2 kernel
+  case ISA_AVX512VBMI: // no VBMI kernel
+  case ISA_AVX512:
+    poly_decode_ntt_avx512(p, b, d);
+    break;
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX2
+  case ISA_AVX2:
+    poly_decode_ntt_avx2(p, b, d);
+    break;
+#endif /* FIPS203IPD_AVX2 */
+  default:
+    if (d == 11) {
+      poly_decode_11bit(p, b);
+    } else {
+      poly_decode_10bit(p, b);
     }
+    poly_ntt(p);
   }
+
+  POLY_CHECK_BOUND(p, (Q + 1) / 2);
 }
 
 /**
@@ -852,6 +5259,13 @@ static inline void poly_decode_10bit(poly_t * const p, const uint8_t b[static 32
  * @param[in] b Input buffer (160 bytes).
  */
 static inline void poly_decode_5bit(poly_t * const p, const uint8_t b[static 160]) {
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    poly_decode_bits_vbmi(p, b, 5);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
+
   for (size_t i = 0; i < 32; i++) {
     const uint16_t b0 = b[5 * i + 0],
                    b1 = b[5 * i + 1],
@@ -871,77 +5285,502 @@ static inline void poly_decode_5bit(poly_t * const p, const uint8_t b[static 160
       (b4 >> 3),
     };
 
-    uint16_t y[8] = { 0 };
-    for (size_t j = 0; j < 32; j++) {
-      for (size_t k = 0; k < 8; k++) {
-        const uint32_t v = (j * Q + (1 << 4)) >> 5; // decode/round
-        y[k] ^= ((x[k] == j) ? 0xfff : 0x000) & v;
+    // decompress, write to result
+    for (size_t j = 0; j < 8; j++) {
+      p->cs[8 * i + j] = ct_decompress(x[j], 5);
+    }
+  }
+}
+
+/**
+ * Decode packed 4-bit coefficients from input buffer `b` into output
+ * polynomial `p`.
+ *
+ * @param[out] p Output polynomial.
+ * @param[in] b Input buffer (128 bytes).
+ */
+static inline void poly_decode_4bit(poly_t * const p, const uint8_t b[static 128]) {
+#ifdef FIPS203IPD_AVX512VBMI
+  if (poly_isa() >= ISA_AVX512VBMI) {
+    poly_decode_bits_vbmi(p, b, 4);
+    return;
+  }
+#endif /* FIPS203IPD_AVX512VBMI */
+
+  for (size_t i = 0; i < 128; i++) {
+    // decompress, write to result
+    p->cs[2 * i + 0] = ct_decompress(b[i] & 0x0f, 4);
+    p->cs[2 * i + 1] = ct_decompress((b[i] & 0xf0) >> 4, 4);
+  }
+}
+
+/**
+ * Decode packed 1-bit coefficients from input buffer `b` into output
+ * polynomial `p`.
+ *
+ * @param[out] p Output polynomial.
+ * @param[in] b Input buffer (32 bytes).
+ */
+static inline void poly_decode_1bit(poly_t * const p, const uint8_t b[static 32]) {
+  for (size_t i = 0; i < 32; i++) {
+    p->cs[8 * i + 0] = ((b[i] & 0x01) ? 0xfff : 0) & 1665;
+    p->cs[8 * i + 1] = ((b[i] & 0x02) ? 0xfff : 0) & 1665;
+    p->cs[8 * i + 2] = ((b[i] & 0x04) ? 0xfff : 0) & 1665;
+    p->cs[8 * i + 3] = ((b[i] & 0x08) ? 0xfff : 0) & 1665;
+    p->cs[8 * i + 4] = ((b[i] & 0x10) ? 0xfff : 0) & 1665;
+    p->cs[8 * i + 5] = ((b[i] & 0x20) ? 0xfff : 0) & 1665;
+    p->cs[8 * i + 6] = ((b[i] & 0x40) ? 0xfff : 0) & 1665;
+    p->cs[8 * i + 7] = ((b[i] & 0x80) ? 0xfff : 0) & 1665;
+  }
+}
+
+// Number of polynomials in a polynomial batch (see `poly_batch_t`).
+#define POLY_BATCH_SIZE 16
+
+// Batch of POLY_BATCH_SIZE independent polynomials, stored transposed:
+// `cs[i]` holds coefficient `i` of every polynomial in the batch.
+//
+// The batch kernels process every polynomial in lockstep, so each SIMD
+// lane maps onto one polynomial and no shuffles are needed (one AVX2
+// vector holds one row).  Coefficient bounds are the same as for the
+// corresponding single-polynomial functions (see `poly_t`).
+typedef struct {
+  int16_t cs[256][POLY_BATCH_SIZE]; // coefficients (index, polynomial)
+} poly_batch_t;
+
+/**
+ * Load `n` polynomials from `ps` into batch `pb`.  Unused polynomials in
+ * the batch are set to zero.
+ *
+ * @param[out] pb Output batch.
+ * @param[in] ps Input polynomials.
+ * @param[in] n Number of polynomials (at most POLY_BATCH_SIZE).
+ */
+static inline void poly_batch_load(poly_batch_t * const pb, const poly_t * const ps, const size_t n) {
+  memset(pb, 0, sizeof(poly_batch_t));
+  for (size_t k = 0; k < n; k++) {
+    for (size_t i = 0; i < 256; i++) {
+      pb->cs[i][k] = ps[k].cs[i];
+    }
+  }
+}
+
+/**
+ * Store the first `n` polynomials of batch `pb` in `ps`.
+ *
+ * @param[out] ps Output polynomials.
+ * @param[in] pb Input batch.
+ * @param[in] n Number of polynomials (at most POLY_BATCH_SIZE).
+ */
+static inline void poly_batch_store(poly_t * const ps, const poly_batch_t * const pb, const size_t n) {
+  for (size_t k = 0; k < n; k++) {
+    for (size_t i = 0; i < 256; i++) {
+      ps[k].cs[i] = pb->cs[i][k];
+    }
+  }
+}
+
+/**
+ * Compute in-place NTT of every polynomial in batch `pb` (reference C
+ * implementation).  See `poly_ntt_scalar()`.
+ *
+ * @param[in,out] pb Polynomial batch.
+ */
+static inline void poly_batch_ntt_scalar(poly_batch_t * const pb) {
+  uint8_t k = 1;
+  for (size_t len = 128; len >= 2; len /= 2) {
+    for (size_t start = 0; start < 256; start += 2 * len) {
+      const int16_t zeta = NTT_LUT[k++];
+
+      for (size_t j = start; j < start + len; j++) {
+        // (restrict rows so the compiler can vectorize across the batch)
+        int16_t * const restrict x = pb->cs[j],
+                * const restrict y = pb->cs[j + len];
+        for (size_t l = 0; l < POLY_BATCH_SIZE; l++) {
+          const int16_t a = x[l],
+                        t = mont_mul(y[l], zeta);
+          y[l] = a - t;
+          x[l] = a + t;
+        }
+      }
+    }
+  }
+
+  // |x| < 8Q after 7 layers
+  for (size_t i = 0; i < 256; i++) {
+    for (size_t l = 0; l < POLY_BATCH_SIZE; l++) {
+      pb->cs[i][l] = barrett_reduce(pb->cs[i][l]);
+    }
+  }
+}
+
+/**
+ * Compute in-place inverse NTT of every polynomial in batch `pb`
+ * (reference C implementation).  See `poly_inv_ntt_scalar()`.
+ *
+ * @param[in,out] pb Polynomial batch.
+ */
+static inline void poly_batch_inv_ntt_scalar(poly_batch_t * const pb) {
+  uint8_t k = 127;
+  for (size_t len = 2; len <= 64; len *= 2) {
+    for (size_t start = 0; start < 256; start += 2 * len) {
+      const int16_t zeta = NTT_LUT[k--];
+
+      for (size_t j = start; j < start + len; j++) {
+        // (restrict rows so the compiler can vectorize across the batch)
+        int16_t * const restrict x = pb->cs[j],
+                * const restrict y = pb->cs[j + len];
+        for (size_t l = 0; l < POLY_BATCH_SIZE; l++) {
+          const int16_t a = x[l],
+                        b = y[l];
+          x[l] = a + b;
+          y[l] = mont_mul(b - a, zeta);
+        }
+      }
+    }
+
+    if (len == 8) {
+      // |x| < 8Q after 3 layers
+      for (size_t i = 0; i < 256; i++) {
+        for (size_t l = 0; l < POLY_BATCH_SIZE; l++) {
+          pb->cs[i][l] = barrett_reduce(pb->cs[i][l]);
+        }
+      }
+    }
+  }
+
+  // layer with len = 128, scaled by 128^-1 mod Q
+  for (size_t j = 0; j < 128; j++) {
+    // (restrict rows so the compiler can vectorize across the batch)
+    int16_t * const restrict x = pb->cs[j],
+            * const restrict y = pb->cs[j + 128];
+    for (size_t l = 0; l < POLY_BATCH_SIZE; l++) {
+      const int16_t a = x[l],
+                    b = y[l];
+      x[l] = mont_mul(a + b, INV_NTT_SCALE);
+      y[l] = mont_mul(b - a, INV_NTT_SCALE_ZETA);
+    }
+  }
+}
+
+/**
+ * Multiply `n` pairs of batches `a[j]` and `b[j]` polynomial by
+ * polynomial, sum the products, and store the sums in batch `c`
+ * (reference C implementation).  See `poly_basemul_acc_scalar()`.
+ *
+ * @param[out] c Sums of products, in the NTT domain.
+ * @param[in] a Input batches, in the NTT domain.
+ * @param[in] b Input batches, in the NTT domain.
+ * @param[in] n Number of products (at most 4).
+ */
+static inline void poly_batch_basemul_acc_scalar(poly_batch_t * const restrict c, const poly_batch_t * const restrict a, const poly_batch_t * const restrict b, const size_t n) {
+  for (size_t i = 0; i < 128; i++) {
+    for (size_t l = 0; l < POLY_BATCH_SIZE; l++) {
+      int32_t c0 = 0, c1 = 0;
+      for (size_t j = 0; j < n; j++) {
+        const int32_t a0 = a[j].cs[2 * i][l],
+                      a1 = a[j].cs[2 * i + 1][l],
+                      b0 = b[j].cs[2 * i][l],
+                      b1 = b[j].cs[2 * i + 1][l];
+
+        // each term is below 2 * Q^2, so 4 terms are below Q * 2^15
+        c0 += a0 * b0 + a1 * mont_mul(b1, MUL_LUT[i]);
+        c1 += a0 * b1 + a1 * b0;
+      }
+
+      c->cs[2 * i][l] = mont_reduce(c0);
+      c->cs[2 * i + 1][l] = mont_reduce(c1);
+    }
+  }
+}
+
+#ifdef FIPS203IPD_AVX2
+/**
+ * Compute in-place NTT of every polynomial in batch `pb` (AVX2
+ * implementation).
+ *
+ * Produces output congruent to `poly_batch_ntt_scalar()`, with the same
+ * bounds.  Each row of the batch is one vector, so every layer is a
+ * butterfly on whole vectors with a broadcast twiddle factor.
+ *
+ * @param[in,out] pb Polynomial batch.
+ */
+__attribute__((target("avx2")))
+static inline void poly_batch_ntt_avx2(poly_batch_t * const pb) {
+  uint8_t k = 1;
+  for (size_t len = 128; len >= 2; len /= 2) {
+    for (size_t start = 0; start < 256; start += 2 * len) {
+      const __m256i zs = _mm256_set1_epi16(NTT_LUT[k]),
+                    zqs = _mm256_set1_epi16(NTT_LUT_QINV[k]);
+      k++;
+
+      for (size_t j = start; j < start + len; j++) {
+        __m256i a = _mm256_loadu_si256((void*) pb->cs[j]),
+                b = _mm256_loadu_si256((void*) pb->cs[j + len]);
+        avx2_ntt_butterfly(&a, &b, zs, zqs);
+        _mm256_storeu_si256((void*) pb->cs[j], a);
+        _mm256_storeu_si256((void*) pb->cs[j + len], b);
+      }
+    }
+  }
+
+  // |x| < 8Q after 7 layers
+  for (size_t i = 0; i < 256; i++) {
+    const __m256i x = _mm256_loadu_si256((void*) pb->cs[i]);
+    _mm256_storeu_si256((void*) pb->cs[i], avx2_barrett_reduce(x));
+  }
+}
+
+/**
+ * Compute in-place inverse NTT of every polynomial in batch `pb` (AVX2
+ * implementation).
+ *
+ * Produces output congruent to `poly_batch_inv_ntt_scalar()`, with the
+ * same bounds.
+ *
+ * @param[in,out] pb Polynomial batch.
+ */
+__attribute__((target("avx2")))
+static inline void poly_batch_inv_ntt_avx2(poly_batch_t * const pb) {
+  uint8_t k = 127;
+  for (size_t len = 2; len <= 64; len *= 2) {
+    for (size_t start = 0; start < 256; start += 2 * len) {
+      const __m256i zs = _mm256_set1_epi16(NTT_LUT[k]),
+                    zqs = _mm256_set1_epi16(NTT_LUT_QINV[k]);
+      k--;
+
+      for (size_t j = start; j < start + len; j++) {
+        __m256i a = _mm256_loadu_si256((void*) pb->cs[j]),
+                b = _mm256_loadu_si256((void*) pb->cs[j + len]);
+        avx2_inv_ntt_butterfly(&a, &b, zs, zqs);
+        _mm256_storeu_si256((void*) pb->cs[j], a);
+        _mm256_storeu_si256((void*) pb->cs[j + len], b);
+      }
+    }
+
+    if (len == 8) {
+      // |x| < 8Q after 3 layers
+      for (size_t i = 0; i < 256; i++) {
+        const __m256i x = _mm256_loadu_si256((void*) pb->cs[i]);
+        _mm256_storeu_si256((void*) pb->cs[i], avx2_barrett_reduce(x));
       }
     }
+  }
+
+  // layer with len = 128, scaled by 128^-1 mod Q
+  const __m256i ss = _mm256_set1_epi16(INV_NTT_SCALE),
+                sqs = avx2_mont_qinv(ss),
+                zs = _mm256_set1_epi16(INV_NTT_SCALE_ZETA),
+                zqs = avx2_mont_qinv(zs);
+  for (size_t j = 0; j < 128; j++) {
+    const __m256i a = _mm256_loadu_si256((void*) pb->cs[j]),
+                  b = _mm256_loadu_si256((void*) pb->cs[j + 128]);
+    _mm256_storeu_si256((void*) pb->cs[j], avx2_mul_mont(_mm256_add_epi16(a, b), ss, sqs));
+    _mm256_storeu_si256((void*) pb->cs[j + 128], avx2_mul_mont(_mm256_sub_epi16(b, a), zs, zqs));
+  }
+}
+
+/**
+ * Multiply `n` pairs of batches `a[j]` and `b[j]` polynomial by
+ * polynomial, sum the products, and store the sums in batch `c` (AVX2
+ * implementation).
+ *
+ * Produces output congruent to `poly_batch_basemul_acc_scalar()`, with
+ * the same bounds.  The constant and linear terms of each degree-one
+ * product are in separate rows, so the products are Montgomery
+ * multiplies on whole rows with a broadcast base case multiply factor.
+ * Each product is below Q, so the sums of at most 8 products fit in 16
+ * bits and are reduced once.
+ *
+ * @param[out] c Sums of products, in the NTT domain.
+ * @param[in] a Input batches, in the NTT domain.
+ * @param[in] b Input batches, in the NTT domain.
+ * @param[in] n Number of products (at most 4).
+ */
+__attribute__((target("avx2")))
+static inline void poly_batch_basemul_acc_avx2(poly_batch_t * const restrict c, const poly_batch_t * const restrict a, const poly_batch_t * const restrict b, const size_t n) {
+  for (size_t i = 0; i < 128; i++) {
+    const __m256i zs = _mm256_set1_epi16(MUL_LUT[i]),
+                  zqs = avx2_mont_qinv(zs);
+
+    __m256i c0 = _mm256_setzero_si256(),
+            c1 = _mm256_setzero_si256();
+    for (size_t j = 0; j < n; j++) {
+      const __m256i a0 = _mm256_loadu_si256((void*) a[j].cs[2 * i]),
+                    a1 = _mm256_loadu_si256((void*) a[j].cs[2 * i + 1]),
+                    b0 = _mm256_loadu_si256((void*) b[j].cs[2 * i]),
+                    b1 = _mm256_loadu_si256((void*) b[j].cs[2 * i + 1]),
+                    b0qs = avx2_mont_qinv(b0),
+                    b1z = avx2_mul_mont(b1, zs, zqs), // b1 * zeta
+                    b1qs = avx2_mont_qinv(b1),
+                    b1zqs = avx2_mont_qinv(b1z);
+
+      // c0 += a0 * b0 + a1 * b1 * zeta, c1 += a0 * b1 + a1 * b0
+      c0 = _mm256_add_epi16(c0, _mm256_add_epi16(avx2_mul_mont(a0, b0, b0qs), avx2_mul_mont(a1, b1z, b1zqs)));
+      c1 = _mm256_add_epi16(c1, _mm256_add_epi16(avx2_mul_mont(a0, b1, b1qs), avx2_mul_mont(a1, b0, b0qs)));
+    }
+
+    _mm256_storeu_si256((void*) c->cs[2 * i], avx2_barrett_reduce(c0));
+    _mm256_storeu_si256((void*) c->cs[2 * i + 1], avx2_barrett_reduce(c1));
+  }
+}
+#endif /* FIPS203IPD_AVX2 */
+
+/**
+ * Compute in-place NTT of every polynomial in batch `pb`.  Bounds are
+ * the same as `poly_ntt()`.
+ *
+ * Dispatches to the AVX2 or reference C implementation (the batch
+ * kernels are 16 lanes wide, so AVX-512 CPUs use the AVX2 kernels).
+ *
+ * @param[in,out] pb Polynomial batch.
+ */
+static inline void poly_batch_ntt(poly_batch_t * const pb) {
+#ifdef FIPS203IPD_AVX2
+  if (poly_isa() >= ISA_AVX2) {
+    poly_batch_ntt_avx2(pb);
+  } else {
+    poly_batch_ntt_scalar(pb);
+  }
+#else
+  poly_batch_ntt_scalar(pb);
+#endif /* FIPS203IPD_AVX2 */
+}
+
+/**
+ * Compute in-place inverse NTT of every polynomial in batch `pb`.
+ * Bounds are the same as `poly_inv_ntt()`.
+ *
+ * Dispatches to the AVX2 or reference C implementation.
+ *
+ * @param[in,out] pb Polynomial batch.
+ */
+static inline void poly_batch_inv_ntt(poly_batch_t * const pb) {
+#ifdef FIPS203IPD_AVX2
+  if (poly_isa() >= ISA_AVX2) {
+    poly_batch_inv_ntt_avx2(pb);
+  } else {
+    poly_batch_inv_ntt_scalar(pb);
+  }
+#else
+  poly_batch_inv_ntt_scalar(pb);
+#endif /* FIPS203IPD_AVX2 */
+}
 
-    for (size_t j = 0; j < 8; j++) {
-      p->cs[8 * i + j] = y[j];
-    }
+/**
+ * Multiply `n` pairs of batches `a[j]` and `b[j]` polynomial by
+ * polynomial, sum the products, and store the sums in batch `c`.
+ * Bounds are the same as `poly_basemul_acc()`.
+ *
+ * Dispatches to the AVX2 or reference C implementation.
+ *
+ * @param[out] c Sums of products, in the NTT domain.
+ * @param[in] a Input batches, in the NTT domain.
+ * @param[in] b Input batches, in the NTT domain.
+ * @param[in] n Number of products (at most 4).
+ */
+static inline void poly_batch_basemul_acc(poly_batch_t * const restrict c, const poly_batch_t * const restrict a, const poly_batch_t * const restrict b, const size_t n) {
+#ifdef FIPS203IPD_AVX2
+  if (poly_isa() >= ISA_AVX2) {
+    poly_batch_basemul_acc_avx2(c, a, b, n);
+  } else {
+    poly_batch_basemul_acc_scalar(c, a, b, n);
   }
+#else
+  poly_batch_basemul_acc_scalar(c, a, b, n);
+#endif /* FIPS203IPD_AVX2 */
 }
 
 /**
- * Decode packed 4-bit coefficients from input buffer `b` into output
- * polynomial `p`.
+ * Define function which samples the first `n` polynomials of batch `pb`
+ * from CBD(ETA), like `poly_sample_cbdETA()`: polynomial `k` is sampled
+ * from the PRF output for `seed` and byte `bs[k]`.  Unused polynomials
+ * in the batch are set to zero.
  *
- * @param[out] p Output polynomial.
- * @param[in] b Input buffer (128 bytes).
+ * The PRF output is transposed so that the bit extraction runs in
+ * lockstep across the batch with no branches, which lets the compiler
+ * vectorize it.
+ *
+ * @param[out] pb Output batch with CBD(ETA) distributed coefficients.
+ * @param[in] seed 32-byte input value used as PRF seed.
+ * @param[in] bs 1 byte input values used as PRF seeds (one for each
+ * polynomial).
+ * @param[in] n Number of polynomials (at most POLY_BATCH_SIZE).
  */
-static inline void poly_decode_4bit(poly_t * const p, const uint8_t b[static 128]) {
-  for (size_t i = 0; i < 128; i++) {
-    const uint8_t x[2] = { b[i] & 0x0f, (b[i] & 0xf0) >> 4 };
+#define DEF_POLY_BATCH_SAMPLE_CBD(ETA) \
+  static inline void poly_batch_sample_cbd ## ETA (poly_batch_t * const pb, const uint8_t seed[32], const uint8_t * const bs, const size_t n) { \
+    /* read 64 * eta bytes of data from prf for each polynomial, */ \
+    /* transpose into `ts` */ \
+    uint8_t bufs[POLY_BATCH_SIZE][64 * ETA] = { 0 }; \
+    prfs(seed, bs, n, bufs[0], sizeof(bufs[0])); \
+    uint8_t ts[64 * ETA][POLY_BATCH_SIZE] = { 0 }; \
+    for (size_t k = 0; k < n; k++) { \
+      for (size_t i = 0; i < sizeof(bufs[0]); i++) { \
+        ts[i][k] = bufs[k][i]; \
+      } \
+    } \
+    \
+    for (size_t i = 0; i < 256; i++) { \
+      for (size_t l = 0; l < POLY_BATCH_SIZE; l++) { \
+        uint16_t x = 0; \
+        for (size_t j = 0; j < ETA; j++) { \
+          const size_t ofs = 2 * i * ETA + j; \
+          x += (ts[ofs / 8][l] >> (ofs % 8)) & 0x01; \
+        } \
+        \
+        uint16_t y = 0; \
+        for (size_t j = 0; j < ETA; j++) { \
+          const size_t ofs = 2 * i * ETA + ETA + j; \
+          y += (ts[ofs / 8][l] >> (ofs % 8)) & 0x01; \
+        } \
+        \
+        /* x - y (centered), zero for unused polynomials */ \
+        pb->cs[i][l] = (l < n) ? (int16_t) (x - y) : 0; \
+      } \
+    } \
+  }
 
-    uint16_t y[2] = { 0 };
-    for (size_t j = 0; j < 16; j++) {
-      for (size_t k = 0; k < 2; k++) {
-        const uint32_t v = (j * Q + (1 << 3)) >> 4; // decode/round
-        y[k] ^= ((x[k] == j) ? 0xfff : 0x000) & v;
-      }
-    }
+// define poly_batch_sample_cbd3() (PKE512_ETA1)
+DEF_POLY_BATCH_SAMPLE_CBD(3)
 
-    p->cs[2 * i + 0] = y[0];
-    p->cs[2 * i + 1] = y[1];
-  }
-}
+// define poly_batch_sample_cbd2() (PKE512_ETA2, PKE768_ETA{1,2}, PKE1024_ETA{1,2}
+DEF_POLY_BATCH_SAMPLE_CBD(2)
 
 /**
- * Decode packed 1-bit coefficients from input buffer `b` into output
- * polynomial `p`.
+ * Compress the coefficients of every polynomial in batch `pb` to `d`
+ * bits, in place.  See `poly_compress()`.
  *
- * @param[out] p Output polynomial.
- * @param[in] b Input buffer (32 bytes).
+ * Coefficients must be in the range [0, Q).  The loop is a flat
+ * multiply-and-shift across the batch so that the compiler can
+ * vectorize it.
+ *
+ * @param[in,out] pb Polynomial batch.
+ * @param[in] d Number of bits in compressed values (1-11).
  */
-static inline void poly_decode_1bit(poly_t * const p, const uint8_t b[static 32]) {
-  for (size_t i = 0; i < 32; i++) {
-    p->cs[8 * i + 0] = ((b[i] & 0x01) ? 0xfff : 0) & 1665;
-    p->cs[8 * i + 1] = ((b[i] & 0x02) ? 0xfff : 0) & 1665;
-    p->cs[8 * i + 2] = ((b[i] & 0x04) ? 0xfff : 0) & 1665;
-    p->cs[8 * i + 3] = ((b[i] & 0x08) ? 0xfff : 0) & 1665;
-    p->cs[8 * i + 4] = ((b[i] & 0x10) ? 0xfff : 0) & 1665;
-    p->cs[8 * i + 5] = ((b[i] & 0x20) ? 0xfff : 0) & 1665;
-    p->cs[8 * i + 6] = ((b[i] & 0x40) ? 0xfff : 0) & 1665;
-    p->cs[8 * i + 7] = ((b[i] & 0x80) ? 0xfff : 0) & 1665;
+static inline void poly_batch_compress(poly_batch_t * const pb, const uint8_t d) {
+  for (size_t i = 0; i < 256; i++) {
+    for (size_t l = 0; l < POLY_BATCH_SIZE; l++) {
+      pb->cs[i][l] = ct_compress(pb->cs[i][l], d);
+    }
   }
 }
 
 // define operations for NxN matrices and N-dim vectors.
 #define DEFINE_MAT_VEC_OPS(N) \
   /* multiply NxN matrix of polynomials in `mat` by vector of */ \
-  /* polynomials in `vec` and store the product in vector `out`. */ \
-  static inline void mat ## N ## _mul(poly_t out[static N], const poly_t mat[static N*N], const poly_t vec[static N]) { \
-    /* clear result */ \
-    memset(out, 0, N * sizeof(poly_t)); \
+  /* polynomials in `vec` and store the product in vector `out` */ \
+  /* (reduced, see `poly_t`).  `vec_mc` holds the mulcaches of `vec` */ \
+  /* (see `vec ## N ## _mulcache()`), or is NULL. */ \
+  static inline void mat ## N ## _mul(poly_t out[static N], const poly_t mat[static N*N], const poly_t vec[static N], const poly_mulcache_t * const vec_mc) { \
     for (size_t y = 0; y < N; y++) { \
-      for (size_t x = 0; x < N; x++) { \
-        poly_t prod = { 0 }; \
-        poly_mul(&prod, mat + (N * y + x), vec + x); \
-        poly_add(out + y, &prod); \
-      } \
+      poly_basemul_acc(out + y, mat + N * y, vec, vec_mc, N); \
+    } \
+  } \
+  \
+  /* compute mulcaches of the polynomials in vector `vec` */ \
+  static inline void vec ## N ## _mulcache(poly_mulcache_t mc[static N], const poly_t vec[static N]) { \
+    for (size_t i = 0; i < N; i++) { \
+      poly_mulcache_compute(mc + i, vec + i); \
     } \
   } \
   \
@@ -952,15 +5791,10 @@ static inline void poly_decode_1bit(poly_t * const p, const uint8_t b[static 32]
     } \
   } \
   \
-  /* Calculate dot product of vectors `a` and `b` and store result in polynomial `c`. */ \
-  static inline void vec ## N ## _dot(poly_t * const restrict c, const poly_t a[static N], const poly_t b[static N]) { \
-    /* clear result */ \
-    memset(c, 0, sizeof(poly_t)); \
-    for (size_t i = 0; i < N; i++) { \
-      poly_t prod = { 0 }; \
-      poly_mul(&prod, a + i, b + i); \
-      poly_add(c, &prod); \
-    } \
+  /* Calculate dot product of vectors `a` and `b` and store result in polynomial `c` */ \
+  /* (reduced, see `poly_t`).  `b_mc` holds the mulcaches of `b`, or is NULL. */ \
+  static inline void vec ## N ## _dot(poly_t * const restrict c, const poly_t a[static N], const poly_t b[static N], const poly_mulcache_t * const b_mc) { \
+    poly_basemul_acc(c, a, b, b_mc, N); \
   } \
   \
   /* apply NTT to vector */ \
@@ -975,6 +5809,13 @@ static inline void poly_decode_1bit(poly_t * const p, const uint8_t b[static 32]
     for (size_t i = 0; i < N; i++) { \
       poly_inv_ntt(vec + i); \
     } \
+  } \
+  \
+  /* reduce vector coefficients to the range [0, Q) before encoding */ \
+  static inline void vec ## N ## _normalize(poly_t vec[static N]) { \
+    for (size_t i = 0; i < N; i++) { \
+      poly_normalize(vec + i); \
+    } \
   }
 
 // define mat2 and vec2 functions
@@ -986,6 +5827,24 @@ DEFINE_MAT_VEC_OPS(3)
 // define mat4 and vec4 functions
 DEFINE_MAT_VEC_OPS(4)
 
+/**
+ * Check that every 12-bit integer in the first `384 * k` bytes of
+ * encapsulation key `ek` is less than Q (modulus check), in constant
+ * time.
+ *
+ * @param[in] ek Encapsulation key (`384 * k + 32` bytes).
+ * @param[in] k Number of polynomials in `t` (2, 3, or 4).
+ * @return True if `ek` passes the check.
+ */
+static inline bool ek_check(const uint8_t * const ek, const size_t k) {
+  bool ok = true;
+  for (size_t i = 0; i < k; i++) {
+    poly_t t = { 0 };
+    ok &= poly_decode(&t, ek + 384 * i);
+  }
+  return ok;
+}
+
 /**
  * Generate PKE512 encryption and decryption key from given 32-byte
  * seed.
@@ -1000,20 +5859,10 @@ static inline void pke512_keygen(uint8_t ek[static PKE512_EK_SIZE], uint8_t dk[s
   sha3_512(seed, 32, rs); // rho, sigma = sha3-512(seed)
   const uint8_t * const sigma = rs + 32; // sigma
 
-  // sample A hat matrix polynomial coefficients from T_q (NTT)
-  poly_t a[PKE512_K * PKE512_K] = { 0 };
-  for (size_t i = 0; i < PKE512_K; i++) {
-    for (size_t j = 0; j < PKE512_K; j++) {
-      poly_sample_ntt(a + (PKE512_K * i + j), rs, i, j);
-    }
-  }
-
   // sample poly coefs for vectors s and e from CBD(3) (PKE512_ETA1)
   // (note: sampling is done in R_q, not in NTT domain)
   poly_t se[2 * PKE512_K] = { 0 }; // s = se[0, k], e = se[k, 2k-1]
-  for (size_t i = 0; i < 2 * PKE512_K; i++) {
-    poly_sample_cbd3(se + i, sigma, i);
-  }
+  polys_sample_cbd(se, sigma, PKE512_ETA1, 2 * PKE512_K, 0);
 
   // apply NTT to polynomial coefficients (R_q -> T_q)
   vec2_ntt(se);
@@ -1021,8 +5870,11 @@ static inline void pke512_keygen(uint8_t ek[static PKE512_EK_SIZE], uint8_t dk[s
 
   // t = As + e (NTT)
   poly_t t[PKE512_K] = { 0 }, *s = se, *e = se + PKE512_K;
-  mat2_mul(t, a, s); // t = As
+  poly_mulcache_t s_mc[PKE512_K] = { 0 };
+  vec2_mulcache(s_mc, s); // s_mc = mulcache(s)
+  mat_mul_sample_ntt(t, PKE512_K, rs, false, s, s_mc); // t = As (A hat sampled from T_q)
   vec2_add(t, e); // t += e
+  vec2_normalize(t); // reduce t for encoding
 
   // encode t (NTT)
   for (size_t i = 0; i < PKE512_K; i++) {
@@ -1033,6 +5885,7 @@ static inline void pke512_keygen(uint8_t ek[static PKE512_EK_SIZE], uint8_t dk[s
   memcpy(ek + (PKE512_K * 384), rs, 32);
 
   // dk <- s (NTT)
+  vec2_normalize(s); // reduce s for encoding
   for (size_t i = 0; i < PKE512_K; i++) {
     poly_encode(dk + (384 * i), se + i);
   }
@@ -1053,45 +5906,31 @@ static inline void pke512_encrypt(uint8_t ct[static PKE512_CT_SIZE], const uint8
   poly_t t[PKE512_K] = { 0 };
   for (size_t i = 0; i < PKE512_K; i++) {
     poly_decode(t + i, ek + (384 * i));
+    poly_tomont(t + i);
   }
 
   // read rho from ek (32 bytes)
   const uint8_t * const rho = ek + 384 * PKE512_K;
 
-  // sample A hat transposed matrix polynomial coefficients from T_q (NTT)
-  // (note: i and j are positions are swapped vs `pke512_keygen()`)
-  poly_t a[PKE512_K * PKE512_K] = { 0 };
-  for (size_t i = 0; i < PKE512_K; i++) {
-    for (size_t j = 0; j < PKE512_K; j++) {
-      poly_sample_ntt(a + (PKE512_K * i + j), rho, j, i);
-    }
-  }
-
-  // sample r vector from CBD(3) (PKE512_ETA1)
-  poly_t r[PKE512_K] = { 0 };
-  for (size_t i = 0; i < PKE512_K; i++) {
-    poly_sample_cbd3(r + i, enc_rand, i);
-  }
+  // sample r vector from CBD(3) (PKE512_ETA1), e1 vector from CBD(2)
+  // (PKE512_ETA2), and e2 polynomial from CBD(2) (PKE512_ETA2)
+  poly_t ree[2 * PKE512_K + 1] = { 0 }; // r = ree[0, k-1], e1 = ree[k, 2k-1], e2 = ree[2k]
+  polys_sample_cbd(ree, enc_rand, PKE512_ETA1, PKE512_K, PKE512_K + 1);
+  poly_t * const r = ree, * const e1 = ree + PKE512_K, * const e2 = ree + 2 * PKE512_K;
   vec2_ntt(r); // r = NTT(r)
 
-  // sample e1 vector from CBD(2) (PKE512_ETA2)
-  poly_t e1[PKE512_K] = { 0 };
-  for (size_t i = 0; i < PKE512_K; i++) {
-    poly_sample_cbd2(e1 + i, enc_rand, PKE512_K + i);
-  }
-
-  // sample e2 polynomial from CBD(2) (PKE512_ETA2)
-  poly_t e2 = { 0 };
-  poly_sample_cbd2(&e2, enc_rand, 2 * PKE512_K);
+  // precompute mulcache of r (used by A*r and t*r)
+  poly_mulcache_t r_mc[PKE512_K] = { 0 };
+  vec2_mulcache(r_mc, r);
 
   poly_t u[PKE512_K] = { 0 };
-  mat2_mul(u, a, r);  // u = (A*r)
-  vec2_inv_ntt(u);    // u = InvNTT(u)
-  vec2_add(u, e1);    // u += e1
-
-  // encode u, append to ct
+  // u = (A*r), with A hat transposed and sampled from T_q (note: i and
+  // j positions are swapped vs `pke512_keygen()`)
+  mat_mul_sample_ntt(u, PKE512_K, rho, true, r, r_mc);
+  // u = InvNTT(u) + e1, compressed and encoded into ct as each
+  // polynomial leaves the inverse NTT
   for (size_t i = 0; i < PKE512_K; i++) {
-    poly_encode_10bit(ct +  32 * PKE512_DU * i, u + i);
+    poly_inv_ntt_encode(ct + 32 * PKE512_DU * i, u + i, e1 + i, PKE512_DU);
   }
 
   // decode message `m` into polynomial `mu`
@@ -1103,10 +5942,11 @@ static inline void pke512_encrypt(uint8_t ct[static PKE512_CT_SIZE], const uint8
   poly_decode_1bit(&mu, m);
 
   poly_t v = { 0 };
-  vec2_dot(&v, t, r); // v = t * r
+  vec2_dot(&v, t, r, r_mc); // v = t * r
   poly_inv_ntt(&v);   // v = InvNTT(v)
-  poly_add(&v, &e2);  // v += e2
+  poly_add(&v, e2);   // v += e2
   poly_add(&v, &mu);  // v += mu
+  poly_normalize(&v); // reduce v for compression
 
   // encode v, append to ct
   poly_encode_4bit(ct + 32 * PKE512_DU * PKE512_K, &v);
@@ -1121,10 +5961,10 @@ static inline void pke512_encrypt(uint8_t ct[static PKE512_CT_SIZE], const uint8
  * @param[in] ct Input ciphertext buffer (768 bytes).
  */
 static inline void pke512_decrypt(uint8_t m[static 32], const uint8_t dk[static PKE512_DK_SIZE], const uint8_t ct[PKE512_CT_SIZE]) {
-  // decode u
+  // decode u, u = NTT(u)
   poly_t u[PKE512_K] = { 0 };
   for (size_t i = 0; i < PKE512_K; i++) {
-    poly_decode_10bit(u + i, ct + 32 * PKE512_DU * i);
+    poly_decode_ntt(u + i, ct + 32 * PKE512_DU * i, PKE512_DU);
   }
 
   // decode v
@@ -1135,15 +5975,16 @@ static inline void pke512_decrypt(uint8_t m[static 32], const uint8_t dk[static
   poly_t s[PKE512_K] = { 0 };
   for (size_t i = 0; i < PKE512_K; i++) {
     poly_decode(s + i, dk + 384 * i);
+    poly_tomont(s + i);
   }
 
   poly_t su = { 0 }; // su = s * u
-  vec2_ntt(u); // u = NTT(u)
-  vec2_dot(&su, s, u); // su = s * u
+  vec2_dot(&su, s, u, NULL); // su = s * u
   poly_inv_ntt(&su); // su = InvNTT(su)
 
   poly_t w = v;
   poly_sub(&w, &su); // w -= su
+  poly_normalize(&w); // reduce w for compression
 
   // encode w coefficients as 1-bit, write to output
   poly_encode_1bit(m, &w);
@@ -1216,6 +6057,17 @@ void fips203ipd_kem512_encaps(uint8_t k[static 32], uint8_t ct[static FIPS203IPD
   pke512_encrypt(ct, ek, seed, r); // ct <- pke.encrypt(ek, seed, r)
 }
 
+/**
+ * @brief Check KEM512 encapsulation key `ek`.
+ * @ingroup kem512
+ *
+ * @param[in] ek KEM512 encapsulation key (800 bytes).
+ * @return True if `ek` passes the modulus check.
+ */
+bool fips203ipd_kem512_ek_check(const uint8_t ek[static FIPS203IPD_KEM512_EK_SIZE]) {
+  return ek_check(ek, PKE512_K);
+}
+
 /**
  * @brief Decapsulate shared key `key` from ciphertext `ct` using KEM512
  * decapsulation key `dk` with implicit rejection.
@@ -1273,20 +6125,10 @@ static inline void pke768_keygen(uint8_t ek[static PKE768_EK_SIZE], uint8_t dk[s
   sha3_512(seed, 32, rs); // rho, sigma = sha3-512(seed)
   const uint8_t * const sigma = rs + 32; // sigma
 
-  // sample A hat matrix polynomial coefficients from T_q (NTT)
-  poly_t a[PKE768_K * PKE768_K] = { 0 };
-  for (size_t i = 0; i < PKE768_K; i++) {
-    for (size_t j = 0; j < PKE768_K; j++) {
-      poly_sample_ntt(a + (PKE768_K * i + j), rs, i, j);
-    }
-  }
-
   // sample poly coefs for vectors s and e from CBD(2) (PKE768_ETA1)
   // (note: sampling is done in R_q, not in NTT domain)
   poly_t se[2 * PKE768_K] = { 0 }; // s = se[0, k], e = se[k, 2k-1]
-  for (size_t i = 0; i < 2 * PKE768_K; i++) {
-    poly_sample_cbd2(se + i, sigma, i);
-  }
+  polys_sample_cbd(se, sigma, PKE768_ETA1, 2 * PKE768_K, 0);
 
   // apply NTT to polynomial coefficients (R_q -> T_q)
   vec3_ntt(se);
@@ -1294,8 +6136,11 @@ static inline void pke768_keygen(uint8_t ek[static PKE768_EK_SIZE], uint8_t dk[s
 
   // t = As + e (NTT)
   poly_t t[PKE768_K] = { 0 }, *s = se, *e = se + PKE768_K;
-  mat3_mul(t, a, s); // t = As
+  poly_mulcache_t s_mc[PKE768_K] = { 0 };
+  vec3_mulcache(s_mc, s); // s_mc = mulcache(s)
+  mat_mul_sample_ntt(t, PKE768_K, rs, false, s, s_mc); // t = As (A hat sampled from T_q)
   vec3_add(t, e); // t += e
+  vec3_normalize(t); // reduce t for encoding
 
   // encode t (NTT)
   for (size_t i = 0; i < PKE768_K; i++) {
@@ -1306,6 +6151,7 @@ static inline void pke768_keygen(uint8_t ek[static PKE768_EK_SIZE], uint8_t dk[s
   memcpy(ek + (PKE768_K * 384), rs, 32);
 
   // dk <- s (NTT)
+  vec3_normalize(s); // reduce s for encoding
   for (size_t i = 0; i < PKE768_K; i++) {
     poly_encode(dk + (384 * i), se + i);
   }
@@ -1326,45 +6172,31 @@ static inline void pke768_encrypt(uint8_t ct[static PKE768_CT_SIZE], const uint8
   poly_t t[PKE768_K] = { 0 };
   for (size_t i = 0; i < PKE768_K; i++) {
     poly_decode(t + i, ek + (384 * i));
+    poly_tomont(t + i);
   }
 
   // read rho from ek (32 bytes)
   const uint8_t * const rho = ek + 384 * PKE768_K;
 
-  // sample A hat transposed matrix polynomial coefficients from T_q (NTT)
-  // (note: i and j are positions are swapped vs `pke768_keygen()`)
-  poly_t a[PKE768_K * PKE768_K] = { 0 };
-  for (size_t i = 0; i < PKE768_K; i++) {
-    for (size_t j = 0; j < PKE768_K; j++) {
-      poly_sample_ntt(a + (PKE768_K * i + j), rho, j, i);
-    }
-  }
-
-  // sample r vector from CBD(2) (PKE768_ETA1)
-  poly_t r[PKE768_K] = { 0 };
-  for (size_t i = 0; i < PKE768_K; i++) {
-    poly_sample_cbd2(r + i, enc_rand, i);
-  }
+  // sample r vector from CBD(2) (PKE768_ETA1), e1 vector from CBD(2)
+  // (PKE768_ETA2), and e2 polynomial from CBD(2) (PKE768_ETA2)
+  poly_t ree[2 * PKE768_K + 1] = { 0 }; // r = ree[0, k-1], e1 = ree[k, 2k-1], e2 = ree[2k]
+  polys_sample_cbd(ree, enc_rand, PKE768_ETA1, PKE768_K, PKE768_K + 1);
+  poly_t * const r = ree, * const e1 = ree + PKE768_K, * const e2 = ree + 2 * PKE768_K;
   vec3_ntt(r); // r = NTT(r)
 
-  // sample e1 vector from CBD(2) (PKE768_ETA2)
-  poly_t e1[PKE768_K] = { 0 };
-  for (size_t i = 0; i < PKE768_K; i++) {
-    poly_sample_cbd2(e1 + i, enc_rand, PKE768_K + i);
-  }
-
-  // sample e2 polynomial from CBD(2) (PKE768_ETA2)
-  poly_t e2 = { 0 };
-  poly_sample_cbd2(&e2, enc_rand, 2 * PKE768_K);
+  // precompute mulcache of r (used by A*r and t*r)
+  poly_mulcache_t r_mc[PKE768_K] = { 0 };
+  vec3_mulcache(r_mc, r);
 
   poly_t u[PKE768_K] = { 0 };
-  mat3_mul(u, a, r);  // u = (A*r)
-  vec3_inv_ntt(u);    // u = InvNTT(u)
-  vec3_add(u, e1);    // u += e1
-
-  // encode u, append to ct
+  // u = (A*r), with A hat transposed and sampled from T_q (note: i and
+  // j positions are swapped vs `pke768_keygen()`)
+  mat_mul_sample_ntt(u, PKE768_K, rho, true, r, r_mc);
+  // u = InvNTT(u) + e1, compressed and encoded into ct as each
+  // polynomial leaves the inverse NTT
   for (size_t i = 0; i < PKE768_K; i++) {
-    poly_encode_10bit(ct + 32 * PKE768_DU * i, u + i);
+    poly_inv_ntt_encode(ct + 32 * PKE768_DU * i, u + i, e1 + i, PKE768_DU);
   }
 
   // decode message `m` into polynomial `mu`
@@ -1376,10 +6208,11 @@ static inline void pke768_encrypt(uint8_t ct[static PKE768_CT_SIZE], const uint8
   poly_decode_1bit(&mu, m);
 
   poly_t v = { 0 };
-  vec3_dot(&v, t, r); // v = t * r
+  vec3_dot(&v, t, r, r_mc); // v = t * r
   poly_inv_ntt(&v);   // v = InvNTT(v)
-  poly_add(&v, &e2);  // v += e2
+  poly_add(&v, e2);   // v += e2
   poly_add(&v, &mu);  // v += mu
+  poly_normalize(&v); // reduce v for compression
 
   // encode v, append to ct
   poly_encode_4bit(ct + 32 * PKE768_DU * PKE768_K, &v);
@@ -1394,10 +6227,10 @@ static inline void pke768_encrypt(uint8_t ct[static PKE768_CT_SIZE], const uint8
  * @param[in] ct Input ciphertext buffer (1088 bytes).
  */
 static inline void pke768_decrypt(uint8_t m[static 32], const uint8_t dk[static PKE768_DK_SIZE], const uint8_t ct[PKE768_CT_SIZE]) {
-  // decode u
+  // decode u, u = NTT(u)
   poly_t u[PKE768_K] = { 0 };
   for (size_t i = 0; i < PKE768_K; i++) {
-    poly_decode_10bit(u + i, ct + 32 * PKE768_DU * i);
+    poly_decode_ntt(u + i, ct + 32 * PKE768_DU * i, PKE768_DU);
   }
 
   // decode v
@@ -1408,15 +6241,16 @@ static inline void pke768_decrypt(uint8_t m[static 32], const uint8_t dk[static
   poly_t s[PKE768_K] = { 0 };
   for (size_t i = 0; i < PKE768_K; i++) {
     poly_decode(s + i, dk + 384 * i);
+    poly_tomont(s + i);
   }
 
   poly_t su = { 0 }; // su = s * u
-  vec3_ntt(u); // u = NTT(u)
-  vec3_dot(&su, s, u); // su = s * u
+  vec3_dot(&su, s, u, NULL); // su = s * u
   poly_inv_ntt(&su); // su = InvNTT(su)
 
   poly_t w = v;
   poly_sub(&w, &su); // w -= su
+  poly_normalize(&w); // reduce w for compression
 
   // encode w coefficients as 1-bit, write to output
   poly_encode_1bit(m, &w);
@@ -1489,6 +6323,17 @@ void fips203ipd_kem768_encaps(uint8_t key[static 32], uint8_t ct[static FIPS203I
   pke768_encrypt(ct, ek, seed, r); // ct <- pke.encrypt(ek, seed, r)
 }
 
+/**
+ * @brief Check KEM768 encapsulation key `ek`.
+ * @ingroup kem768
+ *
+ * @param[in] ek KEM768 encapsulation key (1184 bytes).
+ * @return True if `ek` passes the modulus check.
+ */
+bool fips203ipd_kem768_ek_check(const uint8_t ek[static FIPS203IPD_KEM768_EK_SIZE]) {
+  return ek_check(ek, PKE768_K);
+}
+
 /**
  * @brief Decapsulate shared key `key` from ciphertext `ct` using KEM768
  * decapsulation key `dk` with implicit rejection.
@@ -1546,20 +6391,10 @@ static inline void pke1024_keygen(uint8_t ek[static PKE1024_EK_SIZE], uint8_t dk
   sha3_512(seed, 32, rs); // rho, sigma = sha3-512(seed)
   const uint8_t * const sigma = rs + 32; // sigma
 
-  // sample A hat matrix polynomial coefficients from T_q (NTT)
-  poly_t a[PKE1024_K * PKE1024_K] = { 0 };
-  for (size_t i = 0; i < PKE1024_K; i++) {
-    for (size_t j = 0; j < PKE1024_K; j++) {
-      poly_sample_ntt(a + (PKE1024_K * i + j), rs, i, j);
-    }
-  }
-
   // sample poly coefs for vectors s and e from CBD(2) (PKE1024_ETA1)
   // (note: sampling is done in R_q, not in NTT domain)
   poly_t se[2 * PKE1024_K] = { 0 }; // s = se[0, k], e = se[k, 2k-1]
-  for (size_t i = 0; i < 2 * PKE1024_K; i++) {
-    poly_sample_cbd2(se + i, sigma, i);
-  }
+  polys_sample_cbd(se, sigma, PKE1024_ETA1, 2 * PKE1024_K, 0);
 
   // apply NTT to polynomial coefficients (R_q -> T_q)
   vec4_ntt(se);
@@ -1567,8 +6402,11 @@ static inline void pke1024_keygen(uint8_t ek[static PKE1024_EK_SIZE], uint8_t dk
 
   // t = As + e (NTT)
   poly_t t[PKE1024_K] = { 0 }, *s = se, *e = se + PKE1024_K;
-  mat4_mul(t, a, s); // t = As
+  poly_mulcache_t s_mc[PKE1024_K] = { 0 };
+  vec4_mulcache(s_mc, s); // s_mc = mulcache(s)
+  mat_mul_sample_ntt(t, PKE1024_K, rs, false, s, s_mc); // t = As (A hat sampled from T_q)
   vec4_add(t, e); // t += e
+  vec4_normalize(t); // reduce t for encoding
 
   // encode t (NTT)
   for (size_t i = 0; i < PKE1024_K; i++) {
@@ -1579,6 +6417,7 @@ static inline void pke1024_keygen(uint8_t ek[static PKE1024_EK_SIZE], uint8_t dk
   memcpy(ek + (PKE1024_K * 384), rs, 32);
 
   // dk <- s (NTT)
+  vec4_normalize(s); // reduce s for encoding
   for (size_t i = 0; i < PKE1024_K; i++) {
     poly_encode(dk + (384 * i), se + i);
   }
@@ -1599,45 +6438,31 @@ static inline void pke1024_encrypt(uint8_t ct[static PKE1024_CT_SIZE], const uin
   poly_t t[PKE1024_K] = { 0 };
   for (size_t i = 0; i < PKE1024_K; i++) {
     poly_decode(t + i, ek + (384 * i));
+    poly_tomont(t + i);
   }
 
   // read rho from ek (32 bytes)
   const uint8_t * const rho = ek + 384 * PKE1024_K;
 
-  // sample A hat transposed matrix polynomial coefficients from T_q (NTT)
-  // (note: i and j are positions are swapped vs `pke1024_keygen()`)
-  poly_t a[PKE1024_K * PKE1024_K] = { 0 };
-  for (size_t i = 0; i < PKE1024_K; i++) {
-    for (size_t j = 0; j < PKE1024_K; j++) {
-      poly_sample_ntt(a + (PKE1024_K * i + j), rho, j, i);
-    }
-  }
-
-  // sample r vector from CBD(2) (PKE1024_ETA1)
-  poly_t r[PKE1024_K] = { 0 };
-  for (size_t i = 0; i < PKE1024_K; i++) {
-    poly_sample_cbd2(r + i, enc_rand, i);
-  }
+  // sample r vector from CBD(2) (PKE1024_ETA1), e1 vector from CBD(2)
+  // (PKE1024_ETA2), and e2 polynomial from CBD(2) (PKE1024_ETA2)
+  poly_t ree[2 * PKE1024_K + 1] = { 0 }; // r = ree[0, k-1], e1 = ree[k, 2k-1], e2 = ree[2k]
+  polys_sample_cbd(ree, enc_rand, PKE1024_ETA1, PKE1024_K, PKE1024_K + 1);
+  poly_t * const r = ree, * const e1 = ree + PKE1024_K, * const e2 = ree + 2 * PKE1024_K;
   vec4_ntt(r); // r = NTT(r)
 
-  // sample e1 vector from CBD(2) (PKE1024_ETA2)
-  poly_t e1[PKE1024_K] = { 0 };
-  for (size_t i = 0; i < PKE1024_K; i++) {
-    poly_sample_cbd2(e1 + i, enc_rand, PKE1024_K + i);
-  }
-
-  // sample e2 polynomial from CBD(2) (PKE1024_ETA2)
-  poly_t e2 = { 0 };
-  poly_sample_cbd2(&e2, enc_rand, 2 * PKE1024_K);
+  // precompute mulcache of r (used by A*r and t*r)
+  poly_mulcache_t r_mc[PKE1024_K] = { 0 };
+  vec4_mulcache(r_mc, r);
 
   poly_t u[PKE1024_K] = { 0 };
-  mat4_mul(u, a, r);  // u = (A*r)
-  vec4_inv_ntt(u);    // u = InvNTT(u)
-  vec4_add(u, e1);    // u += e1
-
-  // encode u, append to ct
+  // u = (A*r), with A hat transposed and sampled from T_q (note: i and
+  // j positions are swapped vs `pke1024_keygen()`)
+  mat_mul_sample_ntt(u, PKE1024_K, rho, true, r, r_mc);
+  // u = InvNTT(u) + e1, compressed and encoded into ct as each
+  // polynomial leaves the inverse NTT
   for (size_t i = 0; i < PKE1024_K; i++) {
-    poly_encode_11bit(ct + 32 * PKE1024_DU * i, u + i);
+    poly_inv_ntt_encode(ct + 32 * PKE1024_DU * i, u + i, e1 + i, PKE1024_DU);
   }
 
   // decode message `m` into polynomial `mu`
@@ -1649,10 +6474,11 @@ static inline void pke1024_encrypt(uint8_t ct[static PKE1024_CT_SIZE], const uin
   poly_decode_1bit(&mu, m);
 
   poly_t v = { 0 };
-  vec4_dot(&v, t, r); // v = t * r
+  vec4_dot(&v, t, r, r_mc); // v = t * r
   poly_inv_ntt(&v);   // v = InvNTT(v)
-  poly_add(&v, &e2);  // v += e2
+  poly_add(&v, e2);   // v += e2
   poly_add(&v, &mu);  // v += mu
+  poly_normalize(&v); // reduce v for compression
 
   // encode v, append to ct
   poly_encode_5bit(ct + 32 * PKE1024_DU * PKE1024_K, &v);
@@ -1667,10 +6493,10 @@ static inline void pke1024_encrypt(uint8_t ct[static PKE1024_CT_SIZE], const uin
  * @param[in] ct Input ciphertext buffer (1568 bytes).
  */
 static inline void pke1024_decrypt(uint8_t m[static 32], const uint8_t dk[static PKE1024_DK_SIZE], const uint8_t ct[PKE1024_CT_SIZE]) {
-  // decode u
+  // decode u, u = NTT(u)
   poly_t u[PKE1024_K] = { 0 };
   for (size_t i = 0; i < PKE1024_K; i++) {
-    poly_decode_11bit(u + i, ct + 32 * PKE1024_DU * i);
+    poly_decode_ntt(u + i, ct + 32 * PKE1024_DU * i, PKE1024_DU);
   }
 
   // decode v
@@ -1681,15 +6507,16 @@ static inline void pke1024_decrypt(uint8_t m[static 32], const uint8_t dk[static
   poly_t s[PKE1024_K] = { 0 };
   for (size_t i = 0; i < PKE1024_K; i++) {
     poly_decode(s + i, dk + 384 * i);
+    poly_tomont(s + i);
   }
 
   poly_t su = { 0 }; // su = s * u
-  vec4_ntt(u); // u = NTT(u)
-  vec4_dot(&su, s, u); // su = s * u
+  vec4_dot(&su, s, u, NULL); // su = s * u
   poly_inv_ntt(&su); // su = InvNTT(su)
 
   poly_t w = v;
   poly_sub(&w, &su); // w -= su
+  poly_normalize(&w); // reduce w for compression
 
   // encode w coefficients as 1-bit, write to output
   poly_encode_1bit(m, &w);
@@ -1762,6 +6589,17 @@ void fips203ipd_kem1024_encaps(uint8_t key[static 32], uint8_t ct[static FIPS203
   pke1024_encrypt(ct, ek, seed, r); // ct <- pke.encrypt(ek, seed, r)
 }
 
+/**
+ * @brief Check KEM1024 encapsulation key `ek`.
+ * @ingroup kem1024
+ *
+ * @param[in] ek KEM1024 encapsulation key (1568 bytes).
+ * @return True if `ek` passes the modulus check.
+ */
+bool fips203ipd_kem1024_ek_check(const uint8_t ek[static FIPS203IPD_KEM1024_EK_SIZE]) {
+  return ek_check(ek, PKE1024_K);
+}
+
 /**
  * @brief Decapsulate shared key `key` from ciphertext `ct` using KEM1024
  * decapsulation key `dk` with implicit rejection.
@@ -1806,7 +6644,7 @@ void fips203ipd_kem1024_decaps(uint8_t key[static 32], const uint8_t ct[static F
 }
 
 #ifdef TEST_FIPS203IPD
-#include <stdlib.h> // exit()
+#include <stdlib.h> // exit(), malloc()
 #include <stdio.h> // fprintf()
 #include <stddef.h> // size_t
 #include "rand-bytes.h" // rand_bytes()
@@ -1908,6 +6746,7 @@ static void test_poly_ntt_roundtrip(void) {
     // calculate InvNTT(NTT(poly))
     poly_ntt(&got);
     poly_inv_ntt(&got);
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &TESTS[i].poly, sizeof(poly_t))) {
@@ -1920,6 +6759,363 @@ static void test_poly_ntt_roundtrip(void) {
   }
 }
 
+#ifdef FIPS203IPD_VEC
+static void test_poly_vec(void) {
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 66; i++) {
+    // build test polynomials (first two pairs are all zeros and
+    // alternating Q - 1 and -(Q - 1), the rest are uniformly random)
+    poly_t a = { 0 }, b = { 0 };
+    if (i == 1) {
+      for (size_t j = 0; j < 256; j++) {
+        a.cs[j] = b.cs[j] = (j & 1) ? (Q - 1) : -(Q - 1);
+      }
+    } else if (i > 1) {
+      poly_sample_ntt(&a, SEED, i, 0);
+      poly_sample_ntt(&b, SEED, i, 1);
+    }
+
+    // check ntt
+    {
+      poly_t got = a, exp = a;
+      poly_ntt_vec(&got);
+      poly_ntt_scalar(&exp);
+      POLY_CHECK_BOUND(&got, (Q + 1) / 2);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_ntt_vec(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+
+    // check inverse ntt
+    {
+      poly_t got = a, exp = a;
+      poly_inv_ntt_vec(&got);
+      poly_inv_ntt_scalar(&exp);
+      POLY_CHECK_BOUND(&got, Q);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_inv_ntt_vec(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+
+    // check add
+    {
+      poly_t got = a, exp = a;
+      poly_add_vec(&got, &b);
+      poly_add_scalar(&exp, &b);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_add_vec(%zu) failed\n", i);
+      }
+    }
+
+    // check sub
+    {
+      poly_t got = a, exp = a;
+      poly_sub_vec(&got, &b);
+      poly_sub_scalar(&exp, &b);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_sub_vec(%zu) failed\n", i);
+      }
+    }
+
+    // check mul
+    {
+      poly_t got = { 0 }, exp = { 0 };
+      poly_mul_vec(&got, &a, &b);
+      poly_mul_scalar(&exp, &a, &b);
+      POLY_CHECK_BOUND(&got, 2 * Q);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_mul_vec(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+
+    // check compress
+    {
+      poly_t p = a;
+      poly_normalize(&p);
+
+      for (uint8_t d = 1; d <= 11; d++) {
+        uint16_t got[256] = { 0 }, exp[256] = { 0 };
+        poly_compress_vec(got, &p, d);
+        for (size_t k = 0; k < 256; k++) {
+          exp[k] = ct_compress(p.cs[k], d);
+        }
+
+        if (memcmp(got, exp, sizeof(got))) {
+          fprintf(stderr, "test_poly_compress_vec(%zu, %u) failed\n", i, d);
+        }
+      }
+    }
+  }
+}
+#endif /* FIPS203IPD_VEC */
+
+#ifdef FIPS203IPD_AVX2
+static void test_poly_ntt_avx2(void) {
+  if (cpu_isa() < ISA_AVX2) {
+    return; // skip test: cpu does not support avx2
+  }
+
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 66; i++) {
+    // build test polynomial (first two are all zeros and alternating
+    // Q - 1 and -(Q - 1), the rest are uniformly random)
+    poly_t a = { 0 };
+    if (i == 1) {
+      for (size_t j = 0; j < 256; j++) {
+        a.cs[j] = (j & 1) ? (Q - 1) : -(Q - 1);
+      }
+    } else if (i > 1) {
+      poly_sample_ntt(&a, SEED, i, 0);
+    }
+
+    // check ntt
+    {
+      poly_t got = a, exp = a;
+      poly_ntt_avx2(&got);
+      poly_ntt_scalar(&exp);
+      POLY_CHECK_BOUND(&got, (Q + 1) / 2);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_ntt_avx2(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+
+    // check inverse ntt
+    {
+      poly_t got = a, exp = a;
+      poly_inv_ntt_avx2(&got);
+      poly_inv_ntt_scalar(&exp);
+      POLY_CHECK_BOUND(&got, Q);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_inv_ntt_avx2(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+  }
+}
+#endif /* FIPS203IPD_AVX2 */
+
+#ifdef FIPS203IPD_AVX512
+static void test_poly_avx512(void) {
+  if (cpu_isa() < ISA_AVX512) {
+    return; // skip test: cpu does not support avx-512
+  }
+
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 66; i++) {
+    // build test polynomials (first two pairs are all zeros and
+    // alternating Q - 1 and -(Q - 1), the rest are uniformly random)
+    poly_t a = { 0 }, b = { 0 };
+    if (i == 1) {
+      for (size_t j = 0; j < 256; j++) {
+        a.cs[j] = b.cs[j] = (j & 1) ? (Q - 1) : -(Q - 1);
+      }
+    } else if (i > 1) {
+      poly_sample_ntt(&a, SEED, i, 0);
+      poly_sample_ntt(&b, SEED, i, 1);
+    }
+
+    // check ntt
+    {
+      poly_t got = a, exp = a;
+      poly_ntt_avx512(&got);
+      poly_ntt_scalar(&exp);
+      POLY_CHECK_BOUND(&got, (Q + 1) / 2);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_ntt_avx512(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+
+    // check inverse ntt
+    {
+      poly_t got = a, exp = a;
+      poly_inv_ntt_avx512(&got);
+      poly_inv_ntt_scalar(&exp);
+      POLY_CHECK_BOUND(&got, Q);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_inv_ntt_avx512(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+
+    // check add
+    {
+      poly_t got = a, exp = a;
+      poly_add_avx512(&got, &b);
+      poly_add_scalar(&exp, &b);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_add_avx512(%zu) failed\n", i);
+      }
+    }
+
+    // check sub
+    {
+      poly_t got = a, exp = a;
+      poly_sub_avx512(&got, &b);
+      poly_sub_scalar(&exp, &b);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_sub_avx512(%zu) failed\n", i);
+      }
+    }
+
+    // check mul
+    {
+      poly_t got = { 0 }, exp = { 0 };
+      poly_mul_avx512(&got, &a, &b);
+      poly_mul_scalar(&exp, &a, &b);
+      POLY_CHECK_BOUND(&got, 2 * Q);
+      poly_normalize(&got);
+      poly_normalize(&exp);
+
+      if (memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_mul_avx512(%zu) failed, got:\n", i);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+  }
+}
+#endif /* FIPS203IPD_AVX512 */
+
+// test poly_sample_ntt_parse_{scalar,avx2,vbmi2}() against rejection
+// sampling one candidate at a time
+static void test_poly_sample_ntt_parse(void) {
+  // kernels (scalar, then any supported SIMD kernels)
+  static const struct {
+    const char *name; // kernel name
+    const isa_t isa; // required instruction set extension
+    size_t (*fn)(poly_t *, size_t, const uint8_t *, size_t); // kernel
+  } KERNELS[] = {
+    { "scalar", ISA_SCALAR, poly_sample_ntt_parse_scalar },
+#ifdef FIPS203IPD_AVX2
+    { "avx2", ISA_AVX2, poly_sample_ntt_parse_avx2 },
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_AVX512VBMI2
+    { "avx512vbmi2", ISA_AVX512VBMI2, poly_sample_ntt_parse_vbmi2 },
+#endif /* FIPS203IPD_AVX512VBMI2 */
+  };
+
+  // buffer lengths and numbers of coefficients already sampled
+  static const size_t LENS[] = { 3, 24, 48, 51, 72, 168, 3 * SHAKE128_RATE },
+                      NS[] = { 0, 1, 200, 241, 250, 255, 256 };
+
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 16; i++) {
+    // build xof output: all rejected, all accepted, random, and random
+    // with about half of the candidates rejected
+    uint8_t buf[3 * SHAKE128_RATE] = { 0 };
+    if (i == 0) {
+      memset(buf, 0xff, sizeof(buf));
+    } else if (i > 1) {
+      prf(SEED, i, buf, sizeof(buf));
+    }
+    if (i > 8) {
+      for (size_t j = 0; j < sizeof(buf); j += 3) {
+        buf[j + 1] |= (buf[j] & 1) ? 0x0d : 0;
+        buf[j + 2] |= (buf[j] & 2) ? 0xd0 : 0;
+      }
+    }
+
+    for (size_t li = 0; li < sizeof(LENS)/sizeof(LENS[0]); li++) {
+      // parse the last `len` bytes of `buf`, so that reads past the end
+      // of the xof output are caught by the address sanitizer
+      const size_t len = LENS[li];
+      const uint8_t * const src = buf + sizeof(buf) - len;
+
+      for (size_t ni = 0; ni < sizeof(NS)/sizeof(NS[0]); ni++) {
+        // calculate expected coefficients one candidate at a time
+        // (the second polynomial checks for writes past the first)
+        poly_t exp[2] = { 0 };
+        memset(exp, 0x5a, sizeof(exp));
+        size_t exp_n = NS[ni];
+        for (size_t j = 0; j < 2 * len / 3 && exp_n < 256; j++) {
+          const uint8_t * const ds = src + 3 * (j / 2);
+          const uint16_t d = (j & 1) ? ((ds[1] >> 4) | (ds[2] << 4)) : (ds[0] | ((ds[1] & 0xf) << 8));
+          if (d < Q) {
+            exp[0].cs[exp_n++] = d;
+          }
+        }
+
+        for (size_t k = 0; k < sizeof(KERNELS)/sizeof(KERNELS[0]); k++) {
+          if (cpu_isa() < KERNELS[k].isa) {
+            continue; // skip kernel: cpu does not support it
+          }
+
+          poly_t got[2] = { 0 };
+          memset(got, 0x5a, sizeof(got));
+          const size_t got_n = KERNELS[k].fn(got, NS[ni], src, len);
+
+          // check for expected value (coefficients after the first
+          // `got_n` are unspecified) and untouched second polynomial
+          if (got_n != exp_n || memcmp(got[0].cs, exp[0].cs, exp_n * sizeof(int16_t)) || memcmp(got + 1, exp + 1, sizeof(poly_t))) {
+            fprintf(stderr, "test_poly_sample_ntt_parse(%s, %zu, %zu, %zu) failed: got n = %zu, exp n = %zu, got:\n", KERNELS[k].name, i, len, NS[ni], got_n, exp_n);
+            poly_write(stderr, got);
+            fprintf(stderr, "\nexp:\n");
+            poly_write(stderr, exp);
+            fprintf(stderr, "\n");
+          }
+        }
+      }
+    }
+  }
+}
+
 static void test_poly_sample_ntt(void) {
   static const struct {
     const char *name; // test name
@@ -1965,6 +7161,134 @@ static void test_poly_sample_ntt(void) {
   }
 }
 
+static void test_poly_sample_ntt_x4(void) {
+  static const uint8_t IS[4] = { 0, 1, 2, 3 },
+                       JS[4] = { 3, 0, 3, 1 };
+
+  // build seed
+  uint8_t seed[32] = { 0 };
+  for (size_t i = 0; i < sizeof(seed); i++) {
+    seed[i] = i;
+  }
+
+  // sample four polynomials at once
+  poly_t got[4] = { 0 };
+  poly_sample_ntt_x4(got, seed, IS, JS);
+
+  for (size_t i = 0; i < 4; i++) {
+    // sample expected polynomial
+    poly_t exp = { 0 };
+    poly_sample_ntt(&exp, seed, IS[i], JS[i]);
+
+    // check for expected value
+    if (memcmp(got + i, &exp, sizeof(poly_t))) {
+      fprintf(stderr, "test_poly_sample_ntt_x4(%zu) failed, got:\n", i);
+      poly_write(stderr, got + i);
+      fprintf(stderr, "\nexp:\n");
+      poly_write(stderr, &exp);
+      fprintf(stderr, "\n");
+    }
+  }
+}
+
+static void test_poly_sample_ntt_x8(void) {
+  static const uint8_t IS[8] = { 0, 1, 2, 3, 0, 1, 2, 3 },
+                       JS[8] = { 3, 0, 3, 1, 0, 2, 2, 0 };
+
+  // build seed
+  uint8_t seed[32] = { 0 };
+  for (size_t i = 0; i < sizeof(seed); i++) {
+    seed[i] = 3 * i;
+  }
+
+  // sample eight polynomials at once
+  poly_t got[8] = { 0 };
+  poly_sample_ntt_x8(got, seed, IS, JS);
+
+  for (size_t i = 0; i < 8; i++) {
+    // sample expected polynomial
+    poly_t exp = { 0 };
+    poly_sample_ntt(&exp, seed, IS[i], JS[i]);
+
+    // check for expected value
+    if (memcmp(got + i, &exp, sizeof(poly_t))) {
+      fprintf(stderr, "test_poly_sample_ntt_x8(%zu) failed, got:\n", i);
+      poly_write(stderr, got + i);
+      fprintf(stderr, "\nexp:\n");
+      poly_write(stderr, &exp);
+      fprintf(stderr, "\n");
+    }
+  }
+}
+
+static void test_mat_sample_ntt(void) {
+  // build seed
+  uint8_t seed[32] = { 0 };
+  for (size_t i = 0; i < sizeof(seed); i++) {
+    seed[i] = 0xff - i;
+  }
+
+  for (size_t k = 2; k <= 4; k++) {
+    for (size_t t = 0; t < 2; t++) {
+      // sample matrix
+      poly_t got[16] = { 0 };
+      mat_sample_ntt(got, k, seed, t);
+
+      for (size_t i = 0; i < k; i++) {
+        for (size_t j = 0; j < k; j++) {
+          // sample expected entry, convert to Montgomery form
+          poly_t exp = { 0 };
+          poly_sample_ntt(&exp, seed, t ? j : i, t ? i : j);
+          poly_tomont(&exp);
+
+          // check for expected value
+          if (memcmp(got + (k * i + j), &exp, sizeof(poly_t))) {
+            fprintf(stderr, "test_mat_sample_ntt(%zu, %zu, %zu, %zu) failed\n", k, t, i, j);
+          }
+        }
+      }
+    }
+  }
+}
+
+static void test_mat_mul_sample_ntt(void) {
+  // build seed
+  uint8_t seed[32] = { 0 };
+  for (size_t i = 0; i < sizeof(seed); i++) {
+    seed[i] = 0xff - i;
+  }
+
+  // sample input vector and compute mulcaches
+  poly_t vec[4] = { 0 };
+  poly_mulcache_t vec_mc[4] = { 0 };
+  for (size_t i = 0; i < 4; i++) {
+    poly_sample_ntt(vec + i, seed, 4, i);
+    poly_mulcache_compute(vec_mc + i, vec + i);
+  }
+
+  for (size_t k = 2; k <= 4; k++) {
+    for (size_t t = 0; t < 2; t++) {
+      for (size_t c = 0; c < 2; c++) {
+        // get expected product from sampled matrix
+        poly_t a[16] = { 0 }, exp[4] = { 0 };
+        mat_sample_ntt(a, k, seed, t);
+        for (size_t i = 0; i < k; i++) {
+          poly_basemul_acc(exp + i, a + k * i, vec, c ? vec_mc : NULL, k);
+        }
+
+        // get product with streamed matrix
+        poly_t got[4] = { 0 };
+        mat_mul_sample_ntt(got, k, seed, t, vec, c ? vec_mc : NULL);
+
+        // check for expected value (and untouched tail)
+        if (memcmp(got, exp, sizeof(got))) {
+          fprintf(stderr, "test_mat_mul_sample_ntt(%zu, %zu, %zu) failed\n", k, t, c);
+        }
+      }
+    }
+  }
+}
+
 static void test_poly_add(void) {
   static const struct {
     const char *name; // test name
@@ -2014,6 +7338,7 @@ static void test_poly_add(void) {
     // sample polynomial from NTT
     poly_t got = TESTS[i].a;
     poly_add(&got, &(TESTS[i].b));
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &TESTS[i].exp, sizeof(poly_t))) {
@@ -2075,6 +7400,7 @@ static void test_poly_sub(void) {
     // sample polynomial from NTT
     poly_t got = TESTS[i].a;
     poly_sub(&got, &(TESTS[i].b));
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &TESTS[i].exp, sizeof(poly_t))) {
@@ -2184,9 +7510,11 @@ static void test_poly_mul(void) {
     poly_t a = TESTS[i].a, b = TESTS[i].b, got = { 0 };
 
     poly_ntt(&a); // a = NTT(a)
+    poly_tomont(&a); // a = Montgomery form of a
     poly_ntt(&b); // b = NTT(b)
     poly_mul(&got, &a, &b); // got = a * b
-    poly_inv_ntt(&got); // a = InvNTT(a)
+    poly_inv_ntt(&got); // got = InvNTT(got)
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &TESTS[i].exp, sizeof(poly_t))) {
@@ -2199,6 +7527,480 @@ static void test_poly_mul(void) {
   }
 }
 
+// test poly_basemul_acc() and poly_mulcache_compute() kernels against
+// poly_mul_scalar() and poly_add_scalar()
+static void test_poly_basemul_acc(void) {
+  // kernels (scalar, then any supported SIMD kernels)
+  static const struct {
+    const char *name; // kernel name
+    const isa_t isa; // required instruction set extension
+    void (*fn)(poly_t *, const poly_t *, const poly_t *, const poly_mulcache_t *, size_t); // basemul kernel
+    void (*mc_fn)(poly_mulcache_t *, const poly_t *); // mulcache kernel
+  } KERNELS[] = {
+    { "scalar", ISA_SCALAR, poly_basemul_acc_scalar, poly_mulcache_compute_scalar },
+#ifdef FIPS203IPD_VEC
+    { "vec", ISA_VEC, poly_basemul_acc_vec, poly_mulcache_compute_vec },
+#endif /* FIPS203IPD_VEC */
+#ifdef FIPS203IPD_AVX2
+    { "avx2", ISA_AVX2, poly_basemul_acc_avx2, poly_mulcache_compute_avx2 },
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_AVX512
+    { "avx512", ISA_AVX512, poly_basemul_acc_avx512, poly_mulcache_compute_avx512 },
+#endif /* FIPS203IPD_AVX512 */
+  };
+
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 34; i++) {
+    // build test vectors (first has all coefficients set to Q - 1 and
+    // -(Q - 1), the rest are uniformly random)
+    poly_t a[4] = { 0 }, b[4] = { 0 };
+    for (size_t j = 0; j < 4; j++) {
+      if (i == 0) {
+        for (size_t k = 0; k < 256; k++) {
+          a[j].cs[k] = (Q - 1);
+          b[j].cs[k] = (k & 2) ? (Q - 1) : -(Q - 1);
+        }
+      } else {
+        poly_sample_ntt(a + j, SEED, i, j);
+        poly_sample_ntt(b + j, SEED, i, 4 + j);
+      }
+    }
+
+    for (size_t n = 1; n <= 4; n++) {
+      // calculate expected sum of products
+      poly_t exp = { 0 };
+      for (size_t j = 0; j < n; j++) {
+        poly_t prod = { 0 };
+        poly_mul_scalar(&prod, a + j, b + j);
+        poly_add_scalar(&exp, &prod);
+      }
+      poly_normalize(&exp);
+
+      for (size_t j = 0; j < sizeof(KERNELS)/sizeof(KERNELS[0]); j++) {
+        if (cpu_isa() < KERNELS[j].isa) {
+          continue; // skip kernel: cpu does not support it
+        }
+
+        // compute mulcaches of b
+        poly_mulcache_t bc[4] = { 0 };
+        for (size_t k = 0; k < n; k++) {
+          KERNELS[j].mc_fn(bc + k, b + k);
+        }
+
+        // test without (k = 0) and with (k = 1) mulcaches
+        for (size_t k = 0; k < 2; k++) {
+          poly_t got = { 0 };
+          KERNELS[j].fn(&got, a, b, k ? bc : NULL, n);
+          POLY_CHECK_BOUND(&got, Q);
+          poly_normalize(&got);
+
+          // check for expected value
+          if (memcmp(&got, &exp, sizeof(poly_t))) {
+            fprintf(stderr, "test_poly_basemul_acc(%s, %zu, %zu, %s) failed, got:\n", KERNELS[j].name, i, n, k ? "mulcache" : "no mulcache");
+            poly_write(stderr, &got);
+            fprintf(stderr, "\nexp:\n");
+            poly_write(stderr, &exp);
+            fprintf(stderr, "\n");
+          }
+        }
+      }
+    }
+  }
+}
+
+// test poly_batch_load(), poly_batch_store(), and the batch NTT and
+// inverse NTT kernels against poly_ntt_scalar() and
+// poly_inv_ntt_scalar()
+static void test_poly_batch_ntt(void) {
+  // kernels (scalar, then any supported SIMD kernels)
+  static const struct {
+    const char *name; // kernel name
+    const isa_t isa; // required instruction set extension
+    void (*ntt)(poly_batch_t *); // ntt kernel
+    void (*inv_ntt)(poly_batch_t *); // inverse ntt kernel
+  } KERNELS[] = {
+    { "scalar", ISA_SCALAR, poly_batch_ntt_scalar, poly_batch_inv_ntt_scalar },
+#ifdef FIPS203IPD_AVX2
+    { "avx2", ISA_AVX2, poly_batch_ntt_avx2, poly_batch_inv_ntt_avx2 },
+#endif /* FIPS203IPD_AVX2 */
+  };
+
+  const uint8_t SEED[32] = { 0 };
+
+  // build test polynomials (first has alternating Q - 1 and -(Q - 1),
+  // the rest are uniformly random)
+  poly_t ps[POLY_BATCH_SIZE] = { 0 };
+  for (size_t j = 0; j < 256; j++) {
+    ps[0].cs[j] = (j & 1) ? (Q - 1) : -(Q - 1);
+  }
+  for (size_t k = 1; k < POLY_BATCH_SIZE; k++) {
+    poly_sample_ntt(ps + k, SEED, 0, k);
+  }
+
+  // calculate expected values
+  poly_t exp_ntt[POLY_BATCH_SIZE] = { 0 }, exp_inv[POLY_BATCH_SIZE] = { 0 };
+  for (size_t k = 0; k < POLY_BATCH_SIZE; k++) {
+    exp_ntt[k] = ps[k];
+    poly_ntt_scalar(exp_ntt + k);
+    exp_inv[k] = exp_ntt[k];
+    poly_inv_ntt_scalar(exp_inv + k);
+    poly_normalize(exp_ntt + k);
+    poly_normalize(exp_inv + k);
+  }
+
+  for (size_t i = 0; i < sizeof(KERNELS)/sizeof(KERNELS[0]); i++) {
+    if (cpu_isa() < KERNELS[i].isa) {
+      continue; // skip kernel: cpu does not support it
+    }
+
+    // test full and partial batches
+    static const size_t NS[] = { POLY_BATCH_SIZE, 11, 1 };
+    for (size_t ni = 0; ni < sizeof(NS)/sizeof(NS[0]); ni++) {
+      const size_t n = NS[ni];
+      poly_batch_t pb = { 0 };
+      poly_batch_load(&pb, ps, n);
+
+      // check ntt
+      poly_t got[POLY_BATCH_SIZE] = { 0 };
+      KERNELS[i].ntt(&pb);
+      poly_batch_store(got, &pb, n);
+      for (size_t k = 0; k < n; k++) {
+        POLY_CHECK_BOUND(got + k, (Q + 1) / 2);
+        poly_normalize(got + k);
+
+        if (memcmp(got + k, exp_ntt + k, sizeof(poly_t))) {
+          fprintf(stderr, "test_poly_batch_ntt(%s, %zu, %zu) failed, got:\n", KERNELS[i].name, n, k);
+          poly_write(stderr, got + k);
+          fprintf(stderr, "\nexp:\n");
+          poly_write(stderr, exp_ntt + k);
+          fprintf(stderr, "\n");
+        }
+      }
+
+      // check inverse ntt
+      KERNELS[i].inv_ntt(&pb);
+      poly_batch_store(got, &pb, n);
+      for (size_t k = 0; k < n; k++) {
+        POLY_CHECK_BOUND(got + k, Q);
+        poly_normalize(got + k);
+
+        if (memcmp(got + k, exp_inv + k, sizeof(poly_t))) {
+          fprintf(stderr, "test_poly_batch_inv_ntt(%s, %zu, %zu) failed, got:\n", KERNELS[i].name, n, k);
+          poly_write(stderr, got + k);
+          fprintf(stderr, "\nexp:\n");
+          poly_write(stderr, exp_inv + k);
+          fprintf(stderr, "\n");
+        }
+      }
+
+      // check that unused polynomials are still zero
+      for (size_t j = 0; j < 256; j++) {
+        for (size_t k = n; k < POLY_BATCH_SIZE; k++) {
+          if (pb.cs[j][k]) {
+            fprintf(stderr, "test_poly_batch_ntt(%s, %zu): unused polynomial %zu is not zero\n", KERNELS[i].name, n, k);
+            j = 256;
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+// test batch basemul kernels against poly_basemul_acc_scalar()
+static void test_poly_batch_basemul_acc(void) {
+  // kernels (scalar, then any supported SIMD kernels)
+  static const struct {
+    const char *name; // kernel name
+    const isa_t isa; // required instruction set extension
+    void (*fn)(poly_batch_t *, const poly_batch_t *, const poly_batch_t *, size_t); // kernel
+  } KERNELS[] = {
+    { "scalar", ISA_SCALAR, poly_batch_basemul_acc_scalar },
+#ifdef FIPS203IPD_AVX2
+    { "avx2", ISA_AVX2, poly_batch_basemul_acc_avx2 },
+#endif /* FIPS203IPD_AVX2 */
+  };
+
+  const uint8_t SEED[32] = { 0 };
+
+  // build test batches (polynomial 0 of every batch has all
+  // coefficients set to +/-(Q - 1), the rest are uniformly random)
+  static poly_t as[4][POLY_BATCH_SIZE], bs[4][POLY_BATCH_SIZE];
+  poly_batch_t a[4] = { 0 }, b[4] = { 0 };
+  for (size_t j = 0; j < 4; j++) {
+    for (size_t i = 0; i < 256; i++) {
+      as[j][0].cs[i] = (Q - 1);
+      bs[j][0].cs[i] = (i & 2) ? (Q - 1) : -(Q - 1);
+    }
+
+    for (size_t k = 1; k < POLY_BATCH_SIZE; k++) {
+      poly_sample_ntt(as[j] + k, SEED, j, k);
+      poly_sample_ntt(bs[j] + k, SEED, 4 + j, k);
+    }
+
+    poly_batch_load(a + j, as[j], POLY_BATCH_SIZE);
+    poly_batch_load(b + j, bs[j], POLY_BATCH_SIZE);
+  }
+
+  for (size_t n = 1; n <= 4; n++) {
+    for (size_t i = 0; i < sizeof(KERNELS)/sizeof(KERNELS[0]); i++) {
+      if (cpu_isa() < KERNELS[i].isa) {
+        continue; // skip kernel: cpu does not support it
+      }
+
+      poly_batch_t c = { 0 };
+      KERNELS[i].fn(&c, a, b, n);
+
+      poly_t got[POLY_BATCH_SIZE] = { 0 };
+      poly_batch_store(got, &c, POLY_BATCH_SIZE);
+
+      for (size_t k = 0; k < POLY_BATCH_SIZE; k++) {
+        // calculate expected value
+        poly_t pa[4] = { 0 }, pb[4] = { 0 }, exp = { 0 };
+        for (size_t j = 0; j < n; j++) {
+          pa[j] = as[j][k];
+          pb[j] = bs[j][k];
+        }
+        poly_basemul_acc_scalar(&exp, pa, pb, NULL, n);
+        poly_normalize(&exp);
+
+        POLY_CHECK_BOUND(got + k, Q);
+        poly_normalize(got + k);
+
+        // check for expected value
+        if (memcmp(got + k, &exp, sizeof(poly_t))) {
+          fprintf(stderr, "test_poly_batch_basemul_acc(%s, %zu, %zu) failed, got:\n", KERNELS[i].name, n, k);
+          poly_write(stderr, got + k);
+          fprintf(stderr, "\nexp:\n");
+          poly_write(stderr, &exp);
+          fprintf(stderr, "\n");
+        }
+      }
+    }
+  }
+}
+
+// test poly_batch_sample_cbd{2,3}() against poly_sample_cbd{2,3}()
+static void test_poly_batch_sample_cbd(void) {
+  static const uint8_t SEED[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+  };
+
+  // prf bytes (one for each polynomial)
+  uint8_t bs[POLY_BATCH_SIZE] = { 0 };
+  for (size_t k = 0; k < POLY_BATCH_SIZE; k++) {
+    bs[k] = 3 * k + 1;
+  }
+
+  // test full and partial batches
+  static const size_t NS[] = { POLY_BATCH_SIZE, 11, 1 };
+  for (size_t ni = 0; ni < sizeof(NS)/sizeof(NS[0]); ni++) {
+    const size_t n = NS[ni];
+    poly_batch_t pb2 = { 0 }, pb3 = { 0 };
+    poly_batch_sample_cbd2(&pb2, SEED, bs, n);
+    poly_batch_sample_cbd3(&pb3, SEED, bs, n);
+
+    poly_t got2[POLY_BATCH_SIZE] = { 0 }, got3[POLY_BATCH_SIZE] = { 0 };
+    poly_batch_store(got2, &pb2, POLY_BATCH_SIZE);
+    poly_batch_store(got3, &pb3, POLY_BATCH_SIZE);
+
+    for (size_t k = 0; k < POLY_BATCH_SIZE; k++) {
+      // calculate expected values (zero for unused polynomials)
+      poly_t exp2 = { 0 }, exp3 = { 0 };
+      if (k < n) {
+        poly_sample_cbd2(&exp2, SEED, bs[k]);
+        poly_sample_cbd3(&exp3, SEED, bs[k]);
+      }
+
+      if (memcmp(got2 + k, &exp2, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_batch_sample_cbd2(%zu, %zu) failed, got:\n", n, k);
+        poly_write(stderr, got2 + k);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp2);
+        fprintf(stderr, "\n");
+      }
+
+      if (memcmp(got3 + k, &exp3, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_batch_sample_cbd3(%zu, %zu) failed, got:\n", n, k);
+        poly_write(stderr, got3 + k);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp3);
+        fprintf(stderr, "\n");
+      }
+    }
+  }
+}
+
+// test polys_sample_cbd() against poly_sample_cbd{2,3}()
+static void test_polys_sample_cbd(void) {
+  static const uint8_t SEED[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+  };
+
+  static const struct {
+    size_t eta1, n1, n2;
+  } TESTS[] = {
+    { PKE512_ETA1, 2 * PKE512_K, 0 }, // pke512_keygen()
+    { PKE512_ETA1, PKE512_K, PKE512_K + 1 }, // pke512_encrypt()
+    { PKE768_ETA1, 2 * PKE768_K, 0 }, // pke768_keygen()
+    { PKE768_ETA1, PKE768_K, PKE768_K + 1 }, // pke768_encrypt()
+    { PKE1024_ETA1, 2 * PKE1024_K, 0 }, // pke1024_keygen()
+    { PKE1024_ETA1, PKE1024_K, PKE1024_K + 1 }, // pke1024_encrypt()
+    { 3, 1, 0 },
+    { 3, 0, 1 },
+  };
+
+  for (size_t i = 0; i < sizeof(TESTS)/sizeof(TESTS[0]); i++) {
+    const size_t eta1 = TESTS[i].eta1, n1 = TESTS[i].n1, n = n1 + TESTS[i].n2;
+    poly_t got[POLYS_SAMPLE_CBD_MAX] = { 0 };
+    polys_sample_cbd(got, SEED, eta1, n1, TESTS[i].n2);
+
+    for (size_t k = 0; k < n; k++) {
+      // calculate expected value
+      poly_t exp = { 0 };
+      if (k < n1 && eta1 == 3) {
+        poly_sample_cbd3(&exp, SEED, k);
+      } else {
+        poly_sample_cbd2(&exp, SEED, k);
+      }
+
+      if (memcmp(got + k, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_polys_sample_cbd(%zu, %zu) failed, got:\n", i, k);
+        poly_write(stderr, got + k);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+    }
+  }
+}
+
+// test poly_batch_compress() against poly_compress()
+static void test_poly_batch_compress(void) {
+  static const uint8_t DS[] = { 1, 4, 5, 10, 11 };
+
+  // build test polynomials (every coefficient from 0 to Q - 1)
+  poly_t ps[POLY_BATCH_SIZE] = { 0 };
+  for (size_t k = 0; k < POLY_BATCH_SIZE; k++) {
+    for (size_t i = 0; i < 256; i++) {
+      ps[k].cs[i] = (256 * k + i) % Q;
+    }
+  }
+
+  for (size_t i = 0; i < sizeof(DS); i++) {
+    poly_batch_t pb = { 0 };
+    poly_batch_load(&pb, ps, POLY_BATCH_SIZE);
+    poly_batch_compress(&pb, DS[i]);
+
+    for (size_t k = 0; k < POLY_BATCH_SIZE; k++) {
+      uint16_t exp[256] = { 0 };
+      poly_compress(exp, ps + k, DS[i]);
+
+      for (size_t j = 0; j < 256; j++) {
+        if (pb.cs[j][k] != exp[j]) {
+          fprintf(stderr, "test_poly_batch_compress(%u, %zu, %zu) failed: got %d, exp %u\n", DS[i], k, j, pb.cs[j][k], exp[j]);
+        }
+      }
+    }
+  }
+}
+
+// reverse low 7 bits of `n` (used by test_luts())
+static uint8_t test_bitrev7(const uint8_t n) {
+  uint8_t r = 0;
+  for (size_t i = 0; i < 7; i++) {
+    r |= ((n >> i) & 1) << (6 - i);
+  }
+  return r;
+}
+
+// compute 17^e mod Q in centered Montgomery form (used by test_luts())
+static int16_t test_mont_pow17(const uint16_t e) {
+  uint32_t z = 1;
+  for (size_t i = 0; i < e; i++) {
+    z = (z * 17) % Q;
+  }
+
+  const int32_t r = (int32_t) ((z << 16) % Q);
+  return (r > Q / 2) ? r - Q : r;
+}
+
+#if defined(FIPS203IPD_VEC) || defined(FIPS203IPD_AVX2) || defined(FIPS203IPD_AVX512)
+// check companion table `qs` (`r * QINV mod 2^16`) of Montgomery form
+// table `rs`
+static void test_luts_qinv(const char * const name, const int16_t * const rs, const int16_t * const qs, const size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    const int16_t exp = (int16_t) (rs[i] * QINV);
+    if (qs[i] != exp) {
+      fprintf(stderr, "test_luts(%s, %zu) failed: got %d, exp %d\n", name, i, qs[i], exp);
+    }
+  }
+}
+#endif /* FIPS203IPD_VEC || FIPS203IPD_AVX2 || FIPS203IPD_AVX512 */
+
+// check lookup tables against twiddle factors computed from first
+// principles, and check the QINV companion tables
+static void test_luts(void) {
+  for (size_t i = 0; i < 128; i++) {
+    const int16_t exp_ntt = test_mont_pow17(test_bitrev7(i));
+    if (NTT_LUT[i] != exp_ntt) {
+      fprintf(stderr, "test_luts(NTT_LUT, %zu) failed: got %d, exp %d\n", i, NTT_LUT[i], exp_ntt);
+    }
+
+    const int16_t exp_mul = test_mont_pow17(2 * test_bitrev7(i) + 1);
+    if (MUL_LUT[i] != exp_mul) {
+      fprintf(stderr, "test_luts(MUL_LUT, %zu) failed: got %d, exp %d\n", i, MUL_LUT[i], exp_mul);
+    }
+  }
+
+#if defined(FIPS203IPD_VEC) || defined(FIPS203IPD_AVX2) || defined(FIPS203IPD_AVX512)
+  test_luts_qinv("NTT_LUT_QINV", NTT_LUT, NTT_LUT_QINV, 128);
+#endif /* FIPS203IPD_VEC || FIPS203IPD_AVX2 || FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_VEC
+  test_luts_qinv("NTT_VEC_ZETAS_QINV", (const int16_t*) NTT_VEC_ZETAS, (const int16_t*) NTT_VEC_ZETAS_QINV, 2 * 2 * 16 * 8);
+#endif /* FIPS203IPD_VEC */
+#ifdef FIPS203IPD_AVX2
+  test_luts_qinv("NTT_AVX2_ZETAS_QINV", (const int16_t*) NTT_AVX2_ZETAS, (const int16_t*) NTT_AVX2_ZETAS_QINV, 2 * 3 * 8 * 16);
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_AVX512
+  test_luts_qinv("NTT_AVX512_ZETAS_QINV", (const int16_t*) NTT_AVX512_ZETAS, (const int16_t*) NTT_AVX512_ZETAS_QINV, 2 * 4 * 4 * 32);
+#endif /* FIPS203IPD_AVX512 */
+}
+
+// test poly_reduce() and poly_normalize() on every 16-bit input
+static void test_poly_reduce(void) {
+  for (int32_t x = INT16_MIN; x <= INT16_MAX; x += 256) {
+    // build test polynomial (256 consecutive values)
+    poly_t a = { 0 };
+    for (size_t i = 0; i < 256; i++) {
+      a.cs[i] = (int16_t) (x + (int32_t) i);
+    }
+
+    poly_t got_r = a, got_n = a;
+    poly_reduce(&got_r);
+    poly_normalize(&got_n);
+
+    for (size_t i = 0; i < 256; i++) {
+      // expected canonical value
+      const int32_t exp = ((x + (int32_t) i) % Q + Q) % Q;
+
+      // check poly_reduce(): congruent and centered
+      const int32_t r = got_r.cs[i];
+      if (r < -(Q - 1) / 2 || r > (Q - 1) / 2 || (r + Q) % Q != exp) {
+        fprintf(stderr, "test_poly_reduce(%d) failed: got %d, exp %d (mod Q)\n", (int) (x + (int32_t) i), (int) r, (int) exp);
+      }
+
+      // check poly_normalize(): canonical
+      if (got_n.cs[i] != exp) {
+        fprintf(stderr, "test_poly_normalize(%d) failed: got %d, exp %d\n", (int) (x + (int32_t) i), (int) got_n.cs[i], (int) exp);
+      }
+    }
+  }
+}
+
 static void test_prf(void) {
   static const struct {
     const char *name; // test name
@@ -2480,6 +8282,68 @@ static void test_prf(void) {
   }
 }
 
+// test prf_x4(), prf_x8(), and prfs() against prf()
+static void test_prfs(void) {
+  static const uint8_t SEED[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+  };
+
+  // prf bytes
+  uint8_t bs[16] = { 0 };
+  for (size_t k = 0; k < sizeof(bs); k++) {
+    bs[k] = 5 * k + 2;
+  }
+
+  // output lengths (shorter than, longer than, and exactly one block)
+  static const size_t LENS[] = { 16, 128, 136, PRF_MAX_LEN };
+
+  for (size_t li = 0; li < sizeof(LENS)/sizeof(LENS[0]); li++) {
+    const size_t len = LENS[li];
+
+    // calculate expected values
+    uint8_t exp[16 * PRF_MAX_LEN] = { 0 };
+    for (size_t k = 0; k < sizeof(bs); k++) {
+      prf(SEED, bs[k], exp + k * len, len);
+    }
+
+    for (size_t n = 0; n <= sizeof(bs); n++) {
+      static const struct {
+        const char *name; // function name
+        size_t max_n; // maximum number of outputs
+      } FNS[] = {
+        { "prf_x4", 4 },
+        { "prf_x8", 8 },
+        { "prfs", 16 },
+      };
+
+      for (size_t fi = 0; fi < sizeof(FNS)/sizeof(FNS[0]); fi++) {
+        if ((n == 0 && fi < 2) || n > FNS[fi].max_n) {
+          continue;
+        }
+
+        // fill output with canary to catch writes past `n * len`
+        uint8_t got[16 * PRF_MAX_LEN + 1] = { 0 };
+        memset(got, 0xa5, sizeof(got));
+        switch (fi) {
+        case 0: prf_x4(SEED, bs, n, got, len); break;
+        case 1: prf_x8(SEED, bs, n, got, len); break;
+        case 2: prfs(SEED, bs, n, got, len); break;
+        }
+
+        // check for expected value and untouched canary
+        if (memcmp(got, exp, n * len) || got[n * len] != 0xa5) {
+          fprintf(stderr, "test_prfs(\"%s\", %zu, %zu) failed, got:\n", FNS[fi].name, n, len);
+          hex_write(stderr, got, n * len + 1);
+          fprintf(stderr, "\nexp:\n");
+          hex_write(stderr, exp, n * len);
+          fprintf(stderr, "\n");
+        }
+      }
+    }
+  }
+}
+
 typedef struct {
   uint16_t val; // coefficient
   size_t sum;   // expected count
@@ -2525,6 +8389,66 @@ static void dist_check(const char * const name, const size_t num_polys, const di
   }
 }
 
+// test poly_cbd{2,3}() kernels against bit-by-bit sampling
+static void test_poly_cbd(void) {
+  // kernels (scalar, then any supported SIMD kernels)
+  static const struct {
+    const char *name; // kernel name
+    const isa_t isa; // required instruction set extension
+    void (*fn2)(poly_t *, const uint8_t *); // cbd2 kernel
+    void (*fn3)(poly_t *, const uint8_t *); // cbd3 kernel
+  } KERNELS[] = {
+    { "scalar", ISA_SCALAR, poly_cbd2_scalar, poly_cbd3_scalar },
+#ifdef FIPS203IPD_AVX2
+    { "avx2", ISA_AVX2, poly_cbd2_avx2, poly_cbd3_avx2 },
+#endif /* FIPS203IPD_AVX2 */
+  };
+
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 34; i++) {
+    // build prf output (first is all ones, the rest are random)
+    uint8_t buf[192] = { 0 };
+    if (i == 0) {
+      memset(buf, 0xff, sizeof(buf));
+    } else {
+      prf(SEED, i, buf, sizeof(buf));
+    }
+
+    for (size_t eta = 2; eta <= 3; eta++) {
+      // calculate expected coefficients one bit at a time
+      poly_t exp = { 0 };
+      for (size_t j = 0; j < 256; j++) {
+        int16_t x = 0, y = 0;
+        for (size_t k = 0; k < eta; k++) {
+          const size_t ofs = 2 * j * eta + k;
+          x += (buf[ofs / 8] >> (ofs % 8)) & 1;
+          y += (buf[(ofs + eta) / 8] >> ((ofs + eta) % 8)) & 1;
+        }
+        exp.cs[j] = x - y;
+      }
+
+      for (size_t j = 0; j < sizeof(KERNELS)/sizeof(KERNELS[0]); j++) {
+        if (cpu_isa() < KERNELS[j].isa) {
+          continue; // skip kernel: cpu does not support it
+        }
+
+        poly_t got = { 0 };
+        (eta == 2 ? KERNELS[j].fn2 : KERNELS[j].fn3)(&got, buf);
+
+        // check for expected value
+        if (memcmp(&got, &exp, sizeof(poly_t))) {
+          fprintf(stderr, "test_poly_cbd%zu(%s, %zu) failed, got:\n", eta, KERNELS[j].name, i);
+          poly_write(stderr, &got);
+          fprintf(stderr, "\nexp:\n");
+          poly_write(stderr, &exp);
+          fprintf(stderr, "\n");
+        }
+      }
+    }
+  }
+}
+
 static void test_poly_sample_cbd3(void) {
   static const struct {
     const uint8_t byte; // test byte
@@ -2553,6 +8477,7 @@ static void test_poly_sample_cbd3(void) {
     // sample coefficients
     poly_t got = { 0 };
     poly_sample_cbd3(&got, SEED, TESTS[i].byte);
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &TESTS[i].exp, sizeof(poly_t))) {
@@ -2578,6 +8503,7 @@ static void test_poly_sample_cbd3(void) {
     // sample coefficients
     poly_t got = { 0 };
     poly_sample_cbd3(&got, dist_seed.u8, 0);
+    poly_normalize(&got);
 
     // accumulate polynomial coefficient distribution
     dist_add_poly(sums, &sums_len, &got);
@@ -2626,6 +8552,7 @@ static void test_poly_sample_cbd2(void) {
     // sample coefficients
     poly_t got = { 0 };
     poly_sample_cbd2(&got, SEED, TESTS[i].byte);
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &TESTS[i].exp, sizeof(poly_t))) {
@@ -2651,6 +8578,7 @@ static void test_poly_sample_cbd2(void) {
     // sample coefficients
     poly_t got = { 0 };
     poly_sample_cbd2(&got, dist_seed.u8, 0);
+    poly_normalize(&got);
 
     // accumulate polynomial coefficient distribution
     dist_add_poly(sums, &sums_len, &got);
@@ -2750,22 +8678,301 @@ static void test_poly_encode(void) {
     },
   }};
 
-  for (size_t i = 0; i < sizeof(TESTS)/sizeof(TESTS[0]); i++) {
-    // encode polynomial
-    uint8_t buf[384] = { 0 };
-    poly_encode(buf, &(TESTS[i].val));
+  for (size_t i = 0; i < sizeof(TESTS)/sizeof(TESTS[0]); i++) {
+    // encode polynomial
+    uint8_t buf[384] = { 0 };
+    poly_encode(buf, &(TESTS[i].val));
+
+    // decode polynomial
+    poly_t got = { 0 };
+    poly_decode(&got, buf);
+
+    // check for expected value
+    if (memcmp(&got, &(TESTS[i].exp), sizeof(poly_t))) {
+      fprintf(stderr, "test_poly_encode(\"%s\") failed, got:\n", TESTS[i].name);
+      poly_write(stderr, &got);
+      fprintf(stderr, "\nexp:\n");
+      poly_write(stderr, &(TESTS[i].exp));
+      fprintf(stderr, "\n");
+    }
+  }
+}
+
+// test poly_{encode,decode}_{scalar,avx2,avx512}() against packing and
+// unpacking one integer at a time, including the range check
+static void test_poly_encode_kernels(void) {
+  // kernels (scalar, then any supported SIMD kernels)
+  static const struct {
+    const char *name; // kernel name
+    const isa_t isa; // required instruction set extension
+    void (*encode)(uint8_t [static 384], const poly_t *); // pack kernel
+    bool (*decode)(poly_t *, const uint8_t [static 384]); // unpack kernel
+  } KERNELS[] = {
+    { "scalar", ISA_SCALAR, poly_encode_scalar, poly_decode_scalar },
+#ifdef FIPS203IPD_AVX2
+    { "avx2", ISA_AVX2, poly_encode_avx2, poly_decode_avx2 },
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_AVX512
+    { "avx512", ISA_AVX512, poly_encode_avx512, poly_decode_avx512 },
+#endif /* FIPS203IPD_AVX512 */
+  };
+
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 16; i++) {
+    // build input: all 0xff, then random with a single out-of-range
+    // integer at position i - 2 (i > 1), then random with every integer
+    // in range (i > 9)
+    uint8_t buf[384] = { 0 };
+    if (i == 0) {
+      memset(buf, 0xff, sizeof(buf));
+    } else {
+      prf(SEED, i, buf, sizeof(buf));
+      for (size_t j = 0; j < sizeof(buf); j += 3) {
+        buf[j + 1] &= 0xf7; // both integers below 0x800
+        buf[j + 2] &= 0x7f;
+      }
+      if (i > 1 && i < 10) {
+        const size_t k = 31 * (i - 2) + 3; // integer to replace
+        const uint16_t d = Q + i - 2; // out-of-range value (Q to Q + 7)
+        const size_t ofs = 3 * (k / 2);
+        if (k & 1) {
+          buf[ofs + 1] = (buf[ofs + 1] & 0x0f) | ((d & 0xf) << 4);
+          buf[ofs + 2] = d >> 4;
+        } else {
+          buf[ofs] = d & 0xff;
+          buf[ofs + 1] = (buf[ofs + 1] & 0xf0) | (d >> 8);
+        }
+      }
+    }
+
+    // calculate expected coefficients and range check one integer at
+    // a time
+    poly_t exp = { 0 };
+    bool exp_ok = true;
+    for (size_t j = 0; j < 256; j++) {
+      const uint8_t * const ds = buf + 3 * (j / 2);
+      const uint16_t d = (j & 1) ? ((ds[1] >> 4) | (ds[2] << 4)) : (ds[0] | ((ds[1] & 0xf) << 8));
+      exp.cs[j] = d % Q;
+      exp_ok &= (d < Q);
+    }
+
+    for (size_t k = 0; k < sizeof(KERNELS)/sizeof(KERNELS[0]); k++) {
+      if (cpu_isa() < KERNELS[k].isa) {
+        continue; // skip kernel: cpu does not support it
+      }
+
+      // check unpacked coefficients and range check
+      poly_t got = { 0 };
+      const bool got_ok = KERNELS[k].decode(&got, buf);
+      if (got_ok != exp_ok || memcmp(&got, &exp, sizeof(poly_t))) {
+        fprintf(stderr, "test_poly_decode(%s, %zu) failed: got ok = %d, exp ok = %d, got:\n", KERNELS[k].name, i, got_ok, exp_ok);
+        poly_write(stderr, &got);
+        fprintf(stderr, "\nexp:\n");
+        poly_write(stderr, &exp);
+        fprintf(stderr, "\n");
+      }
+
+      // check that packing an in-range input round trips
+      if (exp_ok) {
+        uint8_t got_buf[384] = { 0 };
+        KERNELS[k].encode(got_buf, &exp);
+        if (memcmp(got_buf, buf, sizeof(buf))) {
+          fprintf(stderr, "test_poly_encode(%s, %zu) failed\n", KERNELS[k].name, i);
+        }
+      }
+    }
+  }
+}
+
+// test poly_inv_ntt_encode() for each instruction set extension
+// supported by this cpu against the inverse NTT, add, normalize, and
+// encode steps of the reference implementation
+static void test_poly_inv_ntt_encode(void) {
+  const isa_t prev = backend;
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 34; i++) {
+    // build inputs: all zeros, then alternating Q - 1 and -(Q - 1)
+    // with extreme noise, then uniformly random with ML-KEM noise
+    // (even i) or noise in the range [-(Q - 1) / 2, (Q - 1) / 2] (odd i)
+    poly_t u = { 0 }, e = { 0 };
+    if (i == 1) {
+      for (size_t j = 0; j < 256; j++) {
+        u.cs[j] = (j & 1) ? (Q - 1) : -(Q - 1);
+        e.cs[j] = (j & 2) ? 3 : -3;
+      }
+    } else if (i > 1) {
+      poly_sample_ntt(&u, SEED, i, 0);
+      poly_sample_ntt(&e, SEED, i, 1);
+      for (size_t j = 0; j < 256; j++) {
+        u.cs[j] -= (j & 1) ? (Q - 1) : 0;
+        e.cs[j] = (i & 1) ? (e.cs[j] - (Q - 1) / 2) : (e.cs[j] % 7 - 3);
+      }
+    }
+
+    for (uint8_t d = 10; d <= 11; d++) {
+      // calculate expected output with the reference implementation
+      uint8_t exp[352] = { 0 };
+      {
+        poly_t p = u;
+        poly_inv_ntt_scalar(&p);
+        poly_add_scalar(&p, &e);
+        poly_normalize(&p);
+        if (d == 11) {
+          poly_encode_11bit(exp, &p);
+        } else {
+          poly_encode_10bit(exp, &p);
+        }
+      }
+
+      for (isa_t isa = ISA_SCALAR; isa <= cpu_isa(); isa++) {
+        backend = isa;
+
+        // check output, and that exactly 32 * d bytes are written
+        uint8_t got[352 + 16] = { 0 };
+        memset(got + 32 * d, 0xa5, sizeof(got) - 32 * d);
+        poly_t p = u;
+        poly_inv_ntt_encode(got, &p, &e, d);
+        bool ok = !memcmp(got, exp, 32 * d);
+        for (size_t j = 32 * d; j < sizeof(got); j++) {
+          ok &= (got[j] == 0xa5);
+        }
+
+        if (!ok) {
+          fprintf(stderr, "test_poly_inv_ntt_encode(%d, %zu, %u) failed\n", isa, i, d);
+        }
+      }
+      backend = prev;
+    }
+  }
+}
+
+// test poly_decode_ntt() for each instruction set extension supported
+// by this cpu against the decode and NTT steps of the reference
+// implementation
+static void test_poly_decode_ntt(void) {
+  const isa_t prev = backend;
+  const uint8_t SEED[32] = { 0 };
+
+  for (size_t i = 0; i < 18; i++) {
+    // build input: all zeros, all ones, then random
+    uint8_t buf[352] = { 0 };
+    if (i == 1) {
+      memset(buf, 0xff, sizeof(buf));
+    } else if (i > 1) {
+      prf(SEED, i, buf, sizeof(buf));
+    }
+
+    for (uint8_t d = 10; d <= 11; d++) {
+      // calculate expected output with the reference implementation
+      poly_t exp = { 0 };
+      if (d == 11) {
+        poly_decode_11bit(&exp, buf);
+      } else {
+        poly_decode_10bit(&exp, buf);
+      }
+      poly_ntt_scalar(&exp);
+      poly_normalize(&exp);
+
+      for (isa_t isa = ISA_SCALAR; isa <= cpu_isa(); isa++) {
+        backend = isa;
+
+        // decode from a heap buffer of exactly 32 * d bytes, so that
+        // the address sanitizer catches reads past the end
+        uint8_t * const src = malloc(32 * d);
+        if (!src) {
+          fprintf(stderr, "test_poly_decode_ntt(): malloc() failed\n");
+          exit(-1);
+        }
+        memcpy(src, buf, 32 * d);
+        poly_t got = { 0 };
+        poly_decode_ntt(&got, src, d);
+        free(src);
+        poly_normalize(&got);
+
+        if (memcmp(&got, &exp, sizeof(poly_t))) {
+          fprintf(stderr, "test_poly_decode_ntt(%d, %zu, %u) failed, got:\n", isa, i, d);
+          poly_write(stderr, &got);
+          fprintf(stderr, "\nexp:\n");
+          poly_write(stderr, &exp);
+          fprintf(stderr, "\n");
+        }
+      }
+      backend = prev;
+    }
+  }
+}
+
+// test poly_{encode,decode}_{11,10,5,4}bit() for each instruction set
+// extension supported by this cpu against the reference implementation
+static void test_poly_encode_bits(void) {
+  const isa_t prev = backend;
+  static const struct {
+    const uint8_t d; // number of bits in compressed values
+    void (*encode)(uint8_t *, const poly_t *); // pack function
+    void (*decode)(poly_t *, const uint8_t *); // unpack function
+  } FNS[] = {
+    { 11, poly_encode_11bit, poly_decode_11bit },
+    { 10, poly_encode_10bit, poly_decode_10bit },
+    { 5, poly_encode_5bit, poly_decode_5bit },
+    { 4, poly_encode_4bit, poly_decode_4bit },
+  };
+
+  const uint8_t SEED[32] = { 0 };
 
-    // decode polynomial
-    poly_t got = { 0 };
-    poly_decode(&got, buf);
+  for (size_t i = 0; i < 18; i++) {
+    // build inputs: all zeros, then all Q - 1 and all 0xff, then
+    // uniformly random
+    poly_t p = { 0 };
+    uint8_t buf[352] = { 0 };
+    if (i == 1) {
+      for (size_t j = 0; j < 256; j++) {
+        p.cs[j] = Q - 1;
+      }
+      memset(buf, 0xff, sizeof(buf));
+    } else if (i > 1) {
+      poly_sample_ntt(&p, SEED, i, 0);
+      prf(SEED, i, buf, sizeof(buf));
+    }
 
-    // check for expected value
-    if (memcmp(&got, &(TESTS[i].exp), sizeof(poly_t))) {
-      fprintf(stderr, "test_poly_encode(\"%s\") failed, got:\n", TESTS[i].name);
-      poly_write(stderr, &got);
-      fprintf(stderr, "\nexp:\n");
-      poly_write(stderr, &(TESTS[i].exp));
-      fprintf(stderr, "\n");
+    for (size_t k = 0; k < sizeof(FNS) / sizeof(FNS[0]); k++) {
+      const size_t len = 32 * FNS[k].d; // packed size, in bytes
+
+      // calculate expected output with the reference implementation
+      uint8_t exp_buf[352] = { 0 };
+      poly_t exp = { 0 };
+      backend = ISA_SCALAR;
+      FNS[k].encode(exp_buf, &p);
+      FNS[k].decode(&exp, buf);
+
+      for (isa_t isa = ISA_VEC; isa <= cpu_isa(); isa++) {
+        backend = isa;
+
+        // check packed output, and that exactly `len` bytes are written
+        uint8_t got_buf[352 + 64] = { 0 };
+        memset(got_buf + len, 0xa5, sizeof(got_buf) - len);
+        FNS[k].encode(got_buf, &p);
+        bool ok = !memcmp(got_buf, exp_buf, len);
+        for (size_t j = len; j < sizeof(got_buf); j++) {
+          ok &= (got_buf[j] == 0xa5);
+        }
+        if (!ok) {
+          fprintf(stderr, "test_poly_encode_bits(%d, %zu, %u) failed\n", isa, i, FNS[k].d);
+        }
+
+        // check unpacked and decompressed coefficients
+        poly_t got = { 0 };
+        FNS[k].decode(&got, buf);
+        if (memcmp(&got, &exp, sizeof(poly_t))) {
+          fprintf(stderr, "test_poly_decode_bits(%d, %zu, %u) failed, got:\n", isa, i, FNS[k].d);
+          poly_write(stderr, &got);
+          fprintf(stderr, "\nexp:\n");
+          poly_write(stderr, &exp);
+          fprintf(stderr, "\n");
+        }
+      }
+      backend = prev;
     }
   }
 }
@@ -2927,6 +9134,25 @@ static void test_poly_encode_1bit(void) {
       fprintf(stderr, "\n");
     }
   }
+
+  // check range check against ct_compress() for every coefficient in
+  // [0, Q), in every bit position
+  for (uint16_t x = 0; x < Q; x++) {
+    poly_t p = { 0 };
+    for (size_t j = 0; j < 256; j++) {
+      p.cs[j] = (x + j) % Q;
+    }
+
+    uint8_t got[32] = { 0 }, exp[32] = { 0 };
+    poly_encode_1bit(got, &p);
+    for (size_t j = 0; j < 256; j++) {
+      exp[j / 8] |= ct_compress(p.cs[j], 1) << (j % 8);
+    }
+
+    if (memcmp(got, exp, sizeof(got))) {
+      fprintf(stderr, "test_poly_encode_1bit(%u) failed\n", x);
+    }
+  }
 }
 
 static void test_poly_decode_11bit(void) {
@@ -3201,10 +9427,19 @@ static void test_poly_decode_1bit(void) {
 
 // define test functions for NxN matrices and N-dim vectors.
 #define DEFINE_MAT_VEC_TEST_FUNCS(N) \
-  /* apply NTT to NxN matrix */ \
+  /* apply NTT to NxN matrix and convert it to Montgomery form, like */ \
+  /* mat_sample_ntt() */ \
   static void mat ## N ## _ntt(poly_t mat[static N*N]) { \
     for (size_t i = 0; i < N*N; i++) { \
       poly_ntt(mat + i); \
+      poly_tomont(mat + i); \
+    } \
+  } \
+  \
+  /* convert N-dim vector to Montgomery form */ \
+  static void vec ## N ## _tomont(poly_t vec[static N]) { \
+    for (size_t i = 0; i < N; i++) { \
+      poly_tomont(vec + i); \
     } \
   } \
   \
@@ -3226,6 +9461,46 @@ DEFINE_MAT_VEC_TEST_FUNCS(3)
 // define mat4 and vec4 test functions (used by pke1024)
 DEFINE_MAT_VEC_TEST_FUNCS(4)
 
+// check ct_compress() against the division-based formula
+// `round((2^d / Q) * x) mod 2^d` for every 12-bit `x` in every
+// compressed width used by this implementation
+static void test_ct_compress(void) {
+  static const uint8_t DS[] = { 1, 4, 5, 10, 11 };
+
+  for (size_t i = 0; i < sizeof(DS)/sizeof(DS[0]); i++) {
+    const uint8_t d = DS[i];
+    for (uint32_t x = 0; x < 4096; x++) {
+      const uint16_t exp = (((x << (d + 1)) + Q) / Q >> 1) & ((1U << d) - 1);
+      const uint16_t got = ct_compress(x, d);
+
+      // check for expected value
+      if (got != exp) {
+        fprintf(stderr, "test_ct_compress(d = %u, x = %u) failed: got %u, exp %u\n", d, x, got, exp);
+      }
+    }
+  }
+}
+
+// check ct_decompress() against round((Q / 2^d) * x) for every `x` in
+// every compressed width used by this implementation
+static void test_ct_decompress(void) {
+  static const uint8_t DS[] = { 1, 4, 5, 10, 11 };
+
+  for (size_t i = 0; i < sizeof(DS)/sizeof(DS[0]); i++) {
+    const uint8_t d = DS[i];
+    for (uint32_t x = 0; x < (1U << d); x++) {
+      // expected value: round(Q * x / 2^d), rounding ties up
+      const uint16_t exp = (2 * Q * x + (1U << d)) / (1U << (d + 1));
+      const uint16_t got = ct_decompress(x, d);
+
+      // check for expected value
+      if (got != exp) {
+        fprintf(stderr, "test_ct_decompress(d = %u, x = %u) failed: got %u, exp %u\n", d, x, got, exp);
+      }
+    }
+  }
+}
+
 static void test_mat2_mul(void) {
   static const struct {
     const char *name; // test name
@@ -3263,9 +9538,14 @@ static void test_mat2_mul(void) {
     memcpy(vec, TESTS[i].vec, sizeof(vec));
     vec2_ntt(vec);
 
+    // compute mulcache of vector
+    poly_mulcache_t vec_mc[2] = { 0 };
+    vec2_mulcache(vec_mc, vec);
+
     poly_t got[2] = { 0 };
-    mat2_mul(got, mat, vec); // got = mat * vec
+    mat2_mul(got, mat, vec, vec_mc); // got = mat * vec
     vec2_inv_ntt(got); // got = InvNTT(got)
+    vec2_normalize(got);
 
     // check for expected value
     if (memcmp(got, TESTS[i].exp, sizeof(got))) {
@@ -3343,13 +9623,15 @@ static void test_vec2_dot(void) {
 
     memcpy(a, TESTS[i].a, sizeof(a));
     vec2_ntt(a); // a = NTT(a)
+    vec2_tomont(a); // a = Montgomery form of a
 
     memcpy(b, TESTS[i].b, sizeof(b));
     vec2_ntt(b); // b = NTT(b)
 
     poly_t got = { 0 };
-    vec2_dot(&got, a, b); // got = a * b
+    vec2_dot(&got, a, b, NULL); // got = a * b
     poly_inv_ntt(&got); // got = InvNTT(got)
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &(TESTS[i].exp), sizeof(got))) {
@@ -3385,6 +9667,7 @@ static void test_vec2_ntt(void) {
     memcpy(got, TESTS[i].exp, sizeof(got));
     vec2_ntt(got); // got = NTT(exp)
     vec2_inv_ntt(got); // got = InvNTT(got)
+    vec2_normalize(got);
 
     // check for expected value
     if (memcmp(&got, &(TESTS[i].exp), sizeof(got))) {
@@ -5507,9 +11790,14 @@ static void test_mat3_mul(void) {
     memcpy(vec, TESTS[i].vec, sizeof(vec));
     vec3_ntt(vec);
 
+    // compute mulcache of vector
+    poly_mulcache_t vec_mc[3] = { 0 };
+    vec3_mulcache(vec_mc, vec);
+
     poly_t got[3] = { 0 };
-    mat3_mul(got, mat, vec); // got = mat * vec
+    mat3_mul(got, mat, vec, vec_mc); // got = mat * vec
     vec3_inv_ntt(got); // got = InvNTT(got)
+    vec3_normalize(got);
 
     // check for expected value
     if (memcmp(got, TESTS[i].exp, sizeof(got))) {
@@ -5592,13 +11880,15 @@ static void test_vec3_dot(void) {
 
     memcpy(a, TESTS[i].a, sizeof(a));
     vec3_ntt(a); // a = NTT(a)
+    vec3_tomont(a); // a = Montgomery form of a
 
     memcpy(b, TESTS[i].b, sizeof(b));
     vec3_ntt(b); // b = NTT(b)
 
     poly_t got = { 0 };
-    vec3_dot(&got, a, b); // got = a * b
+    vec3_dot(&got, a, b, NULL); // got = a * b
     poly_inv_ntt(&got); // got = InvNTT(got)
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &(TESTS[i].exp), sizeof(got))) {
@@ -5636,6 +11926,7 @@ static void test_vec3_ntt(void) {
     memcpy(got, TESTS[i].exp, sizeof(got));
     vec3_ntt(got); // got = NTT(exp)
     vec3_inv_ntt(got); // got = InvNTT(got)
+    vec3_normalize(got);
 
     // check for expected value
     if (memcmp(&got, &(TESTS[i].exp), sizeof(got))) {
@@ -8563,9 +14854,14 @@ static void test_mat4_mul(void) {
     memcpy(vec, TESTS[i].vec, sizeof(vec));
     vec4_ntt(vec);
 
+    // compute mulcache of vector
+    poly_mulcache_t vec_mc[4] = { 0 };
+    vec4_mulcache(vec_mc, vec);
+
     poly_t got[4] = { 0 };
-    mat4_mul(got, mat, vec); // got = mat * vec
+    mat4_mul(got, mat, vec, vec_mc); // got = mat * vec
     vec4_inv_ntt(got); // got = InvNTT(got)
+    vec4_normalize(got);
 
     // check for expected value
     if (memcmp(got, TESTS[i].exp, sizeof(got))) {
@@ -8653,13 +14949,15 @@ static void test_vec4_dot(void) {
 
     memcpy(a, TESTS[i].a, sizeof(a));
     vec4_ntt(a); // a = NTT(a)
+    vec4_tomont(a); // a = Montgomery form of a
 
     memcpy(b, TESTS[i].b, sizeof(b));
     vec4_ntt(b); // b = NTT(b)
 
     poly_t got = { 0 };
-    vec4_dot(&got, a, b); // got = a * b
+    vec4_dot(&got, a, b, NULL); // got = a * b
     poly_inv_ntt(&got); // got = InvNTT(got)
+    poly_normalize(&got);
 
     // check for expected value
     if (memcmp(&got, &(TESTS[i].exp), sizeof(got))) {
@@ -8699,6 +14997,7 @@ static void test_vec4_ntt(void) {
     memcpy(got, TESTS[i].exp, sizeof(got));
     vec4_ntt(got); // got = NTT(exp)
     vec4_inv_ntt(got); // got = InvNTT(got)
+    vec4_normalize(got);
 
     // check for expected value
     if (memcmp(&got, &(TESTS[i].exp), sizeof(got))) {
@@ -12454,60 +18753,791 @@ static void test_fips203ipd_kem1024_roundtrip(void) {
   }
 }
 
+// test fips203ipd_kem{512,768,1024}_ek_check() with generated keys,
+// with a single out-of-range coefficient in the first and last
+// polynomials of `t`, and with corrupted `rho` (not checked)
+static void test_fips203ipd_ek_check(void) {
+  static const struct {
+    const char *name; // parameter set
+    const size_t k; // number of polynomials in t
+    void (*keygen)(uint8_t *, uint8_t *, const uint8_t *); // keygen function
+    bool (*ek_check)(const uint8_t *); // ek check function
+  } TESTS[] = {
+    { "kem512", PKE512_K, fips203ipd_kem512_keygen, fips203ipd_kem512_ek_check },
+    { "kem768", PKE768_K, fips203ipd_kem768_keygen, fips203ipd_kem768_ek_check },
+    { "kem1024", PKE1024_K, fips203ipd_kem1024_keygen, fips203ipd_kem1024_ek_check },
+  };
+
+  // bytes to corrupt, and expected results
+  static const struct {
+    const size_t ofs; // offset from start of ek, or from last byte of t
+    const bool tail; // offset is from last byte of t
+    const uint8_t mask; // bits to set
+    const bool exp; // expected result
+  } MODS[] = {
+    { 0, false, 0x00, true }, // unmodified
+    { 1, false, 0x0f, false }, // coefficient 0 of first polynomial >= 3840
+    { 0, true, 0xff, false }, // last coefficient of last polynomial >= 4080
+    { 32, true, 0xff, true }, // last byte of rho
+  };
+
+  const uint8_t seed[64] = { 1 };
+  for (size_t i = 0; i < sizeof(TESTS)/sizeof(TESTS[0]); i++) {
+    uint8_t ek[FIPS203IPD_KEM1024_EK_SIZE] = { 0 },
+            dk[FIPS203IPD_KEM1024_DK_SIZE] = { 0 };
+    TESTS[i].keygen(ek, dk, seed);
+
+    for (size_t j = 0; j < sizeof(MODS)/sizeof(MODS[0]); j++) {
+      uint8_t buf[FIPS203IPD_KEM1024_EK_SIZE] = { 0 };
+      memcpy(buf, ek, sizeof(buf));
+      buf[MODS[j].ofs + (MODS[j].tail ? (384 * TESTS[i].k - 1) : 0)] |= MODS[j].mask;
+
+      const bool got = TESTS[i].ek_check(buf);
+      if (got != MODS[j].exp) {
+        fprintf(stderr, "test_fips203ipd_ek_check(\"%s\", %zu) failed: got %d, exp %d\n", TESTS[i].name, j, got, MODS[j].exp);
+      }
+    }
+  }
+}
+
+// test backend selection: every backend supported by this cpu and
+// compiled in can be set, together with the matching keccak permutation
+// backend, and the others are rejected
+static void test_backend(void) {
+  const isa_t prev = backend;
+
+  for (isa_t isa = ISA_SCALAR; isa <= ISA_AVX512VBMI2; isa++) {
+    const bool exp = (isa <= cpu_isa()) && backend_compiled(isa);
+    const bool got = fips203ipd_backend_set((fips203ipd_backend_t) isa);
+    if (got != exp) {
+      fprintf(stderr, "test_backend(\"%s\") failed: got %d, exp %d\n", fips203ipd_backend_name((fips203ipd_backend_t) isa), got, exp);
+    } else if (got && (fips203ipd_backend() != (fips203ipd_backend_t) isa || poly_isa() != isa)) {
+      fprintf(stderr, "test_backend(\"%s\") failed: backend not set\n", fips203ipd_backend_name((fips203ipd_backend_t) isa));
+    } else if (got && sha3_backend() > ((isa >= ISA_AVX512) ? SHA3_BACKEND_AVX512 : ((isa >= ISA_AVX2) ? SHA3_BACKEND_AVX2 : SHA3_BACKEND_SCALAR))) {
+      fprintf(stderr, "test_backend(\"%s\") failed: keccak backend %d\n", fips203ipd_backend_name((fips203ipd_backend_t) isa), (int) sha3_backend());
+    }
+  }
+
+  // check that backends which were left out at build time are rejected
+  static const struct {
+    const isa_t isa; // backend
+    const bool compiled; // compiled in?
+  } LEFT_OUT[] = {
+#ifdef FIPS203IPD_VEC
+    { ISA_VEC, true },
+#else
+    { ISA_VEC, false },
+#endif /* FIPS203IPD_VEC */
+#ifdef FIPS203IPD_AVX2
+    { ISA_AVX2, true },
+#else
+    { ISA_AVX2, false },
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_AVX512
+    { ISA_AVX512, true },
+#else
+    { ISA_AVX512, false },
+#endif /* FIPS203IPD_AVX512 */
+#ifdef FIPS203IPD_AVX512VBMI
+    { ISA_AVX512VBMI, true },
+#else
+    { ISA_AVX512VBMI, false },
+#endif /* FIPS203IPD_AVX512VBMI */
+#ifdef FIPS203IPD_AVX512VBMI2
+    { ISA_AVX512VBMI2, true },
+#else
+    { ISA_AVX512VBMI2, false },
+#endif /* FIPS203IPD_AVX512VBMI2 */
+  };
+  for (size_t i = 0; i < sizeof(LEFT_OUT) / sizeof(LEFT_OUT[0]); i++) {
+    if (!LEFT_OUT[i].compiled && fips203ipd_backend_set((fips203ipd_backend_t) LEFT_OUT[i].isa)) {
+      fprintf(stderr, "test_backend(\"%s\") failed: compiled-out backend set\n", fips203ipd_backend_name((fips203ipd_backend_t) LEFT_OUT[i].isa));
+    }
+  }
+
+  // check names
+  if (strcmp(fips203ipd_backend_name(FIPS203IPD_BACKEND_SCALAR), "scalar") || fips203ipd_backend_name(FIPS203IPD_BACKEND_AVX512VBMI2 + 1)) {
+    fprintf(stderr, "test_backend() failed: bad backend names\n");
+  }
+
+  fips203ipd_backend_set((fips203ipd_backend_t) prev);
+}
+
 int main(void) {
-  test_poly_ntt_roundtrip();
-  test_poly_sample_ntt();
-  test_poly_add();
-  test_poly_sub();
-  test_poly_mul();
-  test_prf();
-  test_poly_sample_cbd3();
-  test_poly_sample_cbd2();
-  test_poly_encode();
-  test_poly_encode_11bit();
-  test_poly_encode_10bit();
-  test_poly_encode_5bit();
-  test_poly_encode_4bit();
-  test_poly_encode_1bit();
-  test_poly_decode_11bit();
-  test_poly_decode_10bit();
-  test_poly_decode_5bit();
-  test_poly_decode_4bit();
-  test_poly_decode_1bit();
-  test_mat2_mul();
-  test_vec2_add();
-  test_vec2_dot();
-  test_vec2_ntt();
-  test_pke512_keygen();
-  test_pke512_encrypt();
-  test_pke512_decrypt();
-  test_fips203ipd_kem512_keygen();
-  test_fips203ipd_kem512_encaps();
-  test_fips203ipd_kem512_decaps();
-  test_fips203ipd_kem512_roundtrip();
-  test_mat3_mul();
-  test_vec3_add();
-  test_vec3_dot();
-  test_vec3_ntt();
-  test_pke768_keygen();
-  test_pke768_encrypt();
-  test_pke768_decrypt();
-  test_fips203ipd_kem768_keygen();
-  test_fips203ipd_kem768_encaps();
-  test_fips203ipd_kem768_decaps();
-  test_fips203ipd_kem768_roundtrip();
-  test_mat4_mul();
-  test_vec4_add();
-  test_vec4_dot();
-  test_vec4_ntt();
-  test_pke1024_keygen();
-  test_pke1024_encrypt();
-  test_pke1024_decrypt();
-  test_fips203ipd_kem1024_keygen();
-  test_fips203ipd_kem1024_encaps();
-  test_fips203ipd_kem1024_decaps();
-  test_fips203ipd_kem1024_roundtrip();
+  test_luts();
+  test_backend();
+
+  // run the remaining tests once for each backend supported by this
+  // cpu (skipping backends which were left out at build time)
+  for (isa_t isa = ISA_SCALAR; isa <= cpu_isa(); isa++) {
+    if (!fips203ipd_backend_set((fips203ipd_backend_t) isa)) {
+      continue;
+    }
+    test_poly_ntt_roundtrip();
+#ifdef FIPS203IPD_VEC
+    test_poly_vec();
+#endif /* FIPS203IPD_VEC */
+#ifdef FIPS203IPD_AVX2
+    test_poly_ntt_avx2();
+#endif /* FIPS203IPD_AVX2 */
+#ifdef FIPS203IPD_AVX512
+    test_poly_avx512();
+#endif /* FIPS203IPD_AVX512 */
+    test_poly_sample_ntt_parse();
+    test_poly_sample_ntt();
+    test_poly_sample_ntt_x4();
+    test_poly_sample_ntt_x8();
+    test_mat_sample_ntt();
+    test_mat_mul_sample_ntt();
+    test_poly_add();
+    test_poly_sub();
+    test_poly_mul();
+    test_poly_basemul_acc();
+    test_poly_reduce();
+    test_poly_batch_ntt();
+    test_poly_batch_basemul_acc();
+    test_poly_batch_sample_cbd();
+    test_polys_sample_cbd();
+    test_poly_batch_compress();
+    test_prf();
+    test_prfs();
+    test_poly_cbd();
+    test_poly_sample_cbd3();
+    test_poly_sample_cbd2();
+    test_poly_encode();
+    test_poly_encode_kernels();
+    test_poly_inv_ntt_encode();
+    test_poly_decode_ntt();
+    test_poly_encode_bits();
+    test_poly_encode_11bit();
+    test_poly_encode_10bit();
+    test_poly_encode_5bit();
+    test_poly_encode_4bit();
+    test_poly_encode_1bit();
+    test_poly_decode_11bit();
+    test_poly_decode_10bit();
+    test_poly_decode_5bit();
+    test_poly_decode_4bit();
+    test_poly_decode_1bit();
+    test_ct_compress();
+    test_ct_decompress();
+    test_mat2_mul();
+    test_vec2_add();
+    test_vec2_dot();
+    test_vec2_ntt();
+    test_pke512_keygen();
+    test_pke512_encrypt();
+    test_pke512_decrypt();
+    test_fips203ipd_kem512_keygen();
+    test_fips203ipd_kem512_encaps();
+    test_fips203ipd_kem512_decaps();
+    test_fips203ipd_kem512_roundtrip();
+    test_mat3_mul();
+    test_vec3_add();
+    test_vec3_dot();
+    test_vec3_ntt();
+    test_pke768_keygen();
+    test_pke768_encrypt();
+    test_pke768_decrypt();
+    test_fips203ipd_kem768_keygen();
+    test_fips203ipd_kem768_encaps();
+    test_fips203ipd_kem768_decaps();
+    test_fips203ipd_kem768_roundtrip();
+    test_mat4_mul();
+    test_vec4_add();
+    test_vec4_dot();
+    test_vec4_ntt();
+    test_pke1024_keygen();
+    test_pke1024_encrypt();
+    test_pke1024_decrypt();
+    test_fips203ipd_kem1024_keygen();
+    test_fips203ipd_kem1024_encaps();
+    test_fips203ipd_kem1024_decaps();
+    test_fips203ipd_kem1024_roundtrip();
+    test_fips203ipd_ek_check();
+  }
 }
 #endif // TEST_FIPS203IPD
 
+#ifdef BENCH_FIPS203IPD
+#include <stdio.h> // printf()
+#include <time.h> // timespec_get()
+#include "rand-bytes.h" // rand_bytes()
+#ifdef __x86_64__
+#include <x86intrin.h> // __rdtsc()
+#endif /* __x86_64__ */
+
+// default number of iterations for each benchmark
+#define BENCH_NUM_ITERATIONS 2000
+
+// number of iterations for large (MB-scale) benchmarks
+#define BENCH_NUM_BIG_ITERATIONS 20
+
+// size of large benchmark buffer, in bytes
+#define BENCH_BIG_SIZE (1 << 20)
+
+// size of each output buffer in multi-buffer xof benchmarks, in bytes
+#define BENCH_MULTI_SIZE 4096
+
+// size of stack region painted by stack usage benchmarks, in bytes
+#define BENCH_STACK_SIZE (64 * 1024)
+
+// fill pattern for stack usage benchmarks
+#define BENCH_STACK_FILL 0xa5
+
+// maximum number of polynomials in batch benchmarks
+#define BENCH_BATCH_MAX 64
+
+// Benchmark input and output buffers (shared by all benchmarks).
+static struct {
+  uint8_t keygen_seed[64], // random seed for keygen()
+          encaps_seed[32], // random seed for encaps()
+          key[32], // shared key
+          buf[384], // serialized polynomial
+          big[BENCH_BIG_SIZE]; // large buffer (sha3 benchmarks)
+  poly_t poly, // polynomial
+         mat[16], // matrix (up to 4x4)
+         vec[8]; // input and output vectors (up to 4 each)
+
+  size_t batch_n; // number of polynomials in batch benchmarks
+  poly_t polys[3][BENCH_BATCH_MAX]; // batch benchmark polynomials (a, b, c)
+  poly_batch_t batches[3][BENCH_BATCH_MAX / POLY_BATCH_SIZE]; // transposed (a, b, c)
+  uint16_t ys[BENCH_BATCH_MAX][256]; // compressed values
+
+  uint8_t ek512[FIPS203IPD_KEM512_EK_SIZE], // KEM512 encapsulation key
+          dk512[FIPS203IPD_KEM512_DK_SIZE], // KEM512 decapsulation key
+          ct512[FIPS203IPD_KEM512_CT_SIZE]; // KEM512 ciphertext
+
+  uint8_t ek768[FIPS203IPD_KEM768_EK_SIZE], // KEM768 encapsulation key
+          dk768[FIPS203IPD_KEM768_DK_SIZE], // KEM768 decapsulation key
+          ct768[FIPS203IPD_KEM768_CT_SIZE]; // KEM768 ciphertext
+
+  uint8_t ek1024[FIPS203IPD_KEM1024_EK_SIZE], // KEM1024 encapsulation key
+          dk1024[FIPS203IPD_KEM1024_DK_SIZE], // KEM1024 decapsulation key
+          ct1024[FIPS203IPD_KEM1024_CT_SIZE]; // KEM1024 ciphertext
+} ctx;
+
+// Get current time, in nanoseconds.
+static uint64_t bench_ns(void) {
+  struct timespec ts = { 0 };
+  timespec_get(&ts, TIME_UTC);
+  return ((uint64_t) ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// Get current cycle count, or 0 if cycle counter is not available.
+static uint64_t bench_cycles(void) {
+#ifdef __x86_64__
+  return __rdtsc();
+#else
+  return 0;
+#endif /* __x86_64__ */
+}
+
+// Call `fn` `num_iters` times and print the mean time and cycle count
+// per call.  If `len` is non-zero, then also print cycles per byte.
+static void bench_run(const char * const name, void (*fn)(void), const size_t num_iters, const size_t len) {
+  fn(); // warm up
+
+  const uint64_t t0 = bench_ns(), c0 = bench_cycles();
+  for (size_t i = 0; i < num_iters; i++) {
+    fn();
+  }
+  const uint64_t c1 = bench_cycles(), t1 = bench_ns();
+
+  const double ns = (double) (t1 - t0) / num_iters,
+               cycles = (double) (c1 - c0) / num_iters;
+  printf("%-24s %12.1f ns/op %12.1f cycles/op", name, ns, cycles);
+  if (len) {
+    printf(" %8.2f cycles/byte", cycles / len);
+  }
+  fputs("\n", stdout);
+}
+
+// Paint `BENCH_STACK_SIZE` bytes of stack below the caller with a
+// fill pattern if `paint` is true, or return the number of bytes below
+// the caller which no longer contain the pattern if `paint` is false.
+// Called twice from the same frame by `bench_stack()`, so both calls
+// cover the same addresses.
+static __attribute__((noinline)) size_t bench_stack_scan(const bool paint) {
+  uint8_t stack[BENCH_STACK_SIZE];
+  volatile uint8_t * const buf = stack; // keep reads and writes
+  if (paint) {
+    for (size_t i = 0; i < BENCH_STACK_SIZE; i++) {
+      buf[i] = BENCH_STACK_FILL;
+    }
+    return 0;
+  }
+
+  // stack grows down, so the deepest byte is buf[0]
+  size_t i = 0;
+  while (i < BENCH_STACK_SIZE && buf[i] == BENCH_STACK_FILL) {
+    i++;
+  }
+  return BENCH_STACK_SIZE - i;
+}
+
+// Call `fn` once and print its peak stack usage, in bytes, measured by
+// painting the stack before the call and scanning it afterwards.
+static void bench_stack(const char * const name, void (*fn)(void)) {
+  bench_stack_scan(true);
+  fn();
+  printf("%-24s %12zu bytes stack\n", name, bench_stack_scan(false));
+}
+
+// shake256 with 33-byte input and 128-byte output (e.g., prf())
+static void bench_shake256_prf(void) {
+  shake256_xof_once(ctx.buf, 33, ctx.buf + 64, 128);
+}
+
+// absorb 1 MB into shake128, squeeze 32 bytes
+static void bench_shake128_absorb_big(void) {
+  sha3_xof_t xof = { 0 };
+  shake128_xof_init(&xof);
+  (void) shake128_xof_absorb(&xof, ctx.big, sizeof(ctx.big));
+  shake128_xof_squeeze(&xof, ctx.key, sizeof(ctx.key));
+}
+
+// absorb 32 bytes into shake128, squeeze 1 MB
+static void bench_shake128_squeeze_big(void) {
+  sha3_xof_t xof = { 0 };
+  shake128_xof_init(&xof);
+  (void) shake128_xof_absorb(&xof, ctx.key, sizeof(ctx.key));
+  shake128_xof_squeeze(&xof, ctx.big, sizeof(ctx.big));
+}
+
+// squeeze 4 kB from each of 8 single-state shake128 xofs
+static void bench_shake128_squeeze_8x4kb(void) {
+  for (size_t i = 0; i < 8; i++) {
+    sha3_xof_t xof = { 0 };
+    shake128_xof_init(&xof);
+    (void) shake128_xof_absorb(&xof, ctx.keygen_seed + i, 34);
+    shake128_xof_squeeze(&xof, ctx.big + BENCH_MULTI_SIZE * i, BENCH_MULTI_SIZE);
+  }
+}
+
+// squeeze 4 kB from each of 8 shake128 xofs, 4 at a time
+static void bench_shake128x4_squeeze_8x4kb(void) {
+  for (size_t i = 0; i < 8; i += 4) {
+    const uint8_t * const ms[4] = { ctx.keygen_seed + i, ctx.keygen_seed + i + 1, ctx.keygen_seed + i + 2, ctx.keygen_seed + i + 3 };
+    uint8_t * const dsts[4] = { ctx.big + BENCH_MULTI_SIZE * i, ctx.big + BENCH_MULTI_SIZE * (i + 1), ctx.big + BENCH_MULTI_SIZE * (i + 2), ctx.big + BENCH_MULTI_SIZE * (i + 3) };
+    sha3_xof_x4_t xof = { 0 };
+    shake128x4_xof_init(&xof);
+    (void) shake128x4_xof_absorb(&xof, ms, 34);
+    shake128x4_xof_squeeze(&xof, dsts, BENCH_MULTI_SIZE);
+  }
+}
+
+// squeeze 4 kB from each of 8 shake128 xofs, 8 at a time
+static void bench_shake128x8_squeeze_8x4kb(void) {
+  const uint8_t *ms[8] = { 0 };
+  uint8_t *dsts[8] = { 0 };
+  for (size_t i = 0; i < 8; i++) {
+    ms[i] = ctx.keygen_seed + i;
+    dsts[i] = ctx.big + BENCH_MULTI_SIZE * i;
+  }
+
+  sha3_xof_x8_t xof = { 0 };
+  shake128x8_xof_init(&xof);
+  (void) shake128x8_xof_absorb(&xof, ms, 34);
+  shake128x8_xof_squeeze(&xof, dsts, BENCH_MULTI_SIZE);
+}
+
+static void bench_poly_sample_ntt(void) {
+  poly_sample_ntt(&ctx.poly, ctx.keygen_seed, 1, 2);
+}
+
+static void bench_mat2_sample_ntt(void) {
+  mat_sample_ntt(ctx.mat, 2, ctx.keygen_seed, false);
+}
+
+static void bench_mat3_sample_ntt(void) {
+  mat_sample_ntt(ctx.mat, 3, ctx.keygen_seed, false);
+}
+
+static void bench_mat4_sample_ntt(void) {
+  mat_sample_ntt(ctx.mat, 4, ctx.keygen_seed, false);
+}
+
+// sample s and e (pke768_keygen()), and r, e1, and e2
+// (pke1024_encrypt())
+static void bench_mat4_mul_sample_ntt(void) {
+  mat_mul_sample_ntt(ctx.vec + 4, 4, ctx.keygen_seed, false, ctx.vec, NULL);
+}
+
+static void bench_pke768_sample_se(void) {
+  polys_sample_cbd(ctx.mat, ctx.keygen_seed, PKE768_ETA1, 2 * PKE768_K, 0);
+}
+
+static void bench_pke1024_sample_ree(void) {
+  polys_sample_cbd(ctx.mat, ctx.encaps_seed, PKE1024_ETA1, PKE1024_K, PKE1024_K + 1);
+}
+
+static void bench_poly_ntt(void) {
+  poly_ntt(&ctx.poly);
+}
+
+static void bench_poly_inv_ntt(void) {
+  poly_inv_ntt(&ctx.poly);
+}
+
+static void bench_poly_inv_ntt_encode(void) {
+  poly_inv_ntt_encode(ctx.buf, &ctx.poly, ctx.mat, 11);
+}
+
+static void bench_poly_decode_ntt(void) {
+  poly_decode_ntt(&ctx.poly, ctx.buf, 11);
+}
+
+static void bench_poly_add(void) {
+  poly_add(&ctx.poly, ctx.mat);
+}
+
+static void bench_poly_sub(void) {
+  poly_sub(&ctx.poly, ctx.mat);
+}
+
+static void bench_poly_mul(void) {
+  poly_mul(ctx.mat + 1, &ctx.poly, ctx.mat);
+}
+
+static void bench_mat3_mul(void) {
+  mat3_mul(ctx.vec + 4, ctx.mat, ctx.vec, NULL);
+}
+
+static void bench_mat4_mul(void) {
+  mat4_mul(ctx.vec + 4, ctx.mat, ctx.vec, NULL);
+}
+
+// mat4_mul() and vec4_dot() with the same vector, like pke1024_encrypt()
+static void bench_mat4_mul_vec4_dot(void) {
+  mat4_mul(ctx.vec + 4, ctx.mat, ctx.vec, NULL);
+  vec4_dot(&ctx.poly, ctx.vec + 4, ctx.vec, NULL);
+}
+
+// mat4_mul() and vec4_dot() with a shared mulcache of the vector
+static void bench_mat4_mul_vec4_dot_cached(void) {
+  poly_mulcache_t mc[4] = { 0 };
+  vec4_mulcache(mc, ctx.vec);
+  mat4_mul(ctx.vec + 4, ctx.mat, ctx.vec, mc);
+  vec4_dot(&ctx.poly, ctx.vec + 4, ctx.vec, mc);
+}
+
+static void bench_vec4_dot(void) {
+  vec4_dot(&ctx.poly, ctx.vec, ctx.vec + 4, NULL);
+}
+
+// number of batches needed for ctx.batch_n polynomials
+static size_t bench_num_batches(void) {
+  return (ctx.batch_n + POLY_BATCH_SIZE - 1) / POLY_BATCH_SIZE;
+}
+
+static void bench_polys_ntt(void) {
+  for (size_t i = 0; i < ctx.batch_n; i++) {
+    poly_ntt(ctx.polys[0] + i);
+  }
+}
+
+static void bench_poly_batch_ntt(void) {
+  for (size_t i = 0; i < bench_num_batches(); i++) {
+    poly_batch_ntt(ctx.batches[0] + i);
+  }
+}
+
+static void bench_polys_inv_ntt(void) {
+  for (size_t i = 0; i < ctx.batch_n; i++) {
+    poly_inv_ntt(ctx.polys[0] + i);
+  }
+}
+
+static void bench_poly_batch_inv_ntt(void) {
+  for (size_t i = 0; i < bench_num_batches(); i++) {
+    poly_batch_inv_ntt(ctx.batches[0] + i);
+  }
+}
+
+static void bench_polys_basemul(void) {
+  for (size_t i = 0; i < ctx.batch_n; i++) {
+    poly_basemul_acc(ctx.polys[2] + i, ctx.polys[0] + i, ctx.polys[1] + i, NULL, 1);
+  }
+}
+
+static void bench_poly_batch_basemul(void) {
+  for (size_t i = 0; i < bench_num_batches(); i++) {
+    poly_batch_basemul_acc(ctx.batches[2] + i, ctx.batches[0] + i, ctx.batches[1] + i, 1);
+  }
+}
+
+static void bench_polys_sample_cbd2(void) {
+  for (size_t i = 0; i < ctx.batch_n; i++) {
+    poly_sample_cbd2(ctx.polys[1] + i, ctx.keygen_seed, i);
+  }
+}
+
+// sample from cbd(2) and cbd(3) without the prf (uses `ctx.buf` as prf
+// output)
+static void bench_poly_cbd2(void) {
+  poly_cbd2(ctx.polys[1], ctx.buf);
+}
+
+static void bench_poly_cbd3(void) {
+  poly_cbd3(ctx.polys[1], ctx.buf);
+}
+
+// parse three blocks of xof output (uses `ctx.big` as xof output, and
+// moves to the next 512 bytes on each call so that the accept and
+// reject branches are not learned)
+static void bench_poly_sample_ntt_parse(void) {
+  static size_t i = 0;
+  (void) poly_sample_ntt_parse(ctx.polys[1], 0, ctx.big + 512 * (i++ % 64), 3 * SHAKE128_RATE);
+}
+
+static void bench_poly_batch_sample_cbd2(void) {
+  uint8_t bs[POLY_BATCH_SIZE] = { 0 };
+  for (size_t i = 0; i < bench_num_batches(); i++) {
+    const size_t n = ctx.batch_n - POLY_BATCH_SIZE * i;
+    for (size_t k = 0; k < POLY_BATCH_SIZE; k++) {
+      bs[k] = POLY_BATCH_SIZE * i + k;
+    }
+    poly_batch_sample_cbd2(ctx.batches[1] + i, ctx.keygen_seed, bs, (n < POLY_BATCH_SIZE) ? n : POLY_BATCH_SIZE);
+  }
+}
+
+static void bench_polys_compress(void) {
+  for (size_t i = 0; i < ctx.batch_n; i++) {
+    poly_compress(ctx.ys[i], ctx.polys[1] + i, 10);
+  }
+}
+
+static void bench_poly_batch_compress(void) {
+  for (size_t i = 0; i < bench_num_batches(); i++) {
+    ctx.batches[2][i] = ctx.batches[1][i];
+    poly_batch_compress(ctx.batches[2] + i, 10);
+  }
+}
+
+static void bench_poly_encode(void) {
+  poly_encode(ctx.buf, &ctx.poly);
+}
+
+static void bench_poly_decode(void) {
+  poly_decode(&ctx.poly, ctx.buf);
+}
+
+static void bench_poly_encode_11bit(void) {
+  poly_encode_11bit(ctx.buf, &ctx.poly);
+}
+
+static void bench_poly_encode_10bit(void) {
+  poly_encode_10bit(ctx.buf, &ctx.poly);
+}
+
+static void bench_poly_encode_5bit(void) {
+  poly_encode_5bit(ctx.buf, &ctx.poly);
+}
+
+static void bench_poly_encode_4bit(void) {
+  poly_encode_4bit(ctx.buf, &ctx.poly);
+}
+
+static void bench_poly_encode_1bit(void) {
+  poly_encode_1bit(ctx.buf, &ctx.poly);
+}
+
+static void bench_poly_decode_11bit(void) {
+  poly_decode_11bit(&ctx.poly, ctx.buf);
+}
+
+static void bench_poly_decode_10bit(void) {
+  poly_decode_10bit(&ctx.poly, ctx.buf);
+}
+
+static void bench_poly_decode_5bit(void) {
+  poly_decode_5bit(&ctx.poly, ctx.buf);
+}
+
+static void bench_poly_decode_4bit(void) {
+  poly_decode_4bit(&ctx.poly, ctx.buf);
+}
+
+static void bench_kem512_keygen(void) {
+  fips203ipd_kem512_keygen(ctx.ek512, ctx.dk512, ctx.keygen_seed);
+}
+
+static void bench_kem512_encaps(void) {
+  fips203ipd_kem512_encaps(ctx.key, ctx.ct512, ctx.ek512, ctx.encaps_seed);
+}
+
+static void bench_kem512_decaps(void) {
+  fips203ipd_kem512_decaps(ctx.key, ctx.ct512, ctx.dk512);
+}
+
+static void bench_kem768_keygen(void) {
+  fips203ipd_kem768_keygen(ctx.ek768, ctx.dk768, ctx.keygen_seed);
+}
+
+static void bench_kem768_encaps(void) {
+  fips203ipd_kem768_encaps(ctx.key, ctx.ct768, ctx.ek768, ctx.encaps_seed);
+}
+
+static void bench_kem768_decaps(void) {
+  fips203ipd_kem768_decaps(ctx.key, ctx.ct768, ctx.dk768);
+}
+
+static void bench_kem1024_keygen(void) {
+  fips203ipd_kem1024_keygen(ctx.ek1024, ctx.dk1024, ctx.keygen_seed);
+}
+
+static void bench_kem1024_encaps(void) {
+  fips203ipd_kem1024_encaps(ctx.key, ctx.ct1024, ctx.ek1024, ctx.encaps_seed);
+}
+
+static void bench_kem1024_decaps(void) {
+  fips203ipd_kem1024_decaps(ctx.key, ctx.ct1024, ctx.dk1024);
+}
+
+int main(void) {
+  // populate seeds and polynomial buffer with random data
+  rand_bytes(ctx.keygen_seed, sizeof(ctx.keygen_seed));
+  rand_bytes(ctx.encaps_seed, sizeof(ctx.encaps_seed));
+  rand_bytes(ctx.buf, sizeof(ctx.buf));
+  poly_decode(&ctx.poly, ctx.buf);
+  poly_decode(ctx.mat, ctx.buf);
+
+  bench_run("shake256_prf", bench_shake256_prf, BENCH_NUM_ITERATIONS, 33);
+  bench_run("shake128_absorb_1mb", bench_shake128_absorb_big, BENCH_NUM_BIG_ITERATIONS, BENCH_BIG_SIZE);
+  bench_run("shake128_squeeze_1mb", bench_shake128_squeeze_big, BENCH_NUM_BIG_ITERATIONS, BENCH_BIG_SIZE);
+  bench_run("shake128_squeeze_8x4kb", bench_shake128_squeeze_8x4kb, BENCH_NUM_ITERATIONS / 10, 8 * BENCH_MULTI_SIZE);
+  bench_run("shake128x4_squeeze_8x4kb", bench_shake128x4_squeeze_8x4kb, BENCH_NUM_ITERATIONS / 10, 8 * BENCH_MULTI_SIZE);
+  bench_run("shake128x8_squeeze_8x4kb", bench_shake128x8_squeeze_8x4kb, BENCH_NUM_ITERATIONS / 10, 8 * BENCH_MULTI_SIZE);
+  bench_run("poly_sample_ntt", bench_poly_sample_ntt, BENCH_NUM_ITERATIONS, 0);
+  bench_run("mat2_sample_ntt", bench_mat2_sample_ntt, BENCH_NUM_ITERATIONS, 0);
+  bench_run("mat3_sample_ntt", bench_mat3_sample_ntt, BENCH_NUM_ITERATIONS, 0);
+  bench_run("mat4_sample_ntt", bench_mat4_sample_ntt, BENCH_NUM_ITERATIONS, 0);
+  bench_run("mat4_mul_sample_ntt", bench_mat4_mul_sample_ntt, BENCH_NUM_ITERATIONS, 0);
+  bench_run("pke768_sample_se", bench_pke768_sample_se, BENCH_NUM_ITERATIONS, 0);
+  bench_run("pke1024_sample_ree", bench_pke1024_sample_ree, BENCH_NUM_ITERATIONS, 0);
+  bench_run("poly_encode_1bit", bench_poly_encode_1bit, BENCH_NUM_ITERATIONS, 0);
+
+  // populate batch benchmark polynomials and batches
+  for (size_t i = 0; i < BENCH_BATCH_MAX; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      poly_sample_ntt(ctx.polys[j] + i, ctx.keygen_seed, j, i);
+    }
+  }
+  for (size_t i = 0; i < BENCH_BATCH_MAX / POLY_BATCH_SIZE; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      poly_batch_load(ctx.batches[j] + i, ctx.polys[j] + POLY_BATCH_SIZE * i, POLY_BATCH_SIZE);
+    }
+  }
+
+  // batch benchmarks: each operation on `n` polynomials, one at a time
+  // (polys_*) and in transposed batches of POLY_BATCH_SIZE (poly_batch_*)
+  static const size_t BATCH_NS[] = { 8, 16, BENCH_BATCH_MAX };
+  static const struct {
+    const char *name; // benchmark name
+    void (*fn)(void); // benchmark function
+    bool isa; // run once for each instruction set extension
+  } BATCH_BENCHES[] = {
+    { "polys_ntt", bench_polys_ntt, true },
+    { "poly_batch_ntt", bench_poly_batch_ntt, true },
+    { "polys_inv_ntt", bench_polys_inv_ntt, true },
+    { "poly_batch_inv_ntt", bench_poly_batch_inv_ntt, true },
+    { "polys_basemul", bench_polys_basemul, true },
+    { "poly_batch_basemul", bench_poly_batch_basemul, true },
+    { "polys_sample_cbd2", bench_polys_sample_cbd2, false },
+    { "poly_batch_sample_cbd2", bench_poly_batch_sample_cbd2, false },
+    { "polys_compress10", bench_polys_compress, false },
+    { "poly_batch_compress10", bench_poly_batch_compress, false },
+  };
+  const fips203ipd_backend_t prev = fips203ipd_backend();
+
+  for (size_t i = 0; i < sizeof(BATCH_BENCHES) / sizeof(BATCH_BENCHES[0]); i++) {
+    for (size_t j = 0; j < sizeof(BATCH_NS) / sizeof(BATCH_NS[0]); j++) {
+      ctx.batch_n = BATCH_NS[j];
+      for (isa_t isa = ISA_SCALAR; isa <= (BATCH_BENCHES[i].isa ? cpu_isa() : ISA_SCALAR); isa++) {
+        if (!fips203ipd_backend_set(BATCH_BENCHES[i].isa ? (fips203ipd_backend_t) isa : prev)) {
+          continue; // left out at build time
+        }
+
+        char name[48] = { 0 };
+        if (BATCH_BENCHES[i].isa) {
+          snprintf(name, sizeof(name), "%s_x%zu/%s", BATCH_BENCHES[i].name, ctx.batch_n, BACKEND_NAMES[isa]);
+        } else {
+          snprintf(name, sizeof(name), "%s_x%zu", BATCH_BENCHES[i].name, ctx.batch_n);
+        }
+        bench_run(name, BATCH_BENCHES[i].fn, BENCH_NUM_ITERATIONS / 10, 0);
+      }
+    }
+  }
+  fips203ipd_backend_set(prev);
+
+  // run the polynomial arithmetic and kem benchmarks once for each
+  // backend supported by this cpu
+  // (note: keygen and encaps benchmarks also populate the keys and
+  // ciphertext used by the decaps benchmarks)
+  static const struct {
+    const char *name; // benchmark name
+    void (*fn)(void); // benchmark function
+  } ISA_BENCHES[] = {
+    { "poly_ntt", bench_poly_ntt },
+    { "poly_inv_ntt", bench_poly_inv_ntt },
+    { "poly_inv_ntt_encode11", bench_poly_inv_ntt_encode },
+    { "poly_decode_ntt11", bench_poly_decode_ntt },
+    { "poly_add", bench_poly_add },
+    { "poly_sub", bench_poly_sub },
+    { "poly_mul", bench_poly_mul },
+    { "poly_encode", bench_poly_encode },
+    { "poly_decode", bench_poly_decode },
+    { "poly_encode_11bit", bench_poly_encode_11bit },
+    { "poly_encode_10bit", bench_poly_encode_10bit },
+    { "poly_encode_5bit", bench_poly_encode_5bit },
+    { "poly_encode_4bit", bench_poly_encode_4bit },
+    { "poly_decode_11bit", bench_poly_decode_11bit },
+    { "poly_decode_10bit", bench_poly_decode_10bit },
+    { "poly_decode_5bit", bench_poly_decode_5bit },
+    { "poly_decode_4bit", bench_poly_decode_4bit },
+    { "poly_cbd2", bench_poly_cbd2 },
+    { "poly_cbd3", bench_poly_cbd3 },
+    { "poly_sample_ntt_parse", bench_poly_sample_ntt_parse },
+    { "mat3_mul", bench_mat3_mul },
+    { "mat4_mul", bench_mat4_mul },
+    { "vec4_dot", bench_vec4_dot },
+    { "mat4_mul_vec4_dot", bench_mat4_mul_vec4_dot },
+    { "mat4_mul_vec4_dot_mc", bench_mat4_mul_vec4_dot_cached },
+    { "kem512_keygen", bench_kem512_keygen },
+    { "kem512_encaps", bench_kem512_encaps },
+    { "kem512_decaps", bench_kem512_decaps },
+    { "kem768_keygen", bench_kem768_keygen },
+    { "kem768_encaps", bench_kem768_encaps },
+    { "kem768_decaps", bench_kem768_decaps },
+    { "kem1024_keygen", bench_kem1024_keygen },
+    { "kem1024_encaps", bench_kem1024_encaps },
+    { "kem1024_decaps", bench_kem1024_decaps },
+  };
+
+  for (isa_t isa = ISA_SCALAR; isa <= cpu_isa(); isa++) {
+    if (!fips203ipd_backend_set((fips203ipd_backend_t) isa)) {
+      continue; // left out at build time
+    }
+    for (size_t i = 0; i < sizeof(ISA_BENCHES) / sizeof(ISA_BENCHES[0]); i++) {
+      char name[48] = { 0 };
+      snprintf(name, sizeof(name), "%s/%s", ISA_BENCHES[i].name, BACKEND_NAMES[isa]);
+      bench_run(name, ISA_BENCHES[i].fn, BENCH_NUM_ITERATIONS, 0);
+    }
+  }
+  fips203ipd_backend_set(prev);
+
+  // peak stack usage of kem operations
+  // (note: skips the polynomial arithmetic benchmarks, which only use
+  // the shared buffers in `ctx`)
+  for (size_t i = 0; i < sizeof(ISA_BENCHES) / sizeof(ISA_BENCHES[0]); i++) {
+    if (!strncmp(ISA_BENCHES[i].name, "kem", 3)) {
+      bench_stack(ISA_BENCHES[i].name, ISA_BENCHES[i].fn);
+    }
+  }
+
+  return 0;
+}
+#endif /* BENCH_FIPS203IPD */
+
 /** @endcond INTERNAL */
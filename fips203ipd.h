@@ -15,6 +15,7 @@
 #ifndef FIPS203IPD_H
 #define FIPS203IPD_H
 
+#include <stdbool.h> // bool
 #include <stdint.h> // uint8_t
 
 /**
@@ -96,6 +97,21 @@ void fips203ipd_kem512_keygen(uint8_t ek[static FIPS203IPD_KEM512_EK_SIZE], uint
  */
 void fips203ipd_kem512_encaps(uint8_t key[static 32], uint8_t ct[static FIPS203IPD_KEM512_CT_SIZE], const uint8_t ek[static FIPS203IPD_KEM512_EK_SIZE], const uint8_t seed[static 32]);
 
+/**
+ * @brief Check KEM512 encapsulation key `ek`.
+ * @ingroup kem512
+ *
+ * Returns true if every coefficient of the encoded polynomials in `ek`
+ * is less than Q (the modulus check from the final FIPS 203 standard).
+ * `fips203ipd_kem512_encaps()` reduces out-of-range coefficients
+ * instead of rejecting them, so call this function first to reject
+ * invalid encapsulation keys.  Runs in constant time.
+ *
+ * @param[in] ek KEM512 encapsulation key (800 bytes).
+ * @return True if `ek` passes the modulus check.
+ */
+bool fips203ipd_kem512_ek_check(const uint8_t ek[static FIPS203IPD_KEM512_EK_SIZE]);
+
 /**
  * @brief Decapsulate shared key `key` from ciphertext `ct` using KEM512
  * decapsulation key `dk` with implicit rejection.
@@ -200,6 +216,21 @@ void fips203ipd_kem768_keygen(uint8_t ek[static FIPS203IPD_KEM768_EK_SIZE], uint
  */
 void fips203ipd_kem768_encaps(uint8_t key[static 32], uint8_t ct[static FIPS203IPD_KEM768_CT_SIZE], const uint8_t ek[static FIPS203IPD_KEM768_EK_SIZE], const uint8_t seed[static 32]);
 
+/**
+ * @brief Check KEM768 encapsulation key `ek`.
+ * @ingroup kem768
+ *
+ * Returns true if every coefficient of the encoded polynomials in `ek`
+ * is less than Q (the modulus check from the final FIPS 203 standard).
+ * `fips203ipd_kem768_encaps()` reduces out-of-range coefficients
+ * instead of rejecting them, so call this function first to reject
+ * invalid encapsulation keys.  Runs in constant time.
+ *
+ * @param[in] ek KEM768 encapsulation key (1184 bytes).
+ * @return True if `ek` passes the modulus check.
+ */
+bool fips203ipd_kem768_ek_check(const uint8_t ek[static FIPS203IPD_KEM768_EK_SIZE]);
+
 /**
  * @brief Decapsulate shared key `key` from ciphertext `ct` using KEM768
  * decapsulation key `dk` with implicit rejection.
@@ -304,6 +335,21 @@ void fips203ipd_kem1024_keygen(uint8_t ek[static FIPS203IPD_KEM1024_EK_SIZE], ui
  */
 void fips203ipd_kem1024_encaps(uint8_t key[static 32], uint8_t ct[static FIPS203IPD_KEM1024_CT_SIZE], const uint8_t ek[static FIPS203IPD_KEM1024_EK_SIZE], const uint8_t seed[static 32]);
 
+/**
+ * @brief Check KEM1024 encapsulation key `ek`.
+ * @ingroup kem1024
+ *
+ * Returns true if every coefficient of the encoded polynomials in `ek`
+ * is less than Q (the modulus check from the final FIPS 203 standard).
+ * `fips203ipd_kem1024_encaps()` reduces out-of-range coefficients
+ * instead of rejecting them, so call this function first to reject
+ * invalid encapsulation keys.  Runs in constant time.
+ *
+ * @param[in] ek KEM1024 encapsulation key (1568 bytes).
+ * @return True if `ek` passes the modulus check.
+ */
+bool fips203ipd_kem1024_ek_check(const uint8_t ek[static FIPS203IPD_KEM1024_EK_SIZE]);
+
 /**
  * @brief Decapsulate shared key `key` from ciphertext `ct` using KEM1024
  * decapsulation key `dk` with implicit rejection.
@@ -329,4 +375,67 @@ void fips203ipd_kem1024_encaps(uint8_t key[static 32], uint8_t ct[static FIPS203
  */
 void fips203ipd_kem1024_decaps(uint8_t key[static 32], const uint8_t ct[static FIPS203IPD_KEM1024_CT_SIZE], const uint8_t dk[static FIPS203IPD_KEM1024_DK_SIZE]);
 
+/**
+ * @defgroup backend Backends
+ * @brief Instruction set extensions used by the polynomial kernels and
+ * the Keccak permutations.
+ *
+ * The best backend supported by the CPU (and compiled in) is selected
+ * once at startup, so one binary runs on any CPU of the target
+ * architecture.  To use a lower backend instead, set the
+ * `FIPS203IPD_BACKEND` environment variable to its name (see
+ * `fips203ipd_backend_name()`), or call `fips203ipd_backend_set()`.
+ */
+
+/**
+ * @brief Backend (instruction set extensions).
+ * @ingroup backend
+ *
+ * Backends are ordered: each one supported by a CPU implies that the
+ * ones before it are supported too.
+ */
+typedef enum {
+  FIPS203IPD_BACKEND_SCALAR, /**< Reference C (`scalar`). */
+  FIPS203IPD_BACKEND_VEC, /**< Portable vector extensions (`vec`). */
+  FIPS203IPD_BACKEND_AVX2, /**< AVX2 (`avx2`). */
+  FIPS203IPD_BACKEND_AVX512, /**< AVX-512F and AVX-512BW (`avx512`). */
+  FIPS203IPD_BACKEND_AVX512VBMI, /**< AVX-512F, AVX-512BW, and AVX-512 VBMI (`avx512vbmi`). */
+  FIPS203IPD_BACKEND_AVX512VBMI2, /**< AVX-512F, AVX-512BW, AVX-512 VBMI, and AVX-512 VBMI2 (`avx512vbmi2`). */
+} fips203ipd_backend_t;
+
+/**
+ * @brief Get current backend.
+ * @ingroup backend
+ *
+ * @return Current backend.
+ */
+fips203ipd_backend_t fips203ipd_backend(void);
+
+/**
+ * @brief Get name of backend.
+ * @ingroup backend
+ *
+ * @param[in] backend Backend.
+ *
+ * @return Backend name (e.g. `avx2`), or NULL if `backend` is invalid.
+ */
+const char *fips203ipd_backend_name(const fips203ipd_backend_t backend);
+
+/**
+ * @brief Set backend.
+ * @ingroup backend
+ *
+ * Use `backend` for all subsequent operations.  Also sets the matching
+ * Keccak permutation backend of the SHA-3 library.  Fails if `backend`
+ * was left out at build time or is not supported by this CPU.
+ *
+ * @note Not thread-safe: call before using the other functions of this
+ * library from other threads.
+ *
+ * @param[in] backend Backend.
+ *
+ * @return True if the backend was set, false if it is not supported.
+ */
+bool fips203ipd_backend_set(const fips203ipd_backend_t backend);
+
 #endif /* FIPS203IPD_H */
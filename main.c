@@ -7,6 +7,10 @@
 // 3. Use the decapsulation key to decapsulate the shared secret.
 // 4. Verify that the shared secret from steps #2 and #3 match.
 //
+// Prints the backend (instruction set extensions) selected at startup
+// first.  Set the FIPS203IPD_BACKEND environment variable to the name
+// of a backend (e.g. "scalar") to test that one instead.
+//
 
 #include <stdlib.h> // exit()
 #include <stdio.h> // printf()
@@ -141,6 +145,8 @@ static void run_kem1024_tests(void) {
 }
 
 int main(void) {
+  printf("backend: %s\n", fips203ipd_backend_name(fips203ipd_backend()));
+
   run_kem512_tests();
   run_kem768_tests();
   run_kem1024_tests();
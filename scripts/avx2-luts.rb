@@ -0,0 +1,119 @@
+#!/usr/bin/env ruby
+
+#
+# avx2-luts.rb: generate twiddle factor tables for the AVX2 NTT and
+# inverse NTT kernels.
+#
+# The NTT kernels hold the 256 coefficients of a polynomial in 16
+# vectors of 16 16-bit lanes.  The layers with len = 8, 4, and 2 work
+# on pairs of vectors (x, y), which avx2_split() rearranges into
+# butterfly operands (a, b).  For each of these layers this script
+# emits the twiddle factor for every lane of `b`, for each of the 8
+# vector pairs, for both the forward and inverse NTT.
+#
+# Twiddle factors are in centered Montgomery form, like NTT_LUT (see
+# luts.rb), and have a companion table with the factors multiplied by
+# QINV mod 2**16, like NTT_LUT_QINV.
+#
+# Also emits the left-pack shuffle table for the AVX2 rejection sampler
+# (poly_sample_ntt_parse_avx2()): for each 8-bit mask of accepted
+# 16-bit lanes, the `pshufb` byte indices which move the accepted lanes
+# to the front, in order.  Unused indices are -1 (zero byte).
+#
+
+B = 17
+Q = 3329
+R = 1 << 16
+QINV = -3327
+
+# layers handled with avx2_split() (index = table layer)
+LENS = [8, 4, 2]
+
+def bitrev(n)
+  ((n >> 6) & 1) |
+    (((n >> 5) & 1) << 1) |
+    (((n >> 4) & 1) << 2) |
+    (((n >> 3) & 1) << 3) |
+    (((n >> 2) & 1) << 4) |
+    (((n >> 1) & 1) << 5) |
+    (((n >> 0) & 1) << 6)
+end
+
+# convert z to centered Montgomery form
+def mont(z)
+  r = (z * R) % Q
+  (r > Q / 2) ? r - Q : r
+end
+
+# companion factor (r * QINV) mod 2**16 of Montgomery form value r, as
+# a signed 16-bit value
+def qinv(r)
+  x = (r * QINV) % R
+  (x >= R / 2) ? x - R : x
+end
+
+# NTT twiddle factors (same as NTT_LUT)
+ZETAS = 128.times.map { |n| mont(B.pow(bitrev(n), Q)) }
+
+# group (0 to 16 / len - 1, within pair) of lane `m` of operand `b`
+# after avx2_split()
+def group(len, m)
+  case len
+  when 8 then m / 8
+  when 4 then 2 * ((m / 4) % 2) + m / 8
+  when 2 then ((m / 2) % 2) + 4 * ((m % 8) / 4) + 2 * (m / 8)
+  end
+end
+
+# twiddle factor index for lane `m` of pair `p` in layer `len`
+def zeta_index(len, p, m, inv)
+  g = (16 / len) * p + group(len, m)
+  inv ? (256 / len - 1 - g) : (128 / len + g)
+end
+
+zetas = [false, true].map do |inv|
+  LENS.map do |len|
+    8.times.map do |p|
+      16.times.map { |m| ZETAS[zeta_index(len, p, m, inv)] }
+    end
+  end
+end
+
+zeta_qinvs = zetas.map { |a| a.map { |b| b.map { |c| c.map { |r| qinv(r) } } } }
+
+# left-pack byte indices for each 8-bit mask of accepted lanes
+rej_idxs = 256.times.map do |m|
+  lanes = 8.times.select { |i| m[i] == 1 }
+  (lanes.flat_map { |i| [2 * i, 2 * i + 1] } + [-1] * 16).first(16)
+end
+
+def nested(arr, depth = 1)
+  indent = '  ' * depth
+  if arr.first.first.is_a?(Array)
+    arr.map { |a| "#{indent}{\n" + nested(a, depth + 1) + "\n#{indent}}," }.join("\n")
+  else
+    arr.map { |a| "#{indent}{ " + a.join(', ') + ' },' }.join("\n")
+  end
+end
+
+puts <<~EOS
+  // AVX2 NTT twiddle factors for the len = 8, 4, 2 layers, in the lane
+  // order of split operand b, in Montgomery form
+  // ([forward, inverse][layer][pair][lane], used by poly_ntt_avx2() and
+  // poly_inv_ntt_avx2())
+  static const int16_t NTT_AVX2_ZETAS[2][3][8][16] = {
+  #{nested(zetas)}
+  };
+
+  // NTT_AVX2_ZETAS multiplied by QINV mod 2^16 (companion factors for
+  // Montgomery multiplication)
+  static const int16_t NTT_AVX2_ZETAS_QINV[2][3][8][16] = {
+  #{nested(zeta_qinvs)}
+  };
+
+  // AVX2 rejection sampler left-pack shuffles ([mask of accepted
+  // lanes][byte], used by poly_sample_ntt_parse_avx2())
+  static const int8_t REJ_AVX2_IDX[256][16] = {
+  #{nested(rej_idxs)}
+  };
+EOS
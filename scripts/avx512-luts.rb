@@ -0,0 +1,137 @@
+#!/usr/bin/env ruby
+
+#
+# avx512-luts.rb: generate twiddle factor and lane permutation tables
+# for the AVX-512 NTT, inverse NTT, and base case multiply kernels.
+#
+# The NTT kernels hold the 256 coefficients of a polynomial in 8
+# vectors of 32 16-bit lanes.  The layers with len = 16, 8, 4, and 2
+# work on pairs of vectors (x, y), which are split into butterfly
+# operands (a, b) and merged back with vpermt2w.  For each of these
+# layers this script emits:
+#
+# - the split and merge permutation indices, and
+# - the twiddle factor for every lane of `b`, for each of the 4 vector
+#   pairs, for both the forward and inverse NTT.
+#
+# Twiddle factors are in centered Montgomery form, like NTT_LUT and
+# MUL_LUT (see luts.rb).  Each twiddle factor table has a companion
+# table with the factors multiplied by QINV mod 2**16, like
+# NTT_LUT_QINV.
+#
+
+B = 17
+Q = 3329
+R = 1 << 16
+QINV = -3327
+
+# layers handled with permutes (index = table layer)
+LENS = [16, 8, 4, 2]
+
+def bitrev(n)
+  ((n >> 6) & 1) |
+    (((n >> 5) & 1) << 1) |
+    (((n >> 4) & 1) << 2) |
+    (((n >> 3) & 1) << 3) |
+    (((n >> 2) & 1) << 4) |
+    (((n >> 1) & 1) << 5) |
+    (((n >> 0) & 1) << 6)
+end
+
+# convert z to centered Montgomery form
+def mont(z)
+  r = (z * R) % Q
+  (r > Q / 2) ? r - Q : r
+end
+
+# companion factor (r * QINV) mod 2**16 of Montgomery form value r, as
+# a signed 16-bit value
+def qinv(r)
+  x = (r * QINV) % R
+  (x >= R / 2) ? x - R : x
+end
+
+# NTT twiddle factors (same as NTT_LUT)
+ZETAS = 128.times.map { |n| mont(B.pow(bitrev(n), Q)) }
+
+# index (0-63, within pair) of first element of butterfly for lane `m`
+def first(len, m)
+  ((m & ~(len - 1)) << 1) | (m & (len - 1))
+end
+
+# format rows of 32 values
+def rows(vals, indent)
+  vals.each_slice(32).map { |row| indent + row.join(', ') + ',' }.join("\n")
+end
+
+perms = LENS.map do |len|
+  a = 32.times.map { |m| first(len, m) }
+  b = a.map { |i| i + len }
+
+  # merge: position i of (x || y) comes from lane of a (0-31) or b (32-63)
+  xy = 64.times.map do |i|
+    lane = ((i >> 1) & ~(len - 1)) | (i & (len - 1))
+    (i & len != 0) ? 32 + lane : lane
+  end
+
+  [a, b, xy[0, 32], xy[32, 32]]
+end
+
+# twiddle factor index for lane `m` of pair `p` in layer `len`
+def zeta_index(len, p, m, inv)
+  group = (64 * p + first(len, m)) / (2 * len)
+  inv ? (256 / len - 1 - group) : (128 / len + group)
+end
+
+zetas = [false, true].map do |inv|
+  LENS.map do |len|
+    4.times.map do |p|
+      32.times.map { |m| ZETAS[zeta_index(len, p, m, inv)] }
+    end
+  end
+end
+
+zeta_qinvs = zetas.map { |a| a.map { |b| b.map { |c| c.map { |r| qinv(r) } } } }
+
+# base case multiply factors (same as MUL_LUT), in the odd lanes (even
+# lanes are unused)
+mul_zetas = 128.times.flat_map do |n|
+  [0, mont(B.pow(2 * bitrev(n) + 1, Q))]
+end
+
+def nested(arr, depth = 1)
+  indent = '  ' * depth
+  if arr.first.is_a?(Array) && arr.first.first.is_a?(Array)
+    arr.map { |a| "#{indent}{\n" + nested(a, depth + 1) + "\n#{indent}}," }.join("\n")
+  else
+    arr.map { |a| "#{indent}{\n" + rows(a, indent + '  ') + "\n#{indent}}," }.join("\n")
+  end
+end
+
+puts <<~EOS
+  // AVX-512 NTT lane permutations for the len = 16, 8, 4, 2 layers
+  // ([layer][split a, split b, merge x, merge y][lane], used by
+  // poly_ntt_avx512() and poly_inv_ntt_avx512())
+  static const uint16_t NTT_AVX512_PERMS[4][4][32] = {
+  #{nested(perms)}
+  };
+
+  // AVX-512 NTT twiddle factors for the len = 16, 8, 4, 2 layers, in the
+  // lane order of split operand b, in Montgomery form
+  // ([forward, inverse][layer][pair][lane])
+  static const int16_t NTT_AVX512_ZETAS[2][4][4][32] = {
+  #{nested(zetas)}
+  };
+
+  // NTT_AVX512_ZETAS multiplied by QINV mod 2^16 (companion factors for
+  // Montgomery multiplication)
+  static const int16_t NTT_AVX512_ZETAS_QINV[2][4][4][32] = {
+  #{nested(zeta_qinvs)}
+  };
+
+  // AVX-512 base case multiply factors, MUL_LUT[i] in lane 2i + 1 (used
+  // by poly_mul_avx512())
+  static const int16_t MUL_AVX512_ZETAS[256] = {
+  #{rows(mul_zetas, '  ')}
+  };
+EOS
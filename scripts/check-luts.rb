@@ -0,0 +1,29 @@
+#!/usr/bin/env ruby
+
+#
+# check-luts.rb: check that the lookup tables in fips203ipd.c match the
+# output of the table generator scripts.
+#
+# Runs each generator and fails (exit code 1) if its output does not
+# appear verbatim in fips203ipd.c.  Used by the `test` target of the
+# top-level Makefile, so that a hand-edited or stale table fails the
+# build.
+#
+# Usage: scripts/check-luts.rb [path/to/fips203ipd.c]
+#
+
+DIR = File.dirname(__FILE__)
+SCRIPTS = %w{luts.rb vec-luts.rb avx2-luts.rb avx512-luts.rb vbmi-luts.rb}
+
+src = File.read(ARGV.shift || File.join(DIR, '..', 'fips203ipd.c'))
+
+errors = SCRIPTS.reject do |name|
+  out = IO.popen([RbConfig.ruby, File.join(DIR, name)], &:read)
+  $?.success? && src.include?(out.chomp)
+end
+
+errors.each do |name|
+  warn "#{name}: generated tables do not match fips203ipd.c"
+end
+
+exit(errors.empty? ? 0 : 1)
@@ -3,9 +3,20 @@
 #
 # luts.rb: generate NTT and BCM lookup tables.
 #
+# Both tables hold their factors in signed Montgomery form: each entry
+# is `(z * 2**16) % 3329`, centered in the range [-1664, 1664], so that
+# a Montgomery multiply by an entry is a multiply by `z`.
+#
+# NTT_LUT_QINV holds the companion factor `(r * QINV) % 2**16` of each
+# NTT_LUT entry `r`, as a signed 16-bit value.  With the companion
+# factor precomputed, a Montgomery multiply by a constant needs no
+# multiply by QINV at run time.
+#
 
 B = 17
 Q = 3329
+R = 1 << 16
+QINV = -3327
 
 def bitrev(n)
   ((n >> 6) & 1) |
@@ -17,28 +28,52 @@ def bitrev(n)
     (((n >> 0) & 1) << 6)
 end
 
+# convert z to centered Montgomery form
+def mont(z)
+  r = (z * R) % Q
+  (r > Q / 2) ? r - Q : r
+end
+
+# companion factor (r * QINV) mod 2**16 of Montgomery form value r, as
+# a signed 16-bit value
+def qinv(r)
+  x = (r * QINV) % R
+  (x >= R / 2) ? x - R : x
+end
+
 T = {
   main: %{
-// number-theoretic transform (NTT) lookup table
+// number-theoretic transform (NTT) lookup table, in Montgomery form
 // (used by poly_ntt() and poly_inv_ntt())
-static const uint16_t NTT_LUT[] = {
+static const int16_t NTT_LUT[] = {
 %<ntts>s
 };
 
-// polynomial base case multiply lookup table
+// polynomial base case multiply lookup table, in Montgomery form
 // (used by poly_mul())
-static const uint16_t MUL_LUT[] = {
+static const int16_t MUL_LUT[] = {
 %<muls>s
 };
+
+#if defined(FIPS203IPD_VEC) || defined(FIPS203IPD_AVX2) || defined(FIPS203IPD_AVX512)
+// NTT_LUT entries multiplied by QINV mod 2^16 (companion factors for
+// Montgomery multiplication by an NTT_LUT entry, used by the SIMD NTT
+// kernels)
+static const int16_t NTT_LUT_QINV[] = {
+%<qinvs>s
+};
+#endif /* FIPS203IPD_VEC || FIPS203IPD_AVX2 || FIPS203IPD_AVX512 */
 },
-  ntt: '  %<r>d, // n = %<n>d, bitrev(%<n>d) = %<e>d, (17**%<e>d)%%%<q>d = %<r>d',
-  mul: '  %<r>d, // n = %<n>d, 2*bitrev(%<n>d)+1 = %<e>d, (17**%<e>d)%%%<q>d) = %<r>d',
+  ntt: '  %<r>d, // n = %<n>d, bitrev(%<n>d) = %<e>d, (17**%<e>d)%%%<q>d = %<z>d',
+  mul: '  %<r>d, // n = %<n>d, 2*bitrev(%<n>d)+1 = %<e>d, (17**%<e>d)%%%<q>d = %<z>d',
 }
 
 puts(T[:main] % {
   ntts: 128.times.map { |n|
-      T[:ntt] % {
-      r: B.pow(bitrev(n), Q),
+    z = B.pow(bitrev(n), Q)
+    T[:ntt] % {
+      r: mont(z),
+      z: z,
       q: Q,
       n: n,
       e: bitrev(n),
@@ -46,11 +81,17 @@ puts(T[:main] % {
   }.join("\n"),
 
   muls: 128.times.map { |n|
-      T[:mul] % {
-      r: B.pow(2 * bitrev(n) + 1, Q),
+    z = B.pow(2 * bitrev(n) + 1, Q)
+    T[:mul] % {
+      r: mont(z),
+      z: z,
       q: Q,
       n: n,
       e: 2 * bitrev(n) + 1,
     }
   }.join("\n"),
+
+  qinvs: 128.times.map { |n|
+    qinv(mont(B.pow(bitrev(n), Q)))
+  }.each_slice(8).map { |row| '  ' + row.join(', ') + ',' }.join("\n"),
 })
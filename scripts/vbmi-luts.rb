@@ -0,0 +1,78 @@
+#!/usr/bin/env ruby
+
+#
+# vbmi-luts.rb: generate byte permutation and bit-field tables for the
+# AVX-512 VBMI packing and unpacking kernels for compressed
+# coefficients (11, 10, 5, and 4 bits).
+#
+# The kernels work on 32 coefficients (4 * d bytes) per vector.  Each
+# 64-bit lane `q` holds coefficients 4q to 4q + 3, which start at bit
+# 4 * d * q of the packed bytes.
+#
+# Packing squeezes the 4 d-bit values of each 64-bit lane into its low
+# 4 * d bits and shifts odd lanes left by (4 * d) % 8 bits, so that the
+# lane's bytes line up with the packed bytes; vpermt2b then moves the
+# bytes of the even lanes and the bytes of the odd lanes to their
+# packed positions, and the two results are OR-ed together (for odd d,
+# the lanes share a byte).  Unused positions select a byte of a zero
+# vector (index 64).
+#
+# Unpacking gathers the 8 packed bytes which start with coefficient 4q
+# into 64-bit lane q with vpermb, then extracts each 16-bit lane with
+# two vpmultishiftqb fields, so that the d-bit value ends at bit 14 of
+# the lane (ready for decompression with vpmulhrsw).
+#
+
+# compressed coefficient sizes, in bits (index = table row)
+DS = [11, 10, 5, 4]
+
+def nested(arr, depth = 1)
+  indent = '  ' * depth
+  if arr.first.first.is_a?(Array)
+    arr.map { |a| "#{indent}{\n" + nested(a, depth + 1) + "\n#{indent}}," }.join("\n")
+  else
+    arr.map { |a| "#{indent}{ " + a.join(', ') + ' },' }.join("\n")
+  end
+end
+
+pack_idxs = DS.map do |d|
+  tables = [[64] * 64, [64] * 64] # even lanes, odd lanes
+  8.times do |q|
+    ofs = 4 * d * q # bit offset of lane in packed bytes
+    len = (4 * d + ofs % 8 + 7) / 8 # length of shifted lane, in bytes
+    len.times { |k| tables[q % 2][ofs / 8 + k] = 8 * q + k }
+  end
+  tables
+end
+
+unpack_idxs = DS.map do |d|
+  64.times.map { |i| 4 * d * (i / 8) / 8 + i % 8 }
+end
+
+unpack_shifts = DS.map do |d|
+  64.times.map do |i|
+    q, r = i / 8, (i % 8) / 2 # lane, coefficient within lane
+    ofs = (4 * d * q) % 8 + d * r - (15 - d) # start of 16-bit field
+    (ofs + 8 * (i % 2)) % 64
+  end
+end
+
+puts <<~EOS
+  // AVX-512 VBMI packing byte permutations ([11, 10, 5, 4 bits][even,
+  // odd 64-bit lanes][byte], used by poly_encode_bits_vbmi())
+  static const uint8_t PACK_VBMI_IDX[4][2][64] = {
+  #{nested(pack_idxs)}
+  };
+
+  // AVX-512 VBMI unpacking byte permutations ([11, 10, 5, 4 bits][byte],
+  // used by poly_decode_bits_vbmi())
+  static const uint8_t UNPACK_VBMI_IDX[4][64] = {
+  #{nested(unpack_idxs)}
+  };
+
+  // AVX-512 VBMI unpacking bit-field offsets for vpmultishiftqb
+  // ([11, 10, 5, 4 bits][byte], used by poly_decode_bits_vbmi())
+  static const uint8_t UNPACK_VBMI_SHIFTS[4][64] = {
+  #{nested(unpack_shifts)}
+  };
+EOS
@@ -0,0 +1,97 @@
+#!/usr/bin/env ruby
+
+#
+# vec-luts.rb: generate twiddle factor tables for the portable vector
+# NTT and inverse NTT kernels.
+#
+# The NTT kernels hold the 256 coefficients of a polynomial in 32
+# vectors of 8 16-bit lanes.  The layers with len = 4 and 2 work on
+# pairs of vectors (x, y), which vec_split() rearranges into butterfly
+# operands (a, b).  For each of these layers this script emits the
+# twiddle factor for every lane of `b`, for each of the 16 vector
+# pairs, for both the forward and inverse NTT.
+#
+# Twiddle factors are in centered Montgomery form, like NTT_LUT (see
+# luts.rb), and have a companion table with the factors multiplied by
+# QINV mod 2**16, like NTT_LUT_QINV.
+#
+
+B = 17
+Q = 3329
+R = 1 << 16
+QINV = -3327
+
+# layers handled with vec_split() (index = table layer)
+LENS = [4, 2]
+
+def bitrev(n)
+  ((n >> 6) & 1) |
+    (((n >> 5) & 1) << 1) |
+    (((n >> 4) & 1) << 2) |
+    (((n >> 3) & 1) << 3) |
+    (((n >> 2) & 1) << 4) |
+    (((n >> 1) & 1) << 5) |
+    (((n >> 0) & 1) << 6)
+end
+
+# convert z to centered Montgomery form
+def mont(z)
+  r = (z * R) % Q
+  (r > Q / 2) ? r - Q : r
+end
+
+# companion factor (r * QINV) mod 2**16 of Montgomery form value r, as
+# a signed 16-bit value
+def qinv(r)
+  x = (r * QINV) % R
+  (x >= R / 2) ? x - R : x
+end
+
+# NTT twiddle factors (same as NTT_LUT)
+ZETAS = 128.times.map { |n| mont(B.pow(bitrev(n), Q)) }
+
+# index (0-15, within pair) of first element of butterfly for lane `m`
+def first(len, m)
+  ((m & ~(len - 1)) << 1) | (m & (len - 1))
+end
+
+# twiddle factor index for lane `m` of pair `p` in layer `len`
+def zeta_index(len, p, m, inv)
+  group = (16 * p + first(len, m)) / (2 * len)
+  inv ? (256 / len - 1 - group) : (128 / len + group)
+end
+
+zetas = [false, true].map do |inv|
+  LENS.map do |len|
+    16.times.map do |p|
+      8.times.map { |m| ZETAS[zeta_index(len, p, m, inv)] }
+    end
+  end
+end
+
+zeta_qinvs = zetas.map { |a| a.map { |b| b.map { |c| c.map { |r| qinv(r) } } } }
+
+def nested(arr, depth = 1)
+  indent = '  ' * depth
+  if arr.first.first.is_a?(Array)
+    arr.map { |a| "#{indent}{\n" + nested(a, depth + 1) + "\n#{indent}}," }.join("\n")
+  else
+    arr.map { |a| "#{indent}{ " + a.join(', ') + ' },' }.join("\n")
+  end
+end
+
+puts <<~EOS
+  // portable vector NTT twiddle factors for the len = 4, 2 layers, in
+  // the lane order of split operand b, in Montgomery form
+  // ([forward, inverse][layer][pair][lane], used by poly_ntt_vec() and
+  // poly_inv_ntt_vec())
+  static const int16_t NTT_VEC_ZETAS[2][2][16][8] = {
+  #{nested(zetas)}
+  };
+
+  // NTT_VEC_ZETAS multiplied by QINV mod 2^16 (companion factors for
+  // Montgomery multiplication)
+  static const int16_t NTT_VEC_ZETAS_QINV[2][2][16][8] = {
+  #{nested(zeta_qinvs)}
+  };
+EOS
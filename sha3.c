@@ -11,6 +11,7 @@
  * - SHA3-224, SHA3-256, SHA3-384, and SHA3-512
  * - HMAC-SHA3-224, HMAC-SHA3-256, HMAC-SHA3-384, and HMAC-SHA3-512
  * - SHAKE128, SHAKE128-XOF, SHAKE256, and SHAKE256-XOF
+ * - 4-way and 8-way SHAKE128-XOF and SHAKE256-XOF (multi-buffer)
  * - cSHAKE128, cSHAKE128-XOF, cSHAKE256, and cSHAKE256-XOF
  * - KMAC128, KMAC128-XOF, KMAC256, and KMAC256-XOF
  * - TupleHash128, TupleHash128-XOF, TupleHash256, and TupleHash256-XOF
@@ -23,6 +24,23 @@
 #include <string.h> // memcpy()
 #include "sha3.h"
 
+// The AVX2 and AVX-512 permutations are compiled with function target
+// attributes and selected at runtime with `__builtin_cpu_supports()`,
+// so one binary runs on CPUs with and without them.  Define
+// SHA3_NO_AVX2 or SHA3_NO_AVX512 to leave out the corresponding
+// permutations.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(SHA3_NO_AVX2)
+#define SHA3_AVX2
+#endif /* __x86_64__ && __GNUC__ && !SHA3_NO_AVX2 */
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(SHA3_NO_AVX512)
+#define SHA3_AVX512
+#endif /* __x86_64__ && __GNUC__ && !SHA3_NO_AVX512 */
+
+#if defined(SHA3_AVX2) || defined(SHA3_AVX512)
+#include <immintrin.h> // __m256i, __m512i, _mm256_*(), _mm512_*()
+#endif /* SHA3_AVX2 || SHA3_AVX512 */
+
 /** @cond INTERNAL */
 
 // 64-bit rotate left
@@ -34,12 +52,6 @@
 // number of rounds for permute()
 #define SHA3_NUM_ROUNDS 24
 
-#if !defined(__AVX512F__) || defined(SHA3_TEST)
-// If AVX512 is supported and we are not building the test suite,
-// then do not compile the scalar step functions below.
-//
-// (because they aren't used by the AVX512 implementation).
-
 // theta step of keccak permutation (scalar implementation)
 static inline void theta(uint64_t a[static 25]) {
   const uint64_t c[5] = {
@@ -168,16 +180,14 @@ static inline void iota(uint64_t a[static 25], const int i) {
 
   a[0] ^= RCS[i];
 }
-#endif /* !defined(__AVX512F__) || defined(SHA3_TEST) */
 
-#ifndef __AVX512F__
 // keccak permutation (scalar implementation)
 //
 // note: clang is better about inlining this than gcc with a
 // configurable number of rounds.  the configurable number of rounds is
 // only used by turboshake, so it might be worth creating a specialized
 // `permute12()` to handle turboshake.
-static inline void permute(uint64_t a[static 25], const size_t num_rounds) {
+static inline void permute_scalar(uint64_t a[static 25], const size_t num_rounds) {
   for (int i = 0; i < (int) num_rounds; i++) {
     theta(a);
     rho(a);
@@ -186,22 +196,18 @@ static inline void permute(uint64_t a[static 25], const size_t num_rounds) {
     iota(a, 24 - num_rounds + i);
   }
 }
-#endif /* __AVX512F__ */
-
-#ifdef __AVX512F__
-#include <immintrin.h>
 
+#ifdef SHA3_AVX512
 // keccak permutation (avx512 implementation).
 //
 // copied from `permute_avx512_fast()` in `tests/permute/permute.c`. all
 // steps are inlined as blocks. ~3x faster than scalar implementation,
 // but could be sped up more.
-static inline void permute(uint64_t s[static 25], const size_t num_rounds) {
+__attribute__((target("avx512f")))
+static inline void permute_avx512(uint64_t s[static 25], const size_t num_rounds) {
   // unaligned load mask and permutation indices
-  uint8_t mask = 0x1f,
-          m0b = 0x01;
-  const __mmask8 m = _load_mask8(&mask),
-                 m0 = _load_mask8(&m0b);
+  const __mmask8 m = 0x1f,
+                 m0 = 0x01;
 
   // round constants (used in iota)
   static const uint64_t RCS[] = {
@@ -280,14 +286,9 @@ static inline void permute(uint64_t s[static 25], const size_t num_rounds) {
     // pi
     {
       // mask bytes
-      uint8_t m01b = 0x03,
-              m23b = 0x0c,
-              m4b = 0x10;
-
-      // load masks
-      const __mmask8 m01 = _load_mask8(&m01b),
-                     m23 = _load_mask8(&m23b),
-                     m4 = _load_mask8(&m4b);
+      const __mmask8 m01 = 0x03,
+                     m23 = 0x0c,
+                     m4 = 0x10;
 
       // permutation indices
       //
@@ -413,7 +414,7 @@ static inline void permute(uint64_t s[static 25], const size_t num_rounds) {
       r0 = _mm512_mask_xor_epi64(r0, m0, r0, rc);
       rc = _mm512_permutexvar_epi64(rc_p, rc);
 
-      if (((24 - num_rounds + i + 1) % 8) == 0 && i != 23) {
+      if (((24 - num_rounds + i + 1) % 8) == 0 && i + 1 < (int) num_rounds) {
         // load next set of round constants
         // note: this will bomb if num_rounds < 8 or num_rounds > 24.
         rc = _mm512_loadu_epi64((void*) (RCS + 24 - num_rounds + (i + 1)));
@@ -428,7 +429,348 @@ static inline void permute(uint64_t s[static 25], const size_t num_rounds) {
   _mm512_mask_storeu_epi64((void*) (s + 15), m, r3),
   _mm512_mask_storeu_epi64((void*) (s + 20), m, r4);
 }
-#endif /* __AVX512F__ */
+#endif /* SHA3_AVX512 */
+
+// best keccak backend supported by this cpu (and compiled in)
+static inline sha3_backend_t cpu_backend(void) {
+#ifdef SHA3_AVX512
+  if (__builtin_cpu_supports("avx512f")) {
+    return SHA3_BACKEND_AVX512;
+  }
+#endif /* SHA3_AVX512 */
+
+#ifdef SHA3_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return SHA3_BACKEND_AVX2;
+  }
+#endif /* SHA3_AVX2 */
+
+  return SHA3_BACKEND_SCALAR;
+}
+
+// is keccak backend `b` compiled in? (see SHA3_NO_AVX2 and
+// SHA3_NO_AVX512)
+static inline _Bool backend_compiled(const sha3_backend_t b) {
+  switch (b) {
+  case SHA3_BACKEND_SCALAR:
+    return true;
+  case SHA3_BACKEND_AVX2:
+#ifdef SHA3_AVX2
+    return true;
+#else
+    return false;
+#endif /* SHA3_AVX2 */
+  case SHA3_BACKEND_AVX512:
+#ifdef SHA3_AVX512
+    return true;
+#else
+    return false;
+#endif /* SHA3_AVX512 */
+  default:
+    return false;
+  }
+}
+
+// keccak backend used by the permutations below.  resolved once at
+// startup by `backend_init()`, and changed with `sha3_backend_set()`.
+static sha3_backend_t backend = SHA3_BACKEND_SCALAR;
+
+#if defined(SHA3_AVX2) || defined(SHA3_AVX512)
+// resolve keccak backend at startup.  runs before the constructors of
+// the default priority, and before `backend_init()` in fips203ipd.c,
+// which may override the backend.
+__attribute__((constructor(101)))
+static void backend_init(void) {
+  __builtin_cpu_init(); // needed before __builtin_cpu_supports() in constructors
+  backend = cpu_backend();
+}
+#endif /* SHA3_AVX2 || SHA3_AVX512 */
+
+sha3_backend_t sha3_backend(void) {
+  return backend;
+}
+
+_Bool sha3_backend_set(const sha3_backend_t b) {
+  if (b > cpu_backend() || !backend_compiled(b)) {
+    return false;
+  }
+
+  backend = b;
+  return true;
+}
+
+// keccak permutation (dispatches to the avx512 or scalar
+// implementation, depending on the backend).
+static inline void permute(uint64_t a[static 25], const size_t num_rounds) {
+#ifdef SHA3_AVX512
+  if (backend >= SHA3_BACKEND_AVX512) {
+    permute_avx512(a, num_rounds);
+    return;
+  }
+#endif /* SHA3_AVX512 */
+
+  permute_scalar(a, num_rounds);
+}
+
+#ifdef SHA3_AVX2
+
+// rotate each 64-bit element of 256-bit vector `v` left by `n` bits
+#define ROL4(v, n) _mm256_or_si256(_mm256_slli_epi64((v), (n)), _mm256_srli_epi64((v), 64 - (n)))
+
+// 4-way keccak permutation (avx2 implementation).
+//
+// permutes four independent states at once.  the states are
+// interleaved so that lane `i` of state `j` is `s[4 * i + j]`, and each
+// 256-bit register holds the same lane of all four states.  the rho and
+// pi steps are combined.
+__attribute__((target("avx2")))
+static inline void permute_x4_avx2(uint64_t s[static 100], const size_t num_rounds) {
+  // round constants (used in iota)
+  static const uint64_t RCS[] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+  };
+
+  // load lanes
+  __m256i a[25], b[25];
+  for (size_t i = 0; i < 25; i++) {
+    a[i] = _mm256_loadu_si256((void*) (s + 4 * i));
+  }
+
+  for (size_t i = 0; i < num_rounds; i++) {
+    // theta
+    {
+      __m256i c[5], d[5];
+      for (size_t x = 0; x < 5; x++) {
+        c[x] = _mm256_xor_si256(
+          _mm256_xor_si256(a[x], a[x + 5]),
+          _mm256_xor_si256(_mm256_xor_si256(a[x + 10], a[x + 15]), a[x + 20])
+        );
+      }
+
+      for (size_t x = 0; x < 5; x++) {
+        d[x] = _mm256_xor_si256(c[(x + 4) % 5], ROL4(c[(x + 1) % 5], 1));
+      }
+
+      for (size_t j = 0; j < 25; j++) {
+        a[j] = _mm256_xor_si256(a[j], d[j % 5]);
+      }
+    }
+
+    // rho and pi
+    {
+      b[0] = a[0];
+      b[1] = ROL4(a[6], 44);
+      b[2] = ROL4(a[12], 43);
+      b[3] = ROL4(a[18], 21);
+      b[4] = ROL4(a[24], 14);
+      b[5] = ROL4(a[3], 28);
+      b[6] = ROL4(a[9], 20);
+      b[7] = ROL4(a[10], 3);
+      b[8] = ROL4(a[16], 45);
+      b[9] = ROL4(a[22], 61);
+      b[10] = ROL4(a[1], 1);
+      b[11] = ROL4(a[7], 6);
+      b[12] = ROL4(a[13], 25);
+      b[13] = ROL4(a[19], 8);
+      b[14] = ROL4(a[20], 18);
+      b[15] = ROL4(a[4], 27);
+      b[16] = ROL4(a[5], 36);
+      b[17] = ROL4(a[11], 10);
+      b[18] = ROL4(a[17], 15);
+      b[19] = ROL4(a[23], 56);
+      b[20] = ROL4(a[2], 62);
+      b[21] = ROL4(a[8], 55);
+      b[22] = ROL4(a[14], 39);
+      b[23] = ROL4(a[15], 41);
+      b[24] = ROL4(a[21], 2);
+    }
+
+    // chi
+    for (size_t y = 0; y < 25; y += 5) {
+      for (size_t x = 0; x < 5; x++) {
+        a[y + x] = _mm256_xor_si256(b[y + x], _mm256_andnot_si256(b[y + (x + 1) % 5], b[y + (x + 2) % 5]));
+      }
+    }
+
+    // iota
+    a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(RCS[24 - num_rounds + i]));
+  }
+
+  // store lanes
+  for (size_t i = 0; i < 25; i++) {
+    _mm256_storeu_si256((void*) (s + 4 * i), a[i]);
+  }
+}
+#endif /* SHA3_AVX2 */
+
+// 4-way keccak permutation (scalar implementation).
+//
+// de-interleaves each of the four states, permutes it with `permute()`,
+// and then interleaves it again.  the state layout matches the avx2
+// implementation above: lane `i` of state `j` is `s[4 * i + j]`.
+static inline void permute_x4_scalar(uint64_t s[static 100], const size_t num_rounds) {
+  for (size_t j = 0; j < 4; j++) {
+    uint64_t a[25] = { 0 };
+    for (size_t i = 0; i < 25; i++) {
+      a[i] = s[4 * i + j];
+    }
+
+    permute(a, num_rounds);
+
+    for (size_t i = 0; i < 25; i++) {
+      s[4 * i + j] = a[i];
+    }
+  }
+}
+
+// 4-way keccak permutation (dispatches to the avx2 or scalar
+// implementation, depending on the backend).
+static void permute_x4(uint64_t s[static 100], const size_t num_rounds) {
+#ifdef SHA3_AVX2
+  if (backend >= SHA3_BACKEND_AVX2) {
+    permute_x4_avx2(s, num_rounds);
+    return;
+  }
+#endif /* SHA3_AVX2 */
+
+  permute_x4_scalar(s, num_rounds);
+}
+
+#ifdef SHA3_AVX512
+// rotate each 64-bit element of 512-bit vector `v` left by `n` bits
+#define ROL8(v, n) _mm512_rol_epi64((v), (n))
+
+// 8-way keccak permutation (avx-512 implementation).
+//
+// permutes eight independent states at once.  unlike `permute()`
+// above, which packs the rows of a single state into registers, this
+// implementation is lane-sliced: the states are interleaved so that
+// lane `i` of state `j` is `s[8 * i + j]`, and each 512-bit register
+// holds the same lane of all eight states.  all 25 lanes stay in
+// registers, so theta, rho, pi, and chi need no permutes.  the rho and
+// pi steps are combined, and chi is a single ternary logic op.
+__attribute__((target("avx512f")))
+static inline void permute_x8_avx512(uint64_t s[static 200], const size_t num_rounds) {
+  // round constants (used in iota)
+  static const uint64_t RCS[] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+  };
+
+  // load lanes
+  __m512i a[25], b[25];
+  for (size_t i = 0; i < 25; i++) {
+    a[i] = _mm512_loadu_si512((void*) (s + 8 * i));
+  }
+
+  for (size_t i = 0; i < num_rounds; i++) {
+    // theta
+    {
+      __m512i c[5], d[5];
+      for (size_t x = 0; x < 5; x++) {
+        // c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20]
+        c[x] = _mm512_ternarylogic_epi64(a[x], a[x + 5], a[x + 10], 0x96);
+        c[x] = _mm512_ternarylogic_epi64(c[x], a[x + 15], a[x + 20], 0x96);
+      }
+
+      for (size_t x = 0; x < 5; x++) {
+        d[x] = _mm512_xor_si512(c[(x + 4) % 5], ROL8(c[(x + 1) % 5], 1));
+      }
+
+      for (size_t j = 0; j < 25; j++) {
+        a[j] = _mm512_xor_si512(a[j], d[j % 5]);
+      }
+    }
+
+    // rho and pi
+    {
+      b[0] = a[0];
+      b[1] = ROL8(a[6], 44);
+      b[2] = ROL8(a[12], 43);
+      b[3] = ROL8(a[18], 21);
+      b[4] = ROL8(a[24], 14);
+      b[5] = ROL8(a[3], 28);
+      b[6] = ROL8(a[9], 20);
+      b[7] = ROL8(a[10], 3);
+      b[8] = ROL8(a[16], 45);
+      b[9] = ROL8(a[22], 61);
+      b[10] = ROL8(a[1], 1);
+      b[11] = ROL8(a[7], 6);
+      b[12] = ROL8(a[13], 25);
+      b[13] = ROL8(a[19], 8);
+      b[14] = ROL8(a[20], 18);
+      b[15] = ROL8(a[4], 27);
+      b[16] = ROL8(a[5], 36);
+      b[17] = ROL8(a[11], 10);
+      b[18] = ROL8(a[17], 15);
+      b[19] = ROL8(a[23], 56);
+      b[20] = ROL8(a[2], 62);
+      b[21] = ROL8(a[8], 55);
+      b[22] = ROL8(a[14], 39);
+      b[23] = ROL8(a[15], 41);
+      b[24] = ROL8(a[21], 2);
+    }
+
+    // chi: a[x] = b[x] ^ (~b[x + 1] & b[x + 2])
+    for (size_t y = 0; y < 25; y += 5) {
+      for (size_t x = 0; x < 5; x++) {
+        a[y + x] = _mm512_ternarylogic_epi64(b[y + x], b[y + (x + 1) % 5], b[y + (x + 2) % 5], 0xd2);
+      }
+    }
+
+    // iota
+    a[0] = _mm512_xor_si512(a[0], _mm512_set1_epi64(RCS[24 - num_rounds + i]));
+  }
+
+  // store lanes
+  for (size_t i = 0; i < 25; i++) {
+    _mm512_storeu_si512((void*) (s + 8 * i), a[i]);
+  }
+}
+#endif /* SHA3_AVX512 */
+
+// 8-way keccak permutation (scalar implementation).
+//
+// de-interleaves each of the eight states, permutes it with
+// `permute()`, and then interleaves it again.  the state layout matches
+// the avx-512 implementation above: lane `i` of state `j` is
+// `s[8 * i + j]`.
+static inline void permute_x8_scalar(uint64_t s[static 200], const size_t num_rounds) {
+  for (size_t j = 0; j < 8; j++) {
+    uint64_t a[25] = { 0 };
+    for (size_t i = 0; i < 25; i++) {
+      a[i] = s[8 * i + j];
+    }
+
+    permute(a, num_rounds);
+
+    for (size_t i = 0; i < 25; i++) {
+      s[8 * i + j] = a[i];
+    }
+  }
+}
+
+// 8-way keccak permutation (dispatches to the avx-512 or scalar
+// implementation, depending on the backend).
+static void permute_x8(uint64_t s[static 200], const size_t num_rounds) {
+#ifdef SHA3_AVX512
+  if (backend >= SHA3_BACKEND_AVX512) {
+    permute_x8_avx512(s, num_rounds);
+    return;
+  }
+#endif /* SHA3_AVX512 */
+
+  permute_x8_scalar(s, num_rounds);
+}
 
 // one-shot keccak.
 static inline size_t keccak(sha3_state_t * const a, const uint8_t *m, size_t m_len, const size_t rate) {
@@ -889,22 +1231,55 @@ static inline void xof_init(sha3_xof_t * const xof) {
   memset(xof, 0, sizeof(sha3_xof_t));
 }
 
-static inline _Bool xof_absorb(sha3_xof_t * const xof, const size_t rate, const size_t num_rounds, const uint8_t * const m, size_t m_len) {
+// absorb data into xof context.
+//
+// unaligned head bytes are absorbed one byte at a time until the state
+// offset is lane-aligned, then data is absorbed as 64-bit lanes in
+// rate-sized (or smaller) chunks, and the remaining tail bytes are
+// absorbed one byte at a time.
+//
+// note: all rates used in this file are multiples of 8 bytes.
+static inline _Bool xof_absorb(sha3_xof_t * const xof, const size_t rate, const size_t num_rounds, const uint8_t *m, size_t m_len) {
   // check state
   if (xof->squeezing) {
     return false;
   }
 
-  // absorb bytes
-  // (TODO: absorb larger chunks)
-  for (size_t i = 0; i < m_len; i++) {
-    xof->a.u8[xof->num_bytes++] ^= m[i];
+  // absorb head bytes until state offset is lane-aligned
+  for (; m_len && (xof->num_bytes & 7); m++, m_len--) {
+    xof->a.u8[xof->num_bytes++] ^= *m;
     if (xof->num_bytes == rate) {
       permute(xof->a.u64, num_rounds);
       xof->num_bytes = 0;
     }
   }
 
+  // absorb 64-bit lanes
+  while (m_len >= 8) {
+    const size_t num_lanes = MIN(m_len, rate - xof->num_bytes) / 8;
+    uint64_t * const lanes = xof->a.u64 + xof->num_bytes / 8;
+    for (size_t i = 0; i < num_lanes; i++) {
+      uint64_t lane;
+      memcpy(&lane, m + 8 * i, sizeof(lane));
+      lanes[i] ^= lane;
+    }
+
+    m += 8 * num_lanes;
+    m_len -= 8 * num_lanes;
+    xof->num_bytes += 8 * num_lanes;
+    if (xof->num_bytes == rate) {
+      permute(xof->a.u64, num_rounds);
+      xof->num_bytes = 0;
+    }
+  }
+
+  // absorb tail bytes
+  // (note: cannot fill block because state offset is lane-aligned and
+  // m_len < 8)
+  for (size_t i = 0; i < m_len; i++) {
+    xof->a.u8[xof->num_bytes++] ^= m[i];
+  }
+
   // return success
   return true;
 }
@@ -930,8 +1305,13 @@ static inline void xof_squeeze(sha3_xof_t * const xof, const size_t rate, const
     xof_absorb_done(xof, rate, num_rounds, pad);
   }
 
-  for (size_t i = 0; i < dst_len; i++) {
-    dst[i] = xof->a.u8[xof->num_bytes++];
+  // copy available bytes from state in rate-sized (or smaller) chunks
+  for (size_t ofs = 0; ofs < dst_len;) {
+    const size_t len = MIN(dst_len - ofs, rate - xof->num_bytes);
+    memcpy(dst + ofs, xof->a.u8 + xof->num_bytes, len);
+    ofs += len;
+    xof->num_bytes += len;
+
     if (xof->num_bytes == rate) {
       permute(xof->a.u64, num_rounds);
       xof->num_bytes = 0;
@@ -989,6 +1369,182 @@ void shake256_xof_once(const uint8_t * const src, const size_t src_len, uint8_t
   xof_once(SHAKE256_XOF_RATE, SHA3_NUM_ROUNDS, SHAKE256_XOF_PAD, src, src_len, dst, dst_len);
 }
 
+// Multi-buffer xof state.  Shared by the 4-way and 8-way xof
+// contexts.  The `ways` states are interleaved so that lane `i` of state
+// `j` is `a[ways * i + j]`, and are permuted together by `permute_xn`.
+typedef struct {
+  uint64_t * const a; // interleaved states
+  size_t * const num_bytes; // number of bytes absorbed/squeezed
+  _Bool * const squeezing; // mode (absorbing or squeezing)
+  const size_t ways; // number of states
+  void (*permute_xn)(uint64_t *, size_t); // multi-buffer permutation
+} xof_xn_t;
+
+// absorb byte `i` of each message in `ms` into multi-buffer xof, and
+// permute if the block is full.
+static inline void xof_xn_absorb_byte(const xof_xn_t xof, const size_t rate, const size_t num_rounds, const uint8_t * const ms[], const size_t i) {
+  uint64_t * const lanes = xof.a + xof.ways * (*xof.num_bytes / 8);
+  const size_t shift = 8 * (*xof.num_bytes % 8);
+  for (size_t j = 0; j < xof.ways; j++) {
+    lanes[j] ^= ((uint64_t) ms[j][i]) << shift;
+  }
+
+  if (++(*xof.num_bytes) == rate) {
+    xof.permute_xn(xof.a, num_rounds);
+    *xof.num_bytes = 0;
+  }
+}
+
+// absorb messages of length `m_len` into multi-buffer xof (one message
+// per state).  uses the same head, lane, and tail strategy as
+// xof_absorb().
+static inline _Bool xof_xn_absorb(const xof_xn_t xof, const size_t rate, const size_t num_rounds, const uint8_t * const ms[], const size_t m_len) {
+  // check state
+  if (*xof.squeezing) {
+    return false;
+  }
+
+  // absorb head bytes until state offset is lane-aligned
+  size_t ofs = 0;
+  for (; ofs < m_len && (*xof.num_bytes & 7); ofs++) {
+    xof_xn_absorb_byte(xof, rate, num_rounds, ms, ofs);
+  }
+
+  // absorb 64-bit lanes
+  for (; m_len - ofs >= 8; ofs += 8) {
+    uint64_t * const lanes = xof.a + xof.ways * (*xof.num_bytes / 8);
+    for (size_t j = 0; j < xof.ways; j++) {
+      uint64_t lane;
+      memcpy(&lane, ms[j] + ofs, sizeof(lane));
+      lanes[j] ^= lane;
+    }
+
+    *xof.num_bytes += 8;
+    if (*xof.num_bytes == rate) {
+      xof.permute_xn(xof.a, num_rounds);
+      *xof.num_bytes = 0;
+    }
+  }
+
+  // absorb tail bytes
+  for (; ofs < m_len; ofs++) {
+    xof_xn_absorb_byte(xof, rate, num_rounds, ms, ofs);
+  }
+
+  // return success
+  return true;
+}
+
+// finalize absorb and switch multi-buffer xof to squeeze mode.
+static inline void xof_xn_absorb_done(const xof_xn_t xof, const size_t rate, const size_t num_rounds, const uint8_t pad) {
+  // append suffix (s6.2) and padding to each state
+  // (note: suffix and padding are ambiguous in spec)
+  uint64_t * const pad_lanes = xof.a + xof.ways * (*xof.num_bytes / 8),
+           * const end_lanes = xof.a + xof.ways * ((rate - 1) / 8);
+  for (size_t j = 0; j < xof.ways; j++) {
+    pad_lanes[j] ^= ((uint64_t) pad) << (8 * (*xof.num_bytes % 8));
+    end_lanes[j] ^= 0x80ULL << (8 * ((rate - 1) % 8));
+  }
+
+  // permute
+  xof.permute_xn(xof.a, num_rounds);
+
+  // switch to squeeze mode
+  *xof.num_bytes = 0;
+  *xof.squeezing = true;
+}
+
+// squeeze `dst_len` bytes from each state of multi-buffer xof into the
+// destination buffers in `dsts`.
+static inline void xof_xn_squeeze(const xof_xn_t xof, const size_t rate, const size_t num_rounds, const uint8_t pad, uint8_t * const dsts[], const size_t dst_len) {
+  // check state
+  if (!*xof.squeezing) {
+    // finalize absorb
+    xof_xn_absorb_done(xof, rate, num_rounds, pad);
+  }
+
+  for (size_t ofs = 0; ofs < dst_len;) {
+    const uint64_t * const lanes = xof.a + xof.ways * (*xof.num_bytes / 8);
+    if (!(*xof.num_bytes & 7) && dst_len - ofs >= 8) {
+      // copy 64-bit lane
+      for (size_t j = 0; j < xof.ways; j++) {
+        memcpy(dsts[j] + ofs, lanes + j, 8);
+      }
+
+      ofs += 8;
+      *xof.num_bytes += 8;
+    } else {
+      // copy byte
+      const size_t shift = 8 * (*xof.num_bytes % 8);
+      for (size_t j = 0; j < xof.ways; j++) {
+        dsts[j][ofs] = (lanes[j] >> shift) & 0xff;
+      }
+
+      ofs++;
+      (*xof.num_bytes)++;
+    }
+
+    if (*xof.num_bytes == rate) {
+      xof.permute_xn(xof.a, num_rounds);
+      *xof.num_bytes = 0;
+    }
+  }
+}
+
+// get multi-buffer view of 4-way xof context
+#define XOF_X4(xof) ((xof_xn_t) { (xof)->a, &((xof)->num_bytes), &((xof)->squeezing), 4, permute_x4 })
+
+// get multi-buffer view of 8-way xof context
+#define XOF_X8(xof) ((xof_xn_t) { (xof)->a, &((xof)->num_bytes), &((xof)->squeezing), 8, permute_x8 })
+
+void shake128x4_xof_init(sha3_xof_x4_t * const xof) {
+  memset(xof, 0, sizeof(sha3_xof_x4_t));
+}
+
+_Bool shake128x4_xof_absorb(sha3_xof_x4_t * const xof, const uint8_t * const msgs[static 4], const size_t len) {
+  return xof_xn_absorb(XOF_X4(xof), SHAKE128_XOF_RATE, SHA3_NUM_ROUNDS, msgs, len);
+}
+
+void shake128x4_xof_squeeze(sha3_xof_x4_t * const xof, uint8_t * const dsts[static 4], const size_t len) {
+  xof_xn_squeeze(XOF_X4(xof), SHAKE128_XOF_RATE, SHA3_NUM_ROUNDS, SHAKE128_XOF_PAD, dsts, len);
+}
+
+void shake256x4_xof_init(sha3_xof_x4_t * const xof) {
+  memset(xof, 0, sizeof(sha3_xof_x4_t));
+}
+
+_Bool shake256x4_xof_absorb(sha3_xof_x4_t * const xof, const uint8_t * const msgs[static 4], const size_t len) {
+  return xof_xn_absorb(XOF_X4(xof), SHAKE256_XOF_RATE, SHA3_NUM_ROUNDS, msgs, len);
+}
+
+void shake256x4_xof_squeeze(sha3_xof_x4_t * const xof, uint8_t * const dsts[static 4], const size_t len) {
+  xof_xn_squeeze(XOF_X4(xof), SHAKE256_XOF_RATE, SHA3_NUM_ROUNDS, SHAKE256_XOF_PAD, dsts, len);
+}
+
+void shake128x8_xof_init(sha3_xof_x8_t * const xof) {
+  memset(xof, 0, sizeof(sha3_xof_x8_t));
+}
+
+_Bool shake128x8_xof_absorb(sha3_xof_x8_t * const xof, const uint8_t * const msgs[static 8], const size_t len) {
+  return xof_xn_absorb(XOF_X8(xof), SHAKE128_XOF_RATE, SHA3_NUM_ROUNDS, msgs, len);
+}
+
+void shake128x8_xof_squeeze(sha3_xof_x8_t * const xof, uint8_t * const dsts[static 8], const size_t len) {
+  xof_xn_squeeze(XOF_X8(xof), SHAKE128_XOF_RATE, SHA3_NUM_ROUNDS, SHAKE128_XOF_PAD, dsts, len);
+}
+
+void shake256x8_xof_init(sha3_xof_x8_t * const xof) {
+  memset(xof, 0, sizeof(sha3_xof_x8_t));
+}
+
+_Bool shake256x8_xof_absorb(sha3_xof_x8_t * const xof, const uint8_t * const msgs[static 8], const size_t len) {
+  return xof_xn_absorb(XOF_X8(xof), SHAKE256_XOF_RATE, SHA3_NUM_ROUNDS, msgs, len);
+}
+
+void shake256x8_xof_squeeze(sha3_xof_x8_t * const xof, uint8_t * const dsts[static 8], const size_t len) {
+  xof_xn_squeeze(XOF_X8(xof), SHAKE256_XOF_RATE, SHA3_NUM_ROUNDS, SHAKE256_XOF_PAD, dsts, len);
+}
+
 // NIST SP 800-105 utility function.
 static inline size_t left_encode(uint8_t buf[static 9], const uint64_t n) {
   if (n > 0x00ffffffffffffffULL) {
@@ -4164,6 +4720,200 @@ static void test_shake256_xof_once(void) {
   }
 }
 
+// squeeze the same output from shake128 and shake256 xof contexts in
+// chunks of every size in the range [1, 300] and compare the result
+// against a single squeeze.  exercises the lane-aligned and unaligned
+// paths in xof_absorb() and xof_squeeze() across block boundaries.
+static void test_xof_squeeze_chunks(void) {
+  static const struct {
+    const char *name; // test name
+    void (*init)(sha3_xof_t *); // init function
+    _Bool (*absorb)(sha3_xof_t *, const uint8_t *, const size_t); // absorb function
+    void (*squeeze)(sha3_xof_t *, uint8_t *, const size_t); // squeeze function
+  } tests[] = {
+    { "shake128", shake128_xof_init, shake128_xof_absorb, shake128_xof_squeeze },
+    { "shake256", shake256_xof_init, shake256_xof_absorb, shake256_xof_squeeze },
+  };
+
+  // build message (3 bytes shorter than 3 shake128 blocks, so absorbs
+  // end unaligned)
+  uint8_t msg[501] = { 0 };
+  for (size_t i = 0; i < sizeof(msg); i++) {
+    msg[i] = i & 0xff;
+  }
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    // get expected output with a single absorb and squeeze
+    uint8_t exp[1000] = { 0 };
+    {
+      sha3_xof_t xof;
+      tests[i].init(&xof);
+      (void) tests[i].absorb(&xof, msg, sizeof(msg));
+      tests[i].squeeze(&xof, exp, sizeof(exp));
+    }
+
+    for (size_t len = 1; len <= 300; len++) {
+      // init xof, absorb message in chunks of `len` bytes
+      sha3_xof_t xof;
+      tests[i].init(&xof);
+      for (size_t ofs = 0; ofs < sizeof(msg); ofs += len) {
+        (void) tests[i].absorb(&xof, msg + ofs, MIN(sizeof(msg) - ofs, len));
+      }
+
+      // squeeze output in chunks of `len` bytes
+      uint8_t got[1000] = { 0 };
+      for (size_t ofs = 0; ofs < sizeof(got); ofs += len) {
+        tests[i].squeeze(&xof, got + ofs, MIN(sizeof(got) - ofs, len));
+      }
+
+      // check
+      if (memcmp(got, exp, sizeof(got))) {
+        fprintf(stderr, "test_xof_squeeze_chunks(\"%s\", %zu) failed, got:\n", tests[i].name, len);
+        dump_hex(stderr, got, sizeof(got));
+
+        fprintf(stderr, "exp:\n");
+        dump_hex(stderr, exp, sizeof(exp));
+      }
+    }
+  }
+}
+
+static void test_xof_x4(void) {
+  static const struct {
+    const char *name; // test name
+    void (*init)(sha3_xof_t *); // init function
+    _Bool (*absorb)(sha3_xof_t *, const uint8_t *, const size_t); // absorb function
+    void (*squeeze)(sha3_xof_t *, uint8_t *, const size_t); // squeeze function
+    void (*x4_init)(sha3_xof_x4_t *); // 4-way init function
+    _Bool (*x4_absorb)(sha3_xof_x4_t *, const uint8_t * const [static 4], const size_t); // 4-way absorb function
+    void (*x4_squeeze)(sha3_xof_x4_t *, uint8_t * const [static 4], const size_t); // 4-way squeeze function
+  } tests[] = {{
+    "shake128",
+    shake128_xof_init, shake128_xof_absorb, shake128_xof_squeeze,
+    shake128x4_xof_init, shake128x4_xof_absorb, shake128x4_xof_squeeze,
+  }, {
+    "shake256",
+    shake256_xof_init, shake256_xof_absorb, shake256_xof_squeeze,
+    shake256x4_xof_init, shake256x4_xof_absorb, shake256x4_xof_squeeze,
+  }};
+
+  // build four different messages
+  uint8_t msgs[4][501] = { 0 };
+  for (size_t j = 0; j < 4; j++) {
+    for (size_t i = 0; i < sizeof(msgs[j]); i++) {
+      msgs[j][i] = (i + 37 * j) & 0xff;
+    }
+  }
+  const uint8_t * const ms[4] = { msgs[0], msgs[1], msgs[2], msgs[3] };
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    // get expected output from four independent xof contexts
+    uint8_t exp[4][600] = { 0 };
+    for (size_t j = 0; j < 4; j++) {
+      sha3_xof_t xof;
+      tests[i].init(&xof);
+      (void) tests[i].absorb(&xof, msgs[j], sizeof(msgs[j]));
+      tests[i].squeeze(&xof, exp[j], sizeof(exp[j]));
+    }
+
+    for (size_t len = 1; len <= 200; len++) {
+      // init 4-way xof, absorb messages in chunks of `len` bytes
+      sha3_xof_x4_t xof;
+      tests[i].x4_init(&xof);
+      for (size_t ofs = 0; ofs < sizeof(msgs[0]); ofs += len) {
+        const uint8_t * const chunks[4] = { ms[0] + ofs, ms[1] + ofs, ms[2] + ofs, ms[3] + ofs };
+        (void) tests[i].x4_absorb(&xof, chunks, MIN(sizeof(msgs[0]) - ofs, len));
+      }
+
+      // squeeze output in chunks of `len` bytes
+      uint8_t got[4][600] = { 0 };
+      for (size_t ofs = 0; ofs < sizeof(got[0]); ofs += len) {
+        uint8_t * const dsts[4] = { got[0] + ofs, got[1] + ofs, got[2] + ofs, got[3] + ofs };
+        tests[i].x4_squeeze(&xof, dsts, MIN(sizeof(got[0]) - ofs, len));
+      }
+
+      // check
+      for (size_t j = 0; j < 4; j++) {
+        if (memcmp(got[j], exp[j], sizeof(got[j]))) {
+          fprintf(stderr, "test_xof_x4(\"%s\", %zu, %zu) failed, got:\n", tests[i].name, len, j);
+          dump_hex(stderr, got[j], sizeof(got[j]));
+
+          fprintf(stderr, "exp:\n");
+          dump_hex(stderr, exp[j], sizeof(exp[j]));
+        }
+      }
+    }
+  }
+}
+
+static void test_xof_x8(void) {
+  static const struct {
+    const char *name; // test name
+    void (*init)(sha3_xof_t *); // init function
+    _Bool (*absorb)(sha3_xof_t *, const uint8_t *, const size_t); // absorb function
+    void (*squeeze)(sha3_xof_t *, uint8_t *, const size_t); // squeeze function
+    void (*x8_init)(sha3_xof_x8_t *); // 8-way init function
+    _Bool (*x8_absorb)(sha3_xof_x8_t *, const uint8_t * const [static 8], const size_t); // 8-way absorb function
+    void (*x8_squeeze)(sha3_xof_x8_t *, uint8_t * const [static 8], const size_t); // 8-way squeeze function
+  } tests[] = {{
+    "shake128",
+    shake128_xof_init, shake128_xof_absorb, shake128_xof_squeeze,
+    shake128x8_xof_init, shake128x8_xof_absorb, shake128x8_xof_squeeze,
+  }, {
+    "shake256",
+    shake256_xof_init, shake256_xof_absorb, shake256_xof_squeeze,
+    shake256x8_xof_init, shake256x8_xof_absorb, shake256x8_xof_squeeze,
+  }};
+
+  // build eight different messages
+  uint8_t msgs[8][501] = { 0 };
+  for (size_t j = 0; j < 8; j++) {
+    for (size_t i = 0; i < sizeof(msgs[j]); i++) {
+      msgs[j][i] = (i + 37 * j) & 0xff;
+    }
+  }
+  const uint8_t * const ms[8] = { msgs[0], msgs[1], msgs[2], msgs[3], msgs[4], msgs[5], msgs[6], msgs[7] };
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    // get expected output from eight independent xof contexts
+    uint8_t exp[8][600] = { 0 };
+    for (size_t j = 0; j < 8; j++) {
+      sha3_xof_t xof;
+      tests[i].init(&xof);
+      (void) tests[i].absorb(&xof, msgs[j], sizeof(msgs[j]));
+      tests[i].squeeze(&xof, exp[j], sizeof(exp[j]));
+    }
+
+    for (size_t len = 1; len <= 200; len++) {
+      // init 8-way xof, absorb messages in chunks of `len` bytes
+      sha3_xof_x8_t xof;
+      tests[i].x8_init(&xof);
+      for (size_t ofs = 0; ofs < sizeof(msgs[0]); ofs += len) {
+        const uint8_t * const chunks[8] = { ms[0] + ofs, ms[1] + ofs, ms[2] + ofs, ms[3] + ofs, ms[4] + ofs, ms[5] + ofs, ms[6] + ofs, ms[7] + ofs };
+        (void) tests[i].x8_absorb(&xof, chunks, MIN(sizeof(msgs[0]) - ofs, len));
+      }
+
+      // squeeze output in chunks of `len` bytes
+      uint8_t got[8][600] = { 0 };
+      for (size_t ofs = 0; ofs < sizeof(got[0]); ofs += len) {
+        uint8_t * const dsts[8] = { got[0] + ofs, got[1] + ofs, got[2] + ofs, got[3] + ofs, got[4] + ofs, got[5] + ofs, got[6] + ofs, got[7] + ofs };
+        tests[i].x8_squeeze(&xof, dsts, MIN(sizeof(got[0]) - ofs, len));
+      }
+
+      // check
+      for (size_t j = 0; j < 8; j++) {
+        if (memcmp(got[j], exp[j], sizeof(got[j]))) {
+          fprintf(stderr, "test_xof_x8(\"%s\", %zu, %zu) failed, got:\n", tests[i].name, len, j);
+          dump_hex(stderr, got[j], sizeof(got[j]));
+
+          fprintf(stderr, "exp:\n");
+          dump_hex(stderr, exp[j], sizeof(exp[j]));
+        }
+      }
+    }
+  }
+}
+
 static void test_left_encode(void) {
   static const struct {
     const char *name;
@@ -6993,7 +7743,39 @@ static void test_k12(void) {
   }
 }
 
-int main(void) {
+static void test_backend(void) {
+  const sha3_backend_t prev = sha3_backend();
+
+  // check that every compiled-in backend up to the best one can be set
+  for (sha3_backend_t b = SHA3_BACKEND_SCALAR; b <= cpu_backend(); b++) {
+    const _Bool exp = backend_compiled(b);
+    if (sha3_backend_set(b) != exp || (exp && sha3_backend() != b)) {
+      fprintf(stderr, "test_backend(%d) failed: got %d\n", (int) b, (int) sha3_backend());
+    }
+  }
+
+  // check that backends which were left out at build time are rejected
+#ifndef SHA3_AVX2
+  if (sha3_backend_set(SHA3_BACKEND_AVX2)) {
+    fprintf(stderr, "test_backend(%d) failed: compiled-out backend set\n", (int) SHA3_BACKEND_AVX2);
+  }
+#endif /* !SHA3_AVX2 */
+#ifndef SHA3_AVX512
+  if (sha3_backend_set(SHA3_BACKEND_AVX512)) {
+    fprintf(stderr, "test_backend(%d) failed: compiled-out backend set\n", (int) SHA3_BACKEND_AVX512);
+  }
+#endif /* !SHA3_AVX512 */
+
+  // check that unsupported backends are rejected
+  if (sha3_backend_set(cpu_backend() + 1)) {
+    fprintf(stderr, "test_backend(%d) failed: unsupported backend set\n", (int) cpu_backend() + 1);
+  }
+
+  sha3_backend_set(prev);
+}
+
+// run every test with the current backend
+static void run_tests(void) {
   test_theta();
   test_rho();
   test_pi();
@@ -7014,6 +7796,9 @@ int main(void) {
   test_shake128_xof_once();
   test_shake256_xof();
   test_shake256_xof_once();
+  test_xof_squeeze_chunks();
+  test_xof_x4();
+  test_xof_x8();
   test_left_encode();
   test_right_encode();
   test_encode_string_prefix();
@@ -7044,6 +7829,19 @@ int main(void) {
   test_turboshake256();
   test_k12_length_encode();
   test_k12();
+}
+
+int main(void) {
+  test_backend();
+
+  // run tests once for each backend supported by this cpu (skipping
+  // backends which were left out at build time)
+  for (sha3_backend_t b = SHA3_BACKEND_SCALAR; b <= cpu_backend(); b++) {
+    if (sha3_backend_set(b)) {
+      run_tests();
+    }
+  }
+
   printf("ok\n");
 }
 
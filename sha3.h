@@ -16,6 +16,7 @@
  * - SHA3-224, SHA3-256, SHA3-384, and SHA3-512
  * - HMAC-SHA3-224, HMAC-SHA3-256, HMAC-SHA3-384, and HMAC-SHA3-512
  * - SHAKE128, SHAKE128-XOF, SHAKE256, and SHAKE256-XOF
+ * - 4-way and 8-way SHAKE128-XOF and SHAKE256-XOF (multi-buffer)
  * - cSHAKE128, cSHAKE128-XOF, cSHAKE256, and cSHAKE256-XOF
  * - KMAC128, KMAC128-XOF, KMAC256, and KMAC256-XOF
  * - TupleHash128, TupleHash128-XOF, TupleHash256, and TupleHash256-XOF
@@ -96,6 +97,40 @@ typedef struct {
   _Bool squeezing; /**< mode (absorbing or squeezing) */
 } sha3_xof_t;
 
+/**
+ * @brief Iterative 4-way [XOF][] context (all members are private).
+ * @ingroup shake
+ *
+ * Four independent [XOF][] states which are absorbed and squeezed in
+ * lockstep.  The lanes of the four states are interleaved so the
+ * permutation can process all four states at once.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+typedef struct {
+  uint64_t a[4 * 25]; /**< interleaved internal states */
+  size_t num_bytes; /**< number of bytes absorbed */
+  _Bool squeezing; /**< mode (absorbing or squeezing) */
+} sha3_xof_x4_t;
+
+/**
+ * @brief Iterative 8-way [XOF][] context (all members are private).
+ * @ingroup shake
+ *
+ * Eight independent [XOF][] states which are absorbed and squeezed in
+ * lockstep.  The lanes of the eight states are interleaved so the
+ * permutation can process all eight states at once.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+typedef struct {
+  uint64_t a[8 * 25]; /**< interleaved internal states */
+  size_t num_bytes; /**< number of bytes absorbed */
+  _Bool squeezing; /**< mode (absorbing or squeezing) */
+} sha3_xof_x8_t;
+
 /*!
  * @brief Calculate SHA3-224 hash of input data.
  * @ingroup sha3
@@ -903,6 +938,210 @@ void shake256_xof_squeeze(sha3_xof_t *xof, uint8_t *dst, const size_t len);
  */
 void shake256_xof_once(const uint8_t *src, const size_t src_len, uint8_t *dst, const size_t dst_len);
 
+/**
+ * @brief Initialize 4-way SHAKE128 [XOF][] context.
+ * @ingroup shake
+ *
+ * @param[out] xof 4-way SHAKE128 [XOF][] context.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake128x4_xof_init(sha3_xof_x4_t *xof);
+
+/**
+ * @brief Absorb data into 4-way SHAKE128 [XOF][] context.
+ * @ingroup shake
+ *
+ * Absorb four input messages, each of length `len` bytes, into 4-way
+ * SHAKE128 [XOF][] context `xof`.  Message `msgs[i]` is absorbed into
+ * state `i`.  Can be called iteratively to absorb input data in chunks.
+ *
+ * @param[in,out] xof 4-way SHAKE128 [XOF][] context.
+ * @param[in] msgs Input messages.
+ * @param[in] len Length of each input message, in bytes.
+ *
+ * @return True if data was absorbed, and false otherwise (e.g., if context has already been squeezed).
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+_Bool shake128x4_xof_absorb(sha3_xof_x4_t *xof, const uint8_t * const msgs[static 4], const size_t len);
+
+/**
+ * @brief Squeeze bytes from 4-way SHAKE128 [XOF][] context.
+ * @ingroup shake
+ *
+ * Squeeze `len` bytes of output from each state of 4-way SHAKE128
+ * [XOF][] context `xof`.  The output of state `i` is written to
+ * destination buffer `dsts[i]`.  Can be called iteratively to squeeze
+ * output data in chunks.
+ *
+ * Produces the same output as four independent SHAKE128 [XOF][]
+ * contexts, but is faster on CPUs with AVX2.
+ *
+ * @param[in,out] xof 4-way SHAKE128 [XOF][] context.
+ * @param[out] dsts Destination buffers.
+ * @param[in] len Length of each destination buffer, in bytes.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake128x4_xof_squeeze(sha3_xof_x4_t *xof, uint8_t * const dsts[static 4], const size_t len);
+
+/**
+ * @brief Initialize 4-way SHAKE256 [XOF][] context.
+ * @ingroup shake
+ *
+ * @param[out] xof 4-way SHAKE256 [XOF][] context.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake256x4_xof_init(sha3_xof_x4_t *xof);
+
+/**
+ * @brief Absorb data into 4-way SHAKE256 [XOF][] context.
+ * @ingroup shake
+ *
+ * Absorb four input messages, each of length `len` bytes, into 4-way
+ * SHAKE256 [XOF][] context `xof`.  Message `msgs[i]` is absorbed into
+ * state `i`.  Can be called iteratively to absorb input data in chunks.
+ *
+ * @param[in,out] xof 4-way SHAKE256 [XOF][] context.
+ * @param[in] msgs Input messages.
+ * @param[in] len Length of each input message, in bytes.
+ *
+ * @return True if data was absorbed, and false otherwise (e.g., if context has already been squeezed).
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+_Bool shake256x4_xof_absorb(sha3_xof_x4_t *xof, const uint8_t * const msgs[static 4], const size_t len);
+
+/**
+ * @brief Squeeze bytes from 4-way SHAKE256 [XOF][] context.
+ * @ingroup shake
+ *
+ * Squeeze `len` bytes of output from each state of 4-way SHAKE256
+ * [XOF][] context `xof`.  The output of state `i` is written to
+ * destination buffer `dsts[i]`.  Can be called iteratively to squeeze
+ * output data in chunks.
+ *
+ * Produces the same output as four independent SHAKE256 [XOF][]
+ * contexts, but is faster on CPUs with AVX2.
+ *
+ * @param[in,out] xof 4-way SHAKE256 [XOF][] context.
+ * @param[out] dsts Destination buffers.
+ * @param[in] len Length of each destination buffer, in bytes.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake256x4_xof_squeeze(sha3_xof_x4_t *xof, uint8_t * const dsts[static 4], const size_t len);
+
+/**
+ * @brief Initialize 8-way SHAKE128 [XOF][] context.
+ * @ingroup shake
+ *
+ * @param[out] xof 8-way SHAKE128 [XOF][] context.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake128x8_xof_init(sha3_xof_x8_t *xof);
+
+/**
+ * @brief Absorb data into 8-way SHAKE128 [XOF][] context.
+ * @ingroup shake
+ *
+ * Absorb eight input messages, each of length `len` bytes, into 8-way
+ * SHAKE128 [XOF][] context `xof`.  Message `msgs[i]` is absorbed into
+ * state `i`.  Can be called iteratively to absorb input data in chunks.
+ *
+ * @param[in,out] xof 8-way SHAKE128 [XOF][] context.
+ * @param[in] msgs Input messages.
+ * @param[in] len Length of each input message, in bytes.
+ *
+ * @return True if data was absorbed, and false otherwise (e.g., if context has already been squeezed).
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+_Bool shake128x8_xof_absorb(sha3_xof_x8_t *xof, const uint8_t * const msgs[static 8], const size_t len);
+
+/**
+ * @brief Squeeze bytes from 8-way SHAKE128 [XOF][] context.
+ * @ingroup shake
+ *
+ * Squeeze `len` bytes of output from each state of 8-way SHAKE128
+ * [XOF][] context `xof`.  The output of state `i` is written to
+ * destination buffer `dsts[i]`.  Can be called iteratively to squeeze
+ * output data in chunks.
+ *
+ * Produces the same output as eight independent SHAKE128 [XOF][]
+ * contexts, but is faster on CPUs with AVX-512.
+ *
+ * @param[in,out] xof 8-way SHAKE128 [XOF][] context.
+ * @param[out] dsts Destination buffers.
+ * @param[in] len Length of each destination buffer, in bytes.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake128x8_xof_squeeze(sha3_xof_x8_t *xof, uint8_t * const dsts[static 8], const size_t len);
+
+/**
+ * @brief Initialize 8-way SHAKE256 [XOF][] context.
+ * @ingroup shake
+ *
+ * @param[out] xof 8-way SHAKE256 [XOF][] context.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake256x8_xof_init(sha3_xof_x8_t *xof);
+
+/**
+ * @brief Absorb data into 8-way SHAKE256 [XOF][] context.
+ * @ingroup shake
+ *
+ * Absorb eight input messages, each of length `len` bytes, into 8-way
+ * SHAKE256 [XOF][] context `xof`.  Message `msgs[i]` is absorbed into
+ * state `i`.  Can be called iteratively to absorb input data in chunks.
+ *
+ * @param[in,out] xof 8-way SHAKE256 [XOF][] context.
+ * @param[in] msgs Input messages.
+ * @param[in] len Length of each input message, in bytes.
+ *
+ * @return True if data was absorbed, and false otherwise (e.g., if context has already been squeezed).
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+_Bool shake256x8_xof_absorb(sha3_xof_x8_t *xof, const uint8_t * const msgs[static 8], const size_t len);
+
+/**
+ * @brief Squeeze bytes from 8-way SHAKE256 [XOF][] context.
+ * @ingroup shake
+ *
+ * Squeeze `len` bytes of output from each state of 8-way SHAKE256
+ * [XOF][] context `xof`.  The output of state `i` is written to
+ * destination buffer `dsts[i]`.  Can be called iteratively to squeeze
+ * output data in chunks.
+ *
+ * Produces the same output as eight independent SHAKE256 [XOF][]
+ * contexts, but is faster on CPUs with AVX-512.
+ *
+ * @param[in,out] xof 8-way SHAKE256 [XOF][] context.
+ * @param[out] dsts Destination buffers.
+ * @param[in] len Length of each destination buffer, in bytes.
+ *
+ * [xof]: https://en.wikipedia.org/wiki/Extendable-output_function
+ *   "Extendable-Output Function (XOF)"
+ */
+void shake256x8_xof_squeeze(sha3_xof_x8_t *xof, uint8_t * const dsts[static 8], const size_t len);
+
 /**
  * @defgroup cshake cSHAKE
  *
@@ -2413,6 +2652,58 @@ void k12_init(k12_t *k12, const uint8_t *src, const size_t src_len, const uint8_
  */
 void k12_squeeze(k12_t *k12, uint8_t *dst, const size_t len);
 
+/**
+ * @defgroup backend Backends
+ * @brief Instruction set extensions used by the Keccak permutations.
+ *
+ * On x86-64 with [GCC][] or [Clang][], the AVX2 and AVX-512
+ * permutations are compiled in and the best backend supported by the
+ * CPU is selected once at startup, so one binary runs on any x86-64
+ * CPU.  Define `SHA3_NO_AVX2` or `SHA3_NO_AVX512` to leave out the
+ * corresponding permutations.
+ *
+ * [GCC]: https://gcc.gnu.org/ "GNU Compiler Collection"
+ * [Clang]: https://clang.llvm.org/ "Clang"
+ */
+
+/**
+ * @brief Keccak permutation backend.
+ * @ingroup backend
+ *
+ * Backends are ordered: each one supported by a CPU implies that the
+ * ones before it are supported too.
+ */
+typedef enum {
+  SHA3_BACKEND_SCALAR, /**< Reference C. */
+  SHA3_BACKEND_AVX2, /**< AVX2 4-way permutation. */
+  SHA3_BACKEND_AVX512, /**< AVX-512 permutation and 8-way permutation. */
+} sha3_backend_t;
+
+/**
+ * @brief Get current Keccak permutation backend.
+ * @ingroup backend
+ *
+ * @return Current backend.
+ */
+sha3_backend_t sha3_backend(void);
+
+/**
+ * @brief Set Keccak permutation backend.
+ * @ingroup backend
+ *
+ * Use `backend` for all subsequent hash, XOF, and MAC operations.  Fails
+ * if `backend` was left out at build time or is not supported by this
+ * CPU.
+ *
+ * @note Not thread-safe: call before using the other functions of this
+ * library from other threads.
+ *
+ * @param[in] backend Backend.
+ *
+ * @return True if the backend was set, false if it is not supported.
+ */
+_Bool sha3_backend_set(const sha3_backend_t backend);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */